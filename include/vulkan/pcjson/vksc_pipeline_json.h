@@ -206,6 +206,8 @@ bool vpjFilterDeviceFeatures(VpjGenerator generator, const void* pDeviceCreateIn
  * @brief Frees any storage of previous pipeline JSON generator outputs.
  *
  * @param generator The JSON generator to free output storage for
+ *
+ * The memory is kept by the generator for the outputs of subsequent calls, and only released when the generator is destroyed.
  */
 void vpjFreeGeneratorOutputs(VpjGenerator generator);
 
@@ -238,6 +240,23 @@ VpjParser vpjCreateParser();
  */
 void vpjSetAcceptLegacyInvalidInputData(VpjParser parser, bool enable);
 
+/**
+ * @brief Controls whether the parser will parse the input JSON in a single streaming pass.
+ *
+ * @param parser The JSON parser object
+ * @param enable If true, the input JSON is parsed directly into the output structures, otherwise it is first parsed into a
+ * JSON document that the output structures are then parsed from (by default it is disabled).
+ *
+ * Streaming parsing accepts the same inputs and produces the same outputs, but avoids building the intermediate JSON
+ * document, which makes parsing considerably faster and reduces its memory use. Members may come in any order, those that
+ * refer to objects named later in the JSON are parsed once the names are known. The messages reported for invalid input
+ * may differ in wording and order.
+ *
+ * NOTE: The configuration set by this command applies to the behavior of vpjParsePipelineJson, vpjParsePipelineJsonWithSize,
+ * vpjParsePipelineJsonBatch and vpjParseSingleStructJson.
+ */
+void vpjSetStreamingParsing(VpjParser parser, bool enable);
+
 /**
  * @brief Parses a pipeline JSON from the input JSON string.
  *
@@ -257,6 +276,63 @@ void vpjSetAcceptLegacyInvalidInputData(VpjParser parser, bool enable);
  */
 bool vpjParsePipelineJson(VpjParser parser, const char* pPipelineJson, VpjData* pPipelineData, const char** ppMessages);
 
+/**
+ * @brief Parses a pipeline JSON from an input JSON string of the specified size.
+ *
+ * @param parser The JSON parser object
+ * @param pPipelineJson The input JSON string (does not need to be null-terminated)
+ * @param pipelineJsonSize The size of the input JSON string in bytes
+ * @param pPipelineData Pointer to the pointer output pipeline data (the backing storage of nested data remains valid until
+ * vpjFreeParserOutputs or vpjDestroyParser is called)
+ * @param ppMessages Optional pointer to the output messages (the backing storage remains valid until vpjFreeParserOutputs,
+ * vpjDestroyParser, or another vpjParse* command is called)
+ * @return True, if the parsing was successful, false otherwise.
+ *
+ * Same as vpjParsePipelineJson, but does not need to determine the length of the input first, and can therefore parse
+ * pipeline JSONs in place, e.g. directly from a pipeline cache.
+ *
+ * NOTE: The parser reuses its internal state across calls, so when parsing many pipeline JSONs, using the same parser for
+ * all of them (and calling vpjFreeParserOutputs once the outputs of the previous ones are no longer needed) is considerably
+ * faster than creating a parser for each.
+ */
+bool vpjParsePipelineJsonWithSize(VpjParser parser, const char* pPipelineJson, size_t pipelineJsonSize, VpjData* pPipelineData,
+                                  const char** ppMessages);
+
+/**
+ * @brief Sets the number of threads used by vpjParsePipelineJsonBatch.
+ *
+ * @param parser The JSON parser object
+ * @param threadCount The maximum number of threads to parse with, including the calling thread, or 0 to use one thread per
+ * hardware thread (by default it is 0).
+ */
+void vpjSetParserThreadCount(VpjParser parser, uint32_t threadCount);
+
+/**
+ * @brief Parses multiple pipeline JSONs in parallel.
+ *
+ * @param parser The JSON parser object
+ * @param pipelineJsonCount The number of pipeline JSONs to parse
+ * @param ppPipelineJsons Pointer to an array of pipelineJsonCount input JSON strings
+ * @param pPipelineJsonSizes Optional pointer to an array of pipelineJsonCount input JSON string sizes in bytes (if not NULL,
+ * the input JSON strings do not need to be null-terminated)
+ * @param pPipelineData Pointer to an array of pipelineJsonCount output pipeline data (the backing storage of nested data
+ * remains valid until vpjFreeParserOutputs or vpjDestroyParser is called)
+ * @param pResults Optional pointer to an array of pipelineJsonCount results, each is true if the parsing of the corresponding
+ * pipeline JSON was successful, false otherwise
+ * @param ppMessages Optional pointer to an array of pipelineJsonCount output messages, NULL where there are none (the
+ * backing storage remains valid until vpjFreeParserOutputs or vpjDestroyParser is called)
+ * @return True, if the parsing of all pipeline JSONs was successful, false otherwise.
+ *
+ * Each pipeline JSON is parsed the same way as by vpjParsePipelineJsonWithSize, with the configuration of the parser, but the
+ * pipeline JSONs are distributed across the number of threads set by vpjSetParserThreadCount. Each thread parses with its
+ * own internal parser state and output storage, which are kept by the parser for subsequent calls.
+ *
+ * NOTE: The parser itself must not be used concurrently from multiple threads, this command is the way to parse pipeline
+ * JSONs in parallel with a single parser.
+ */
+bool vpjParsePipelineJsonBatch(VpjParser parser, uint32_t pipelineJsonCount, const char* const* ppPipelineJsons,
+                               const size_t* pPipelineJsonSizes, VpjData* pPipelineData, bool* pResults, const char** ppMessages);
+
 /**
  * @brief Parses a single structure (including its pNext chain) from the input JSON string.
  *
@@ -291,6 +367,8 @@ bool vpjParseSingleStructJson(VpjParser parser, const char* pJson, void* pStruct
  * @brief Frees any storage of previous pipeline JSON parser outputs.
  *
  * @param parser The JSON parser to free output storage for
+ *
+ * The memory is kept by the parser for the outputs of subsequent calls, and only released when the parser is destroyed.
  */
 void vpjFreeParserOutputs(VpjParser parser);
 
@@ -0,0 +1,219 @@
+/*
+ * Copyright (c) 2025 The Khronos Group Inc.
+ * Copyright (c) 2025 RasterGrid Kft.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef PCCHECKSUM_HPP
+#define PCCHECKSUM_HPP 1
+
+#include <cstddef>
+#include <cstdint>
+
+#ifndef VKSC_MEMCPY
+#include <cstring>
+#define VKSC_MEMCPY memcpy
+#endif  // VKSC_MEMCPY
+
+// define VKSC_CRC32C_SOFTWARE to always use the portable table-driven implementation
+#if !defined(VKSC_CRC32C_SOFTWARE) && defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define VKSC_CRC32C_X86 1
+#include <nmmintrin.h>
+#elif !defined(VKSC_CRC32C_SOFTWARE) && defined(__aarch64__) && defined(__ARM_FEATURE_CRC32)
+#define VKSC_CRC32C_ARM 1
+#include <arm_acle.h>
+#endif
+
+#include <vulkan/vulkan_sc.h>
+
+// VKSCCrc32c
+//
+// CRC-32C (Castagnoli) checksum, as used by iSCSI, ext4 and SSE4.2.
+//
+// Uses the CRC32 instructions where available: on x86-64 they are detected at run time (GCC and Clang),
+// on AArch64 they are used if the compiler targets them (e.g. -march=armv8-a+crc). Large buffers are split
+// into three interleaved streams to hide the latency of the instruction, which runs at several bytes per
+// cycle, i.e. at about the speed the data can be read from memory. Elsewhere a slicing-by-8 table
+// implementation is used.
+//
+// update - continue a checksum, update(update(0, a), b) is the checksum of a followed by b
+//
+class VKSCCrc32c {
+  public:
+    // return: the checksum of the data the checksum <crc> was computed over, followed by the <size> bytes at <data>
+    // (<crc> is zero for the start of the data)
+    static uint32_t update(uint32_t crc, void const* data, uint64_t size) {
+        uint8_t const* bytes = static_cast<uint8_t const*>(data);
+#if defined(VKSC_CRC32C_X86)
+        static bool const hasHardware = __builtin_cpu_supports("sse4.2");
+        if (hasHardware) {
+            return ~updateHardware(~crc, bytes, size);
+        }
+#elif defined(VKSC_CRC32C_ARM)
+        return ~updateHardware(~crc, bytes, size);
+#endif
+        return ~updateSoftware(~crc, bytes, size);
+    }
+
+  private:
+    static constexpr uint32_t kPolynomial = 0x82F63B78U;  // reflected Castagnoli polynomial
+    static constexpr uint64_t kStreamSize = 4096U;        // size of each of the three interleaved streams
+
+    // slicing-by-8 lookup tables
+    struct Tables {
+        uint32_t table[8][256];
+
+        Tables() {
+            for (uint32_t i = 0U; i < 256U; ++i) {
+                uint32_t crc = i;
+                for (uint32_t bit = 0U; bit < 8U; ++bit) {
+                    crc = (crc & 1U) ? (crc >> 1U) ^ kPolynomial : crc >> 1U;
+                }
+                table[0][i] = crc;
+            }
+            for (uint32_t i = 0U; i < 256U; ++i) {
+                for (uint32_t slice = 1U; slice < 8U; ++slice) {
+                    table[slice][i] = (table[slice - 1U][i] >> 8U) ^ table[0][table[slice - 1U][i] & 0xFFU];
+                }
+            }
+        }
+    };
+
+    // return: the register after processing the <size> bytes at <data> starting from the register <crc>
+    static uint32_t updateSoftware(uint32_t crc, uint8_t const* data, uint64_t size) {
+        static Tables const tables;
+        uint32_t const(&t)[8][256] = tables.table;
+
+        for (; size >= 8U; size -= 8U, data += 8U) {
+            uint32_t low;
+            uint32_t high;
+            VKSC_MEMCPY(&low, data, sizeof(low));
+            VKSC_MEMCPY(&high, data + 4U, sizeof(high));
+            low ^= crc;
+            crc = t[7][low & 0xFFU] ^ t[6][(low >> 8U) & 0xFFU] ^ t[5][(low >> 16U) & 0xFFU] ^ t[4][low >> 24U] ^
+                  t[3][high & 0xFFU] ^ t[2][(high >> 8U) & 0xFFU] ^ t[1][(high >> 16U) & 0xFFU] ^ t[0][high >> 24U];
+        }
+        for (; size > 0U; --size, ++data) {
+            crc = (crc >> 8U) ^ t[0][(crc ^ *data) & 0xFFU];
+        }
+        return crc;
+    }
+
+#if defined(VKSC_CRC32C_X86) || defined(VKSC_CRC32C_ARM)
+    // return: the product of the polynomials <a> and <b> modulo the Castagnoli polynomial, in reflected form
+    static uint32_t multiplyModP(uint32_t a, uint32_t b) {
+        uint32_t product = 0U;
+        for (uint32_t bit = 0x80000000U; bit != 0U; bit >>= 1U) {
+            if (a & bit) {
+                product ^= b;
+            }
+            b = (b & 1U) ? (b >> 1U) ^ kPolynomial : b >> 1U;
+        }
+        return product;
+    }
+
+    // return: x^(8*<size>) modulo the Castagnoli polynomial, in reflected form, so that multiplying a register by it
+    // is equivalent to processing <size> zero bytes
+    static uint32_t shiftConstant(uint64_t size) {
+        uint32_t result = 0x80000000U;  // x^0
+        uint32_t power = 0x00800000U;   // x^8
+        for (; size > 0U; size >>= 1U) {
+            if (size & 1U) {
+                result = multiplyModP(result, power);
+            }
+            power = multiplyModP(power, power);
+        }
+        return result;
+    }
+
+#if defined(VKSC_CRC32C_X86)
+    __attribute__((target("sse4.2"))) static uint32_t step64(uint32_t crc, uint64_t word) {
+        return static_cast<uint32_t>(_mm_crc32_u64(crc, word));
+    }
+    __attribute__((target("sse4.2"))) static uint32_t step8(uint32_t crc, uint8_t byte) { return _mm_crc32_u8(crc, byte); }
+#define VKSC_CRC32C_TARGET __attribute__((target("sse4.2")))
+#else
+    static uint32_t step64(uint32_t crc, uint64_t word) { return __crc32cd(crc, word); }
+    static uint32_t step8(uint32_t crc, uint8_t byte) { return __crc32cb(crc, byte); }
+#define VKSC_CRC32C_TARGET
+#endif
+
+    static uint64_t read64(uint8_t const* data) {
+        uint64_t value;
+        VKSC_MEMCPY(&value, data, sizeof(value));
+        return value;
+    }
+
+    // return: the register after processing the <size> bytes at <data> starting from the register <crc>
+    VKSC_CRC32C_TARGET static uint32_t updateHardware(uint32_t crc, uint8_t const* data, uint64_t size) {
+        // three independent streams over consecutive blocks, combined by shifting the earlier ones past the later ones
+        if (size >= 3U * kStreamSize) {
+            static uint32_t const shift1 = shiftConstant(kStreamSize);
+            static uint32_t const shift2 = shiftConstant(2U * kStreamSize);
+            for (; size >= 3U * kStreamSize; size -= 3U * kStreamSize, data += 3U * kStreamSize) {
+                uint32_t crc1 = 0U;
+                uint32_t crc2 = 0U;
+                for (uint64_t i = 0U; i < kStreamSize; i += 8U) {
+                    crc = step64(crc, read64(data + i));
+                    crc1 = step64(crc1, read64(data + kStreamSize + i));
+                    crc2 = step64(crc2, read64(data + 2U * kStreamSize + i));
+                }
+                crc = multiplyModP(shift2, crc) ^ multiplyModP(shift1, crc1) ^ crc2;
+            }
+        }
+        for (; size >= 8U; size -= 8U, data += 8U) {
+            crc = step64(crc, read64(data));
+        }
+        for (; size > 0U; --size, ++data) {
+            crc = step8(crc, *data);
+        }
+        return crc;
+    }
+#undef VKSC_CRC32C_TARGET
+#endif
+};
+
+// VKSCPipelineChecksums
+//
+// Checksum record of a single pipeline, stored by VKSCPipelineCacheHeaderWriter in the last 16 bytes of each
+// pipeline index entry (see setPipelineChecksums) and checked by VKSCPipelineCacheHeaderReader.
+//
+// The checksums cover the contents of the pipeline rather than its placement in the pipeline cache, so a
+// pipeline carried over to another pipeline cache as is (e.g. by VKSCPipelineCacheEditor) keeps valid checksums.
+// A corrupted offset is still detected, as the data read from the wrong place does not match the checksums.
+// Implementation-specific per-pipeline and per-stage metadata is not covered.
+//
+// All checksums are CRC-32C (see VKSCCrc32c) in native byte order:
+//   - tag: kTag, identifies the record
+//   - pipeline: over the pipelineIdentifier, pipelineMemorySize, jsonSize and stageIndexCount of the pipeline
+//     index entry
+//   - json: over the json payload as stored (i.e. compressed, if it is stored as a compressed frame)
+//   - code: over the codeSize followed by the SPIR-V payload as stored, of each stage in order
+//
+struct VKSCPipelineChecksums {
+    static constexpr uint32_t kTag = 0x53434B56U;  // 'V' 'K' 'C' 'S'
+
+    uint32_t tag{kTag};
+    uint32_t pipeline{0U};
+    uint32_t json{0U};
+    uint32_t code{0U};
+
+    // return: the pipeline checksum of the fields of <entry> that are covered
+    static uint32_t checksumPipeline(VkPipelineCacheSafetyCriticalIndexEntry const& entry) {
+        uint32_t crc = VKSCCrc32c::update(0U, entry.pipelineIdentifier, VK_UUID_SIZE);
+        crc = VKSCCrc32c::update(crc, &entry.pipelineMemorySize, sizeof(entry.pipelineMemorySize));
+        crc = VKSCCrc32c::update(crc, &entry.jsonSize, sizeof(entry.jsonSize));
+        return VKSCCrc32c::update(crc, &entry.stageIndexCount, sizeof(entry.stageIndexCount));
+    }
+
+    // return: the code checksum <crc> continued with the stage of <codeSize> bytes of SPIR-V at <code>
+    static uint32_t checksumStage(uint32_t crc, uint64_t codeSize, uint8_t const* code) {
+        crc = VKSCCrc32c::update(crc, &codeSize, sizeof(codeSize));
+        return VKSCCrc32c::update(crc, code, codeSize);
+    }
+};
+
+static_assert(sizeof(VKSCPipelineChecksums) == 16U, "the checksum record must be 16 bytes");
+
+#endif  // PCCHECKSUM_HPP
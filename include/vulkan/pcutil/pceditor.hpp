@@ -0,0 +1,474 @@
+/*
+ * Copyright (c) 2025 The Khronos Group Inc.
+ * Copyright (c) 2025 RasterGrid Kft.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef PCEDITOR_HPP
+#define PCEDITOR_HPP 1
+
+#include <cstddef>
+#include <cstdint>
+
+#include <vulkan/pcutil/pcreader.hpp>
+#include <vulkan/pcutil/pcwriter.hpp>
+
+// VKSCPipelineCacheEditor
+//
+// Utility class to add, replace and remove pipelines of an existing pipeline cache blob without
+// re-collecting all of its pipeline entries.
+//
+// The existing pipeline cache is accessed through a VKSCPipelineCacheHeaderReader. Pipelines that are
+// not edited are carried over as they are, including any implementation-specific per-pipeline and
+// per-stage metadata stored in the extra space of the index strides, and any checksum record
+// (see VKSCPipelineChecksums). If the first pipeline of the existing pipeline cache has a checksum record,
+// added pipelines are given one as well. The per-pipeline metadata record of an added pipeline (see VKSCEntryMetadata)
+// must fit the pipeline index stride of the existing pipeline cache; the stage indices of added pipelines use the
+// default stride, without per-stage metadata.
+//
+// Usage:
+//   - Instantiate the class with a reader of the existing pipeline cache, on which verify succeeded
+//   - call open to prepare the editor
+//   - call setPipelineEntry for each pipeline to add or replace
+//   - call removePipelineEntry for each pipeline to remove
+//   - call writeAppendedCache (or writeAppendedData and getAppendedHeader) to patch the pipeline cache in place
+//   - alternatively, call writeCompactedCache to emit a new pipeline cache blob without dead data
+//
+// The pipeline cache blob and the added pipeline entries are NOT copied and the application must maintain
+// their lifetime while this object is instantiated.
+//
+// setPipelineEntry - add a pipeline entry, replacing the pipeline with the same identifier if there is one
+//
+// removePipelineEntry - remove the pipeline with the specified identifier
+//
+// getAppendedCacheSize - return the size of the pipeline cache after appending the edits
+//
+// writeAppendedData - stream the data to append to the existing pipeline cache
+//   The new json, stage index and SPIR-V payloads are appended at the end of the existing pipeline cache,
+//   followed by a new pipeline index. The existing contents are never moved, so only the appended data and
+//   the header (see getAppendedHeader) need to be written. The previous pipeline index and the payloads of
+//   replaced or removed pipelines become dead data.
+//
+// writeAppendedCache - patch a memory buffer holding the existing pipeline cache in place
+//
+// getCompactedCacheSize - return the size of the pipeline cache after compaction
+//
+// writeCompactedCache - stream the edited pipeline cache without any dead data
+//   The region reserved for implementation-specific data before the pipeline index is retained,
+//   identical payloads are stored only once.
+//
+
+class VKSCPipelineCacheEditor {
+  public:
+    // initialize the editor for the pipeline cache referenced by <reader>
+    // the reader must outlive this object
+    VKSCPipelineCacheEditor(VKSCPipelineCacheHeaderReader const& reader) : m_Reader(reader), m_Index(reader) {}
+
+    // disable copy and assignment
+    VKSCPipelineCacheEditor(VKSCPipelineCacheEditor const& rhs) = delete;             // copy constructor
+    VKSCPipelineCacheEditor(VKSCPipelineCacheEditor&& rhs) = delete;                  // move constructor
+    VKSCPipelineCacheEditor& operator=(VKSCPipelineCacheEditor const& rhs) = delete;  // copy assignment
+    VKSCPipelineCacheEditor& operator=(VKSCPipelineCacheEditor&& rhs) = delete;       // move assignment
+
+    // destructor - delete any memory this class allocated
+    ~VKSCPipelineCacheEditor() {
+        if (m_Edits) {
+            delete[] m_Edits;
+        }
+        if (m_Added) {
+            delete[] m_Added;
+        }
+    }
+
+    // prepare the editor, indexing the pipelines of the existing pipeline cache
+    // this function can only be called once
+    // return: true on success, false if the reader was not verified
+    bool open() {
+        if (m_Edits || !m_Reader.isVerified() || !m_Index.build()) return false;
+
+        // zero-sized arrays still have to be allocated to mark the editor open
+        m_Edits = new uint32_t[m_Reader.getPipelineIndexCount() + 1U]();
+
+        VKSCPipelineChecksums checksums{};
+        VkPipelineCacheSafetyCriticalIndexEntry const* const first = m_Reader.getPipelineIndexEntry(0U);
+        m_Checksums = first && m_Reader.getPipelineChecksums(*first, checksums);
+        return true;
+    }
+
+    // return: true if open was called successfully
+    bool isOpen() const { return m_Edits != nullptr; }
+
+    // add the pipeline <entry>, replacing the pipeline with the same identifier if there is one
+    // A replaced pipeline keeps its position in the pipeline index, new pipelines are added at its end.
+    // The pipeline entry is NOT copied and the application must maintain the lifetime
+    // of the data that was passed in while this object is instantiated.
+    // return: true on success, false if the editor is not open
+    bool setPipelineEntry(VKSCPipelineEntry const* entry) {
+        if (!isOpen()) return false;
+
+        // replace an earlier added pipeline entry
+        for (uint32_t i = 0U; i < m_AddedCount; ++i) {
+            if (m_Added[i].entry && VKSC_MEMCMP(m_Added[i].entry->getIdentifier(), entry->getIdentifier(), VK_UUID_SIZE) == 0) {
+                m_Added[i].entry = entry;
+                return true;
+            }
+        }
+
+        uint32_t const pipelineIndex = findPipeline(entry->getIdentifier());
+        if (pipelineIndex != kNotFound) {
+            if (m_Edits[pipelineIndex] != kRemoved && m_Edits[pipelineIndex] != kKept) {
+                m_Added[m_Edits[pipelineIndex] - 1U].entry = entry;
+                return true;
+            }
+            m_Edits[pipelineIndex] = addEntry(entry, pipelineIndex) + 1U;
+            return true;
+        }
+
+        addEntry(entry, kNotFound);
+        return true;
+    }
+
+    // remove the pipeline with the given <identifier>
+    // return: true if the pipeline was removed, false if the editor is not open or there is no such pipeline
+    bool removePipelineEntry(uint8_t const identifier[VK_UUID_SIZE]) {
+        if (!isOpen()) return false;
+
+        for (uint32_t i = 0U; i < m_AddedCount; ++i) {
+            if (m_Added[i].entry && VKSC_MEMCMP(m_Added[i].entry->getIdentifier(), identifier, VK_UUID_SIZE) == 0) {
+                m_Added[i].entry = nullptr;
+                if (m_Added[i].pipelineIndex != kNotFound) {
+                    m_Edits[m_Added[i].pipelineIndex] = kRemoved;
+                }
+                return true;
+            }
+        }
+
+        uint32_t const pipelineIndex = findPipeline(identifier);
+        if (pipelineIndex == kNotFound || m_Edits[pipelineIndex] == kRemoved) return false;
+
+        m_Edits[pipelineIndex] = kRemoved;
+        return true;
+    }
+
+    // return: the number of pipelines in the edited pipeline cache
+    uint32_t getPipelineCount() const {
+        uint32_t count = 0U;
+        forEachPipeline([&](VkPipelineCacheSafetyCriticalIndexEntry const*, VKSCPipelineEntry const*) { ++count; });
+        return count;
+    }
+
+    // return: the size in bytes of the pipeline cache after appending the edits with writeAppendedData
+    uint64_t getAppendedCacheSize() const {
+        uint64_t const indexOffset = layoutAppendedData();
+        return indexOffset + uint64_t{getPipelineCount()} * m_Reader.getPipelineIndexStride();
+    }
+
+    // fill <header> with the Safety Critical header of the pipeline cache after appending the edits
+    void getAppendedHeader(VkPipelineCacheHeaderVersionSafetyCriticalOne& header) const {
+        fillHeader(header, layoutAppendedData());
+    }
+
+    // stream the data to append to the existing pipeline cache to <sink>
+    // operation:
+    //  - appends the json, stage index and SPIR-V of all added pipeline entries
+    //  - appends the new pipeline index, referring to the existing data for all pipelines that were not edited
+    // The existing pipeline cache is patched by writing this data at its end, then overwriting its header
+    // with the one returned by getAppendedHeader.
+    // return: true if getAppendedCacheSize minus the size of the existing pipeline cache bytes were
+    // appended to <sink>, false if <sink> failed or the editor is not open
+    bool writeAppendedData(VKSCPipelineCacheSink& sink) const {
+        if (!isOpen()) return false;
+
+        uint64_t const stageStride = sizeof(VkPipelineCacheStageValidationIndexEntry);
+        uint32_t const pipelineStride = m_Reader.getPipelineIndexStride();
+        bool success = true;
+
+        // first pass: the data of the added pipeline entries
+        uint64_t extraOffset = m_Reader.getCacheSize();
+        forEachPipeline([&](VkPipelineCacheSafetyCriticalIndexEntry const*, VKSCPipelineEntry const* entry) {
+            if (entry && success) {
+                success = entry->writePipelineEntryData(sink, extraOffset, stageStride);
+            }
+        });
+
+        // second pass: the pipeline index
+        extraOffset = m_Reader.getCacheSize();
+        forEachPipeline([&](VkPipelineCacheSafetyCriticalIndexEntry const* pie, VKSCPipelineEntry const* entry) {
+            if (!success) return;
+
+            if (entry) {
+                VkPipelineCacheSafetyCriticalIndexEntry newEntry{};
+                extraOffset = entry->layoutPipelineEntry(extraOffset, stageStride, newEntry);
+                success = sink.write(&newEntry, sizeof(newEntry)) && writeMetadata(sink, entry, pipelineStride);
+            } else {
+                success = sink.write(pie, pipelineStride);
+            }
+        });
+
+        return success;
+    }
+
+    // patch the existing pipeline cache in the buffer of <size> bytes at <data> in place
+    // operation:
+    //  - writes the data returned by writeAppendedData after the existing pipeline cache
+    //  - overwrites the header with the one returned by getAppendedHeader
+    // <data> may be the same memory that the reader refers to.
+    // return: true on success, false if the editor is not open or <size> is less than getAppendedCacheSize
+    // precondition: the first bytes at <data> hold the existing pipeline cache
+    bool writeAppendedCache(uint64_t size, uint8_t* data) const {
+        if (!isOpen() || size < getAppendedCacheSize()) return false;
+
+        VKSCPipelineCacheBufferSink sink(size - m_Reader.getCacheSize(), data + m_Reader.getCacheSize());
+        if (!writeAppendedData(sink)) return false;
+
+        VkPipelineCacheHeaderVersionSafetyCriticalOne header{};
+        getAppendedHeader(header);
+        VKSC_MEMCPY(data, &header, sizeof(header));
+        return true;
+    }
+
+    // return: the size in bytes of the pipeline cache written by writeCompactedCache
+    uint64_t getCompactedCacheSize() const {
+        VKSCPipelineCachePayloadTable payloads;
+
+        uint64_t extraOffset = m_Reader.getPipelineIndexOffset() + uint64_t{getPipelineCount()} * m_Reader.getPipelineIndexStride();
+        forEachPipeline([&](VkPipelineCacheSafetyCriticalIndexEntry const* pie, VKSCPipelineEntry const* entry) {
+            VkPipelineCacheSafetyCriticalIndexEntry newEntry{};
+            extraOffset = layoutPipeline(pie, entry, extraOffset, newEntry, payloads);
+        });
+
+        return extraOffset;
+    }
+
+    // stream the whole edited pipeline cache blob, without any dead data, to <sink>
+    // operation:
+    //  - appends the header, followed by the region reserved for implementation-specific data before the pipeline index
+    //  - appends the pipeline index, then the json, stage index and code of each pipeline in pipeline index order
+    // return: true if getCompactedCacheSize bytes were appended to <sink>, false if <sink> failed or the editor is not open
+    bool writeCompactedCache(VKSCPipelineCacheSink& sink) const {
+        if (!isOpen()) return false;
+
+        [[maybe_unused]] uint64_t const startOffset = sink.getBytesWritten();
+        uint64_t const indexOffset = m_Reader.getPipelineIndexOffset();
+        uint32_t const pipelineStride = m_Reader.getPipelineIndexStride();
+        uint8_t const* const cacheData = m_Reader.getCacheData();
+
+        VkPipelineCacheHeaderVersionSafetyCriticalOne header{};
+        fillHeader(header, indexOffset);
+        if (!sink.write(&header, sizeof(header)) || !sink.write(cacheData + sizeof(header), indexOffset - sizeof(header))) {
+            return false;
+        }
+
+        VKSCPipelineCachePayloadTable payloads;
+        bool success = true;
+
+        // first pass: the pipeline index
+        uint64_t const dataOffset = indexOffset + uint64_t{getPipelineCount()} * pipelineStride;
+        uint64_t extraOffset = dataOffset;
+        forEachPipeline([&](VkPipelineCacheSafetyCriticalIndexEntry const* pie, VKSCPipelineEntry const* entry) {
+            if (!success) return;
+
+            VkPipelineCacheSafetyCriticalIndexEntry newEntry{};
+            extraOffset = layoutPipeline(pie, entry, extraOffset, newEntry, payloads);
+            success = sink.write(&newEntry, sizeof(newEntry));
+            if (entry) {
+                success = success && writeMetadata(sink, entry, pipelineStride);
+            } else {
+                success = success &&
+                          sink.write(reinterpret_cast<uint8_t const*>(pie) + sizeof(newEntry), pipelineStride - sizeof(newEntry));
+            }
+        });
+
+        // second pass: the data of each pipeline
+        VKSC_ASSERT(!success || sink.getBytesWritten() - startOffset == dataOffset);
+        extraOffset = dataOffset;
+        forEachPipeline([&](VkPipelineCacheSafetyCriticalIndexEntry const* pie, VKSCPipelineEntry const* entry) {
+            if (!success) return;
+
+            if (entry) {
+                success =
+                    entry->writePipelineEntryData(sink, extraOffset, sizeof(VkPipelineCacheStageValidationIndexEntry), &payloads);
+            } else {
+                success = writePipelineData(sink, *pie, extraOffset, payloads);
+            }
+        });
+
+        VKSC_ASSERT(!success || sink.getBytesWritten() - startOffset == extraOffset);
+        return success;
+    }
+
+  private:
+    static constexpr uint32_t kKept = 0U;       // m_Edits value of a pipeline that is carried over as is
+    static constexpr uint32_t kRemoved = ~0U;   // m_Edits value of a removed pipeline
+    static constexpr uint32_t kNotFound = ~0U;  // pipeline index of an added pipeline that replaces nothing
+
+    // append the space for implementation-specific per-pipeline metadata following the pipeline index entry of the
+    // added pipeline <entry> to <sink>: the metadata record of <entry>, zero-filled, ending with the checksum record
+    // if the pipeline cache has checksums
+    bool writeMetadata(VKSCPipelineCacheSink& sink, VKSCPipelineEntry const* entry, uint32_t pipelineStride) const {
+        uint64_t const metadataSize = pipelineStride - sizeof(VkPipelineCacheSafetyCriticalIndexEntry);
+        if (!m_Checksums) {
+            return entry->getPipelineMetadata().write(sink, metadataSize);
+        }
+
+        VKSCPipelineChecksums const checksums = entry->computeChecksums();
+        return entry->getPipelineMetadata().write(sink, metadataSize - sizeof(checksums)) &&
+               sink.write(&checksums, sizeof(checksums));
+    }
+
+    struct AddedEntry {
+        VKSCPipelineEntry const* entry;  // nullptr if removed after being added
+        uint32_t pipelineIndex;          // index of the replaced pipeline in the existing pipeline cache, or kNotFound
+    };
+
+    // return: the index of the pipeline with <identifier> in the existing pipeline cache, kNotFound if there is none
+    uint32_t findPipeline(uint8_t const identifier[VK_UUID_SIZE]) const {
+        VkPipelineCacheSafetyCriticalIndexEntry const* const pie = m_Index.getPipelineIndexEntry(identifier);
+        if (!pie) return kNotFound;
+
+        uint64_t const offset = static_cast<uint64_t>(reinterpret_cast<uint8_t const*>(pie) - m_Reader.getCacheData());
+        return static_cast<uint32_t>((offset - m_Reader.getPipelineIndexOffset()) / m_Reader.getPipelineIndexStride());
+    }
+
+    // append <entry>, replacing the pipeline at <pipelineIndex> in the existing pipeline cache (or kNotFound)
+    // return: the index of the added entry
+    uint32_t addEntry(VKSCPipelineEntry const* entry, uint32_t pipelineIndex) {
+        if (m_AddedCount == m_AddedCapacity) {
+            m_AddedCapacity = m_AddedCapacity > 0U ? m_AddedCapacity * 2U : 16U;
+            AddedEntry* const added = new AddedEntry[m_AddedCapacity];
+            for (uint32_t i = 0U; i < m_AddedCount; ++i) {
+                added[i] = m_Added[i];
+            }
+            if (m_Added) {
+                delete[] m_Added;
+            }
+            m_Added = added;
+        }
+
+        m_Added[m_AddedCount] = AddedEntry{entry, pipelineIndex};
+        return m_AddedCount++;
+    }
+
+    // invoke <f> for each pipeline of the edited pipeline cache, in pipeline index order
+    // <f> is called with the pipeline index entry of the existing pipeline cache for pipelines that are carried over,
+    // and with the added pipeline entry otherwise
+    template <typename F>
+    void forEachPipeline(F&& f) const {
+        uint32_t i = 0U;
+        for (VkPipelineCacheSafetyCriticalIndexEntry const& pie : m_Reader.pipelines()) {
+            uint32_t const edit = m_Edits[i++];
+            if (edit == kKept) {
+                f(&pie, nullptr);
+            } else if (edit != kRemoved) {
+                f(nullptr, m_Added[edit - 1U].entry);
+            }
+        }
+        for (uint32_t j = 0U; j < m_AddedCount; ++j) {
+            if (m_Added[j].entry && m_Added[j].pipelineIndex == kNotFound) {
+                f(nullptr, m_Added[j].entry);
+            }
+        }
+    }
+
+    // return: the offset of the new pipeline index when appending, following the data of all added pipeline entries
+    uint64_t layoutAppendedData() const {
+        uint64_t extraOffset = m_Reader.getCacheSize();
+        forEachPipeline([&](VkPipelineCacheSafetyCriticalIndexEntry const*, VKSCPipelineEntry const* entry) {
+            if (entry) {
+                VkPipelineCacheSafetyCriticalIndexEntry newEntry{};
+                extraOffset = entry->layoutPipelineEntry(extraOffset, sizeof(VkPipelineCacheStageValidationIndexEntry), newEntry);
+            }
+        });
+        return extraOffset;
+    }
+
+    // fill <header> with the header of the existing pipeline cache, updated for the edited pipeline index at <indexOffset>
+    void fillHeader(VkPipelineCacheHeaderVersionSafetyCriticalOne& header, uint64_t indexOffset) const {
+        VKSC_MEMCPY(&header, m_Reader.getCacheData(), sizeof(header));
+        header.pipelineIndexCount = getPipelineCount();
+        header.pipelineIndexOffset = indexOffset;
+    }
+
+    // compute the compacted layout of a pipeline at <extraOffset>, either the carried over <pie> or the added <entry>
+    // return: the advanced value of <extraOffset>
+    uint64_t layoutPipeline(VkPipelineCacheSafetyCriticalIndexEntry const* pie, VKSCPipelineEntry const* entry,
+                            uint64_t extraOffset, VkPipelineCacheSafetyCriticalIndexEntry& newEntry,
+                            VKSCPipelineCachePayloadTable& payloads) const {
+        if (entry) {
+            return entry->layoutPipelineEntry(extraOffset, sizeof(VkPipelineCacheStageValidationIndexEntry), newEntry, &payloads);
+        }
+
+        newEntry = *pie;
+        if (pie->jsonSize > 0U) {
+            newEntry.jsonOffset = payloads.place(pie->jsonSize, m_Reader.getJson(*pie), extraOffset);
+            if (newEntry.jsonOffset == extraOffset) {
+                extraOffset += pie->jsonSize;
+            }
+        }
+
+        if (pie->stageIndexCount > 0U) {
+            newEntry.stageIndexOffset = extraOffset;
+            extraOffset += uint64_t{pie->stageIndexCount} * pie->stageIndexStride;
+
+            for (VkPipelineCacheStageValidationIndexEntry const& sie : m_Reader.stages(*pie)) {
+                if (sie.codeSize > 0U && payloads.place(sie.codeSize, m_Reader.getSPIRV(sie), extraOffset) == extraOffset) {
+                    extraOffset += sie.codeSize;
+                }
+            }
+        }
+
+        return extraOffset;
+    }
+
+    // append the json, stage index and code of the carried over <pie> in the compacted layout to <sink>
+    // return: true on success, false if <sink> failed
+    bool writePipelineData(VKSCPipelineCacheSink& sink, VkPipelineCacheSafetyCriticalIndexEntry const& pie, uint64_t& extraOffset,
+                           VKSCPipelineCachePayloadTable& payloads) const {
+        VkPipelineCacheSafetyCriticalIndexEntry newEntry{};
+        uint64_t const nextOffset = layoutPipeline(&pie, nullptr, extraOffset, newEntry, payloads);
+
+        if (pie.jsonSize > 0U && newEntry.jsonOffset == extraOffset && !sink.write(m_Reader.getJson(pie), pie.jsonSize)) {
+            return false;
+        }
+
+        if (pie.stageIndexCount > 0U) {
+            uint64_t const codeOffset = newEntry.stageIndexOffset + uint64_t{pie.stageIndexCount} * pie.stageIndexStride;
+            uint64_t currentOffset = codeOffset;
+            for (VkPipelineCacheStageValidationIndexEntry const& sie : m_Reader.stages(pie)) {
+                VkPipelineCacheStageValidationIndexEntry newStageEntry = sie;
+                if (sie.codeSize > 0U) {
+                    newStageEntry.codeOffset = payloads.place(sie.codeSize, m_Reader.getSPIRV(sie), currentOffset);
+                    if (newStageEntry.codeOffset == currentOffset) {
+                        currentOffset += sie.codeSize;
+                    }
+                }
+                if (!sink.write(&newStageEntry, sizeof(newStageEntry)) ||
+                    !sink.write(reinterpret_cast<uint8_t const*>(&sie) + sizeof(sie), pie.stageIndexStride - sizeof(sie))) {
+                    return false;
+                }
+            }
+
+            currentOffset = codeOffset;
+            for (VkPipelineCacheStageValidationIndexEntry const& sie : m_Reader.stages(pie)) {
+                if (sie.codeSize > 0U && payloads.place(sie.codeSize, m_Reader.getSPIRV(sie), currentOffset) == currentOffset) {
+                    if (!sink.write(m_Reader.getSPIRV(sie), sie.codeSize)) return false;
+                    currentOffset += sie.codeSize;
+                }
+            }
+        }
+
+        extraOffset = nextOffset;
+        return true;
+    }
+
+    VKSCPipelineCacheHeaderReader const& m_Reader;  // reader of the existing pipeline cache
+    VKSCPipelineCacheIndex m_Index;                 // lookup of the existing pipelines by identifier
+    uint32_t* m_Edits{nullptr};                     // per existing pipeline: kKept, kRemoved, or added entry index plus one
+    AddedEntry* m_Added{nullptr};                   // added pipeline entries, in the order they were added
+    uint32_t m_AddedCount{0U};
+    uint32_t m_AddedCapacity{0U};
+    bool m_Checksums{false};  // whether added pipelines are given a checksum record
+};
+
+#endif  // PCEDITOR_HPP
@@ -0,0 +1,259 @@
+/*
+ * Copyright (c) 2025 The Khronos Group Inc.
+ * Copyright (c) 2025 RasterGrid Kft.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef PCFILE_HPP
+#define PCFILE_HPP 1
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+
+#include <vulkan/pcutil/pcwriter.hpp>
+
+#if defined(_WIN32)
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+// VKSCPipelineCacheFile
+//
+// Utility class to make the contents of a pipeline cache file available in memory, typically
+// for consumption by VKSCPipelineCacheHeaderReader.
+//
+// The file is memory-mapped read-only when the platform supports it, so only the pages that are
+// actually accessed get loaded from storage and no additional copy of the data is made.
+// If the file cannot be mapped (e.g. it is not a regular file) its contents are read into a
+// buffer allocated by this class instead.
+//
+// Usage:
+//   - Instantiate the class
+//   - call open with the path of the pipeline cache file
+//   - pass getSize and getData to VKSCPipelineCacheHeaderReader
+//
+// The data returned by getData remains valid until close is called or this object is destroyed.
+//
+class VKSCPipelineCacheFile {
+  public:
+    VKSCPipelineCacheFile() {}
+
+    // disable copy and assignment
+    VKSCPipelineCacheFile(VKSCPipelineCacheFile const &rhs) = delete;             // copy constructor
+    VKSCPipelineCacheFile(VKSCPipelineCacheFile &&rhs) = delete;                  // move constructor
+    VKSCPipelineCacheFile &operator=(VKSCPipelineCacheFile const &rhs) = delete;  // copy assignment
+    VKSCPipelineCacheFile &operator=(VKSCPipelineCacheFile &&rhs) = delete;       // move assignment
+
+    // destructor - unmap or free the file contents
+    ~VKSCPipelineCacheFile() { close(); }
+
+    // make the contents of the file at <path> available
+    // param: <allowMapping> can be set to false to force reading the file into a buffer
+    // return: true if the file contents are available, false otherwise
+    // this function can only be called when no file is open
+    bool open(char const *path, bool allowMapping = true) {
+        if (m_Data) return false;
+
+        if (allowMapping && map(path)) {
+            return true;
+        }
+
+        return read(path);
+    }
+
+    // release the file contents
+    void close() {
+        if (m_Mapped) {
+#if defined(_WIN32)
+            UnmapViewOfFile(m_Data);
+#else
+            munmap(const_cast<uint8_t *>(m_Data), static_cast<size_t>(m_Size));
+#endif
+        } else if (m_Buffer) {
+            delete[] m_Buffer;
+        }
+        m_Data = nullptr;
+        m_Buffer = nullptr;
+        m_Size = 0U;
+        m_Mapped = false;
+    }
+
+    // return: true if a file is open
+    bool isOpen() const { return m_Data != nullptr; }
+
+    // return: true if the file contents are memory-mapped, false if they were read into a buffer
+    bool isMapped() const { return m_Mapped; }
+
+    // return: the size of the file contents in bytes
+    uint64_t getSize() const { return m_Size; }
+
+    // return: pointer to the file contents
+    uint8_t const *getData() const { return m_Data; }
+
+  private:
+    bool map(char const *path) {
+#if defined(_WIN32)
+        HANDLE file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (file == INVALID_HANDLE_VALUE) {
+            return false;
+        }
+
+        LARGE_INTEGER size{};
+        if (!GetFileSizeEx(file, &size) || size.QuadPart <= 0) {
+            CloseHandle(file);
+            return false;
+        }
+
+        HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        CloseHandle(file);
+        if (mapping == nullptr) {
+            return false;
+        }
+
+        void *data = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+        CloseHandle(mapping);
+        if (data == nullptr) {
+            return false;
+        }
+
+        m_Size = static_cast<uint64_t>(size.QuadPart);
+#else
+        int fd = ::open(path, O_RDONLY);
+        if (fd < 0) {
+            return false;
+        }
+
+        struct stat st {};
+        if (fstat(fd, &st) != 0 || !S_ISREG(st.st_mode) || st.st_size <= 0) {
+            ::close(fd);
+            return false;
+        }
+
+        void *data = mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+        ::close(fd);
+        if (data == MAP_FAILED) {
+            return false;
+        }
+
+        m_Size = static_cast<uint64_t>(st.st_size);
+#endif
+        m_Data = static_cast<uint8_t const *>(data);
+        m_Mapped = true;
+        return true;
+    }
+
+    bool read(char const *path) {
+        FILE *file = fopen(path, "rb");
+        if (file == nullptr) {
+            return false;
+        }
+
+        // the size may not be known upfront (e.g. pipes), so grow the buffer as needed
+        uint64_t capacity = 1U << 20U;
+        uint64_t size = 0U;
+        uint8_t *buffer = new uint8_t[static_cast<size_t>(capacity)];
+        for (;;) {
+            size += fread(buffer + size, 1, static_cast<size_t>(capacity - size), file);
+            if (size < capacity) {
+                break;
+            }
+            uint8_t *grown = new uint8_t[static_cast<size_t>(capacity * 2U)];
+            memcpy(grown, buffer, static_cast<size_t>(size));
+            delete[] buffer;
+            buffer = grown;
+            capacity *= 2U;
+        }
+
+        bool const failed = ferror(file) != 0;
+        fclose(file);
+        if (failed) {
+            delete[] buffer;
+            return false;
+        }
+
+        m_Buffer = buffer;
+        m_Data = buffer;
+        m_Size = size;
+        m_Mapped = false;
+        return true;
+    }
+
+    uint8_t const *m_Data{nullptr};  // file contents, either mapped or pointing to m_Buffer
+    uint8_t *m_Buffer{nullptr};      // buffer owned by this class if the file was read
+    uint64_t m_Size{0U};             // size of the file contents in bytes
+    bool m_Mapped{false};            // whether m_Data is a memory mapping
+};
+
+// VKSCPipelineCacheFileSink
+//
+// Pipeline cache sink writing to a file, for use with VKSCPipelineCacheHeaderWriter::writePipelineCache.
+//
+// Usage:
+//   - Instantiate the class
+//   - call open with the path of the pipeline cache file to create (or overwrite)
+//   - call VKSCPipelineCacheHeaderWriter::writePipelineCache with this sink
+//   - call close and check its result to make sure all data reached the file
+//
+// The output is buffered by the C runtime, so only a bounded amount of memory is used regardless of
+// the size of the pipeline cache.
+//
+class VKSCPipelineCacheFileSink : public VKSCPipelineCacheSink {
+  public:
+    VKSCPipelineCacheFileSink() {}
+
+    // destructor - close the file if still open
+    ~VKSCPipelineCacheFileSink() override { close(); }
+
+    // create or truncate the file at <path> for writing
+    // return: true if the file was opened, false otherwise
+    // this function can only be called when no file is open
+    bool open(char const *path) {
+        if (m_File) return false;
+
+        m_File = fopen(path, "wb");
+        return m_File != nullptr;
+    }
+
+    // flush and close the file
+    // return: true if all data written through this sink reached the file, false otherwise
+    bool close() {
+        if (!m_File) return false;
+
+        bool const failed = (fclose(m_File) != 0) || m_Failed;
+        m_File = nullptr;
+        m_Failed = false;
+        return !failed;
+    }
+
+    // return: true if a file is open
+    bool isOpen() const { return m_File != nullptr; }
+
+  protected:
+    bool writeData(uint8_t const *data, uint64_t size) override {
+        if (!m_File || m_Failed) return false;
+
+        if (fwrite(data, 1, static_cast<size_t>(size), m_File) != size) {
+            m_Failed = true;
+        }
+        return !m_Failed;
+    }
+
+  private:
+    FILE *m_File{nullptr};  // file being written
+    bool m_Failed{false};   // whether any write to m_File failed
+};
+
+#endif  // PCFILE_HPP
@@ -9,10 +9,15 @@
 #ifndef PCREADER_HPP
 #define PCREADER_HPP 1
 
+#include <atomic>
 #include <cstddef>
 #include <cstdint>
+#include <iterator>
 #include <limits>
 
+#include <vulkan/pcutil/pcchecksum.hpp>
+#include <vulkan/pcutil/pccompress.hpp>
+
 #ifndef VKSC_ASSERT
 #include <cassert>
 #define VKSC_ASSERT assert
@@ -20,6 +25,10 @@
 #ifndef VKSC_MEMCMP
 #include <cstring>
 #define VKSC_MEMCMP memcmp
+#endif  // VKSC_MEMCMP
+#ifndef VKSC_MEMCPY
+#include <cstring>
+#define VKSC_MEMCPY memcpy
 #endif  // VKSC_MEMCPY
 
 // Must be version 1.0.6 or newer
@@ -39,6 +48,7 @@
 // getPipelineIndexEntry(index) - return the pipeline index entry for a specified index in the header
 //
 // getPipelineIndexEntry(UUID) - return the pipeline index entry for a specified pipeline identifier
+//   performs a linear search, use VKSCPipelineCacheIndex when resolving many pipeline identifiers
 //
 // getJson - get a pointer to the json for a specfied pipeline index entry
 //
@@ -46,6 +56,170 @@
 //
 // getSPIRV - get a pointer to the SPIRV code for a specified stage index entry
 //
+// isJsonCompressed / isSPIRVCompressed - check whether the json or SPIRV code is stored as a compressed frame
+//
+// getJsonSize / getSPIRVSize - return the size of the json or SPIRV code once decompressed
+//
+// readJson / readSPIRV - copy the json or SPIRV code into a buffer, or pass it to a callback in pieces,
+//   decompressing it if it is stored as a compressed frame
+//
+// getPipelineMetadata / getStageMetadata - get the implementation-specific metadata stored after a specified pipeline
+//   or stage index entry in place, as bytes or as a record of a given type (see VKSCEntryMetadata in pcwriter.hpp)
+//
+// getPipelineChecksums - get the checksum record stored with a specified pipeline index entry, if any
+//
+// verifyPipelineChecksums - check the contents of a specified pipeline against its checksum record
+//
+// verifyChecksums - check the contents of all pipelines against their checksum records,
+//   see VKSCPipelineChecksumVerifier to check each pipeline lazily on first use instead
+//
+// verify - check the structure of the whole pipeline cache blob once
+//
+// getUncheckedView - return an accessor view without per-access checks (only after a successful verify)
+//
+// pipelines - return a range over the pipeline index entries, for use in range-based for loops
+//
+// stages - return a range over the stage index entries of a specified pipeline index entry
+//
+
+// VKSCPipelineCacheRange
+//
+// Range of strided entries (pipeline index entries or stage index entries) in a pipeline cache blob.
+//
+// The base pointer, stride and count are computed once when the range is created, the iterators then
+// advance by plain pointer arithmetic without any further checks or allocations.
+// Ranges returned by VKSCPipelineCacheHeaderReader only contain the entries that lie within the cache,
+// ranges returned by VKSCPipelineCacheUncheckedView contain all entries.
+//
+template <typename Entry>
+class VKSCPipelineCacheRange {
+  public:
+    class iterator {
+      public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = Entry;
+        using difference_type = std::ptrdiff_t;
+        using pointer = Entry const *;
+        using reference = Entry const &;
+
+        iterator(uint8_t const *entry, uint64_t stride) : m_Entry(entry), m_Stride(stride) {}
+
+        reference operator*() const { return *reinterpret_cast<pointer>(m_Entry); }
+        pointer operator->() const { return reinterpret_cast<pointer>(m_Entry); }
+
+        iterator &operator++() {
+            m_Entry += m_Stride;
+            return *this;
+        }
+        iterator operator++(int) {
+            iterator const previous = *this;
+            m_Entry += m_Stride;
+            return previous;
+        }
+
+        bool operator==(iterator const &rhs) const { return m_Entry == rhs.m_Entry; }
+        bool operator!=(iterator const &rhs) const { return m_Entry != rhs.m_Entry; }
+
+      private:
+        uint8_t const *m_Entry;  // current entry
+        uint64_t m_Stride;       // stride between entries in bytes
+    };
+
+    VKSCPipelineCacheRange() : m_Begin(nullptr), m_Stride(0U), m_Count(0U) {}
+    VKSCPipelineCacheRange(uint8_t const *begin, uint64_t stride, uint32_t count)
+        : m_Begin(begin), m_Stride(stride), m_Count(count) {}
+
+    // return: the number of entries in the range
+    uint32_t size() const { return m_Count; }
+
+    // return: true if the range has no entries
+    bool empty() const { return 0U == m_Count; }
+
+    // return: entry at <index>, which must be less than size()
+    Entry const &operator[](uint32_t const index) const {
+        return *reinterpret_cast<Entry const *>(m_Begin + uint64_t{index} * m_Stride);
+    }
+
+    iterator begin() const { return iterator(m_Begin, m_Stride); }
+    iterator end() const { return iterator(m_Begin + uint64_t{m_Count} * m_Stride, m_Stride); }
+
+  private:
+    uint8_t const *m_Begin;  // first entry
+    uint64_t m_Stride;       // stride between entries in bytes
+    uint32_t m_Count;        // number of entries
+};
+
+using VKSCPipelineIndexRange = VKSCPipelineCacheRange<VkPipelineCacheSafetyCriticalIndexEntry>;
+using VKSCStageIndexRange = VKSCPipelineCacheRange<VkPipelineCacheStageValidationIndexEntry>;
+
+// VKSCPipelineCacheUncheckedView
+//
+// Accessors equivalent to those of VKSCPipelineCacheHeaderReader, but without any overflow or bounds
+// checks, meant for hot iteration loops over a pipeline cache blob whose structure is known to be good.
+//
+// Obtain an instance through VKSCPipelineCacheHeaderReader::getUncheckedView after a successful call to
+// VKSCPipelineCacheHeaderReader::verify. The pipeline cache blob is NOT copied and the application must
+// maintain the lifetime of the data while this object is in use.
+//
+
+class VKSCPipelineCacheUncheckedView {
+  public:
+    // return the number of pipelines in the index
+    uint32_t getPipelineIndexCount() const { return m_PipelineIndexCount; }
+
+    // return pointer to pipeline index entry by <index> in pipeline header
+    // precondition: <index> is less than getPipelineIndexCount()
+    VkPipelineCacheSafetyCriticalIndexEntry const *getPipelineIndexEntry(uint32_t const index) const {
+        return reinterpret_cast<VkPipelineCacheSafetyCriticalIndexEntry const *>(m_PipelineIndex +
+                                                                                 uint64_t{index} * m_PipelineIndexStride);
+    }
+
+    // return pointer to json for a given pipeline index entry
+    // nullptr is returned if not present
+    uint8_t const *getJson(VkPipelineCacheSafetyCriticalIndexEntry const &pipelineIndexEntry) const {
+        return (0U == pipelineIndexEntry.jsonOffset) ? nullptr : (m_CacheData + pipelineIndexEntry.jsonOffset);
+    }
+
+    // return pointer to stage validation index entry given a pipeline index entry <pipelineIndexEntry> and <stage>
+    // precondition: <stage> is less than pipelineIndexEntry.stageIndexCount
+    VkPipelineCacheStageValidationIndexEntry const *getStageIndexEntry(
+        VkPipelineCacheSafetyCriticalIndexEntry const &pipelineIndexEntry, uint32_t const stage) const {
+        return reinterpret_cast<VkPipelineCacheStageValidationIndexEntry const *>(
+            m_CacheData + pipelineIndexEntry.stageIndexOffset + uint64_t{stage} * pipelineIndexEntry.stageIndexStride);
+    }
+
+    // return pointer to spirv code in the pipeline cache for a given stage index entry
+    // nullptr is returned if not present
+    uint8_t const *getSPIRV(VkPipelineCacheStageValidationIndexEntry const &stageIndexEntry) const {
+        return (0U == stageIndexEntry.codeOffset) ? nullptr : (m_CacheData + stageIndexEntry.codeOffset);
+    }
+
+    // return a range over all pipeline index entries
+    VKSCPipelineIndexRange pipelines() const {
+        return VKSCPipelineIndexRange(m_PipelineIndex, m_PipelineIndexStride, m_PipelineIndexCount);
+    }
+
+    // return a range over all stage index entries of <pipelineIndexEntry>
+    VKSCStageIndexRange stages(VkPipelineCacheSafetyCriticalIndexEntry const &pipelineIndexEntry) const {
+        return VKSCStageIndexRange(m_CacheData + pipelineIndexEntry.stageIndexOffset, pipelineIndexEntry.stageIndexStride,
+                                   pipelineIndexEntry.stageIndexCount);
+    }
+
+  private:
+    friend class VKSCPipelineCacheHeaderReader;
+
+    VKSCPipelineCacheUncheckedView(uint8_t const *cacheData, uint64_t pipelineIndexOffset, uint32_t pipelineIndexStride,
+                                   uint32_t pipelineIndexCount)
+        : m_CacheData(cacheData),
+          m_PipelineIndex(cacheData + pipelineIndexOffset),
+          m_PipelineIndexStride(pipelineIndexStride),
+          m_PipelineIndexCount(pipelineIndexCount) {}
+
+    uint8_t const *m_CacheData;      // pipeline cache data being accessed
+    uint8_t const *m_PipelineIndex;  // first pipeline index entry
+    uint64_t m_PipelineIndexStride;  // stride between pipeline index entries
+    uint32_t m_PipelineIndexCount;   // number of pipeline index entries
+};
 
 class VKSCPipelineCacheHeaderReader {
   public:
@@ -58,6 +232,10 @@ class VKSCPipelineCacheHeaderReader {
     // basic sanity check of the referenced pipeline cache data
     // make sure m_CacheData starts with a well-formed VkPipelineCacheHeaderVersionSafetyCriticalOne structure
     bool isValid() const {
+        if (m_CacheSize < sizeof(VkPipelineCacheHeaderVersionSafetyCriticalOne)) {
+            return false;
+        }
+
         VkPipelineCacheHeaderVersionSafetyCriticalOne const *const sc1 =
             reinterpret_cast<VkPipelineCacheHeaderVersionSafetyCriticalOne const *>(m_CacheData);
 
@@ -69,6 +247,12 @@ class VKSCPipelineCacheHeaderReader {
         return true;
     }
 
+    // return the size of the referenced pipeline cache data in bytes
+    uint64_t getCacheSize() const { return m_CacheSize; }
+
+    // return pointer to the referenced pipeline cache data
+    uint8_t const *getCacheData() const { return m_CacheData; }
+
     // return pointer to the VkPipelineCacheHeaderVersionOne structure
     VkPipelineCacheHeaderVersionOne const *getHeaderVersionOne() const {
         VkPipelineCacheHeaderVersionOne const *const hv1 = reinterpret_cast<VkPipelineCacheHeaderVersionOne const *>(m_CacheData);
@@ -138,6 +322,7 @@ class VKSCPipelineCacheHeaderReader {
 
     // return pointer to pipeline index entry for requested pipeline identifier
     // nullptr is returned if not found
+    // the lookup is linear in the number of pipelines, see VKSCPipelineCacheIndex for constant-time lookups
     VkPipelineCacheSafetyCriticalIndexEntry const *getPipelineIndexEntry(uint8_t const identifier[VK_UUID_SIZE]) const {
         uint32_t const pipelineIndexCount = getPipelineIndexCount();
         uint32_t const pipelineIndexStride = getPipelineIndexStride();
@@ -232,7 +417,416 @@ class VKSCPipelineCacheHeaderReader {
         return (m_CacheData + offset);
     }
 
+    // return true if the json for a given pipeline index entry is stored as a compressed frame (see pccompress.hpp)
+    bool isJsonCompressed(VkPipelineCacheSafetyCriticalIndexEntry const &pipelineIndexEntry) const {
+        return VKSCPayloadFrame::isFrame(pipelineIndexEntry.jsonSize, getJson(pipelineIndexEntry));
+    }
+
+    // return the size in bytes of the json for a given pipeline index entry once decompressed,
+    // which is jsonSize unless the json is stored as a compressed frame
+    // 0 is returned if not present
+    uint64_t getJsonSize(VkPipelineCacheSafetyCriticalIndexEntry const &pipelineIndexEntry) const {
+        return getPayloadSize(pipelineIndexEntry.jsonSize, getJson(pipelineIndexEntry));
+    }
+
+    // copy the json for a given pipeline index entry to the <size> bytes at <data>, decompressing it if needed
+    // return true if the json is present and well-formed, and <size> is equal to getJsonSize
+    bool readJson(VkPipelineCacheSafetyCriticalIndexEntry const &pipelineIndexEntry, uint64_t const size,
+                  uint8_t *const data) const {
+        return readPayload(pipelineIndexEntry.jsonSize, getJson(pipelineIndexEntry), size, data);
+    }
+
+    // pass the json for a given pipeline index entry to <output> in pieces, decompressing it if needed
+    // <output> is invoked as output(uint8_t const *data, uint64_t size) and returns false to abort,
+    // see VKSCPayloadFrame::decompress
+    // return true if the json is present and well-formed, and all of it was passed to <output>
+    template <typename Output>
+    bool readJson(VkPipelineCacheSafetyCriticalIndexEntry const &pipelineIndexEntry, Output &&output) const {
+        return readPayload(pipelineIndexEntry.jsonSize, getJson(pipelineIndexEntry), output);
+    }
+
+    // return true if the spirv code for a given stage index entry is stored as a compressed frame (see pccompress.hpp)
+    bool isSPIRVCompressed(VkPipelineCacheStageValidationIndexEntry const &stageIndexEntry) const {
+        return VKSCPayloadFrame::isFrame(stageIndexEntry.codeSize, getSPIRV(stageIndexEntry));
+    }
+
+    // return the size in bytes of the spirv code for a given stage index entry once decompressed,
+    // which is codeSize unless the code is stored as a compressed frame
+    // 0 is returned if not present
+    uint64_t getSPIRVSize(VkPipelineCacheStageValidationIndexEntry const &stageIndexEntry) const {
+        return getPayloadSize(stageIndexEntry.codeSize, getSPIRV(stageIndexEntry));
+    }
+
+    // copy the spirv code for a given stage index entry to the <size> bytes at <data>, decompressing it if needed
+    // return true if the code is present and well-formed, and <size> is equal to getSPIRVSize
+    bool readSPIRV(VkPipelineCacheStageValidationIndexEntry const &stageIndexEntry, uint64_t const size,
+                   uint8_t *const data) const {
+        return readPayload(stageIndexEntry.codeSize, getSPIRV(stageIndexEntry), size, data);
+    }
+
+    // pass the spirv code for a given stage index entry to <output> in pieces, decompressing it if needed
+    // <output> is invoked as output(uint8_t const *data, uint64_t size) and returns false to abort,
+    // see VKSCPayloadFrame::decompress
+    // return true if the code is present and well-formed, and all of it was passed to <output>
+    template <typename Output>
+    bool readSPIRV(VkPipelineCacheStageValidationIndexEntry const &stageIndexEntry, Output &&output) const {
+        return readPayload(stageIndexEntry.codeSize, getSPIRV(stageIndexEntry), output);
+    }
+
+    // return pointer to the implementation-specific metadata stored after a given pipeline index entry,
+    // i.e. the rest of the pipeline index stride, excluding the checksum record if there is one
+    // the size of the metadata in bytes is returned in <size>
+    // <pipelineIndexEntry> must be an entry of the pipeline index of this pipeline cache
+    // nullptr is returned if the stride leaves no room for metadata
+    uint8_t const *getPipelineMetadata(VkPipelineCacheSafetyCriticalIndexEntry const &pipelineIndexEntry, uint32_t &size) const {
+        size = 0U;
+        uint32_t const pipelineIndexStride = getPipelineIndexStride();
+        if (pipelineIndexStride <= sizeof(VkPipelineCacheSafetyCriticalIndexEntry)) {
+            return nullptr;
+        }
+
+        uint32_t space = pipelineIndexStride - static_cast<uint32_t>(sizeof(VkPipelineCacheSafetyCriticalIndexEntry));
+        VKSCPipelineChecksums checksums{};
+        if (getPipelineChecksums(pipelineIndexEntry, checksums)) {
+            space -= static_cast<uint32_t>(sizeof(VKSCPipelineChecksums));
+        }
+
+        uint8_t const *const metadata = getEntryMetadata(&pipelineIndexEntry, sizeof(pipelineIndexEntry), space);
+        size = metadata ? space : 0U;
+        return metadata;
+    }
+
+    // return pointer to the implementation-specific metadata stored after a given pipeline index entry as a <T>
+    // nullptr is returned if there is less metadata than the size of <T>, or it is not suitably aligned for <T>
+    template <typename T>
+    T const *getPipelineMetadata(VkPipelineCacheSafetyCriticalIndexEntry const &pipelineIndexEntry) const {
+        uint32_t size = 0U;
+        uint8_t const *const metadata = getPipelineMetadata(pipelineIndexEntry, size);
+        return getMetadataRecord<T>(metadata, size);
+    }
+
+    // return pointer to the implementation-specific metadata stored after the stage index entry of <stage>
+    // of a given pipeline index entry, i.e. the rest of the stage index stride
+    // the size of the metadata in bytes is returned in <size>
+    // nullptr is returned if the stage is not present or the stride leaves no room for metadata
+    uint8_t const *getStageMetadata(VkPipelineCacheSafetyCriticalIndexEntry const &pipelineIndexEntry, uint32_t const stage,
+                                    uint32_t &size) const {
+        size = 0U;
+        VkPipelineCacheStageValidationIndexEntry const *const stageIndexEntry = getStageIndexEntry(pipelineIndexEntry, stage);
+        if (nullptr == stageIndexEntry || pipelineIndexEntry.stageIndexStride <= sizeof(VkPipelineCacheStageValidationIndexEntry)) {
+            return nullptr;
+        }
+
+        uint32_t const space =
+            pipelineIndexEntry.stageIndexStride - static_cast<uint32_t>(sizeof(VkPipelineCacheStageValidationIndexEntry));
+        uint8_t const *const metadata = getEntryMetadata(stageIndexEntry, sizeof(*stageIndexEntry), space);
+        size = metadata ? space : 0U;
+        return metadata;
+    }
+
+    // return pointer to the implementation-specific metadata stored after the stage index entry of <stage>
+    // of a given pipeline index entry as a <T>
+    // nullptr is returned if there is less metadata than the size of <T>, or it is not suitably aligned for <T>
+    template <typename T>
+    T const *getStageMetadata(VkPipelineCacheSafetyCriticalIndexEntry const &pipelineIndexEntry, uint32_t const stage) const {
+        uint32_t size = 0U;
+        uint8_t const *const metadata = getStageMetadata(pipelineIndexEntry, stage, size);
+        return getMetadataRecord<T>(metadata, size);
+    }
+
+    // copy the checksum record stored at the end of a given pipeline index entry to <checksums>
+    // <pipelineIndexEntry> must be an entry of the pipeline index of this pipeline cache
+    // return true if the pipeline index stride leaves room for a checksum record and one is present
+    bool getPipelineChecksums(VkPipelineCacheSafetyCriticalIndexEntry const &pipelineIndexEntry,
+                              VKSCPipelineChecksums &checksums) const {
+        uint32_t const pipelineIndexStride = getPipelineIndexStride();
+        if (pipelineIndexStride < sizeof(VkPipelineCacheSafetyCriticalIndexEntry) + sizeof(VKSCPipelineChecksums)) {
+            return false;
+        }
+
+        uint8_t const *const entry = reinterpret_cast<uint8_t const *>(&pipelineIndexEntry);
+        if (entry < m_CacheData) {
+            return false;
+        }
+
+        uint64_t const offset = static_cast<uint64_t>(entry - m_CacheData) + pipelineIndexStride - sizeof(VKSCPipelineChecksums);
+        if (!isRangeInCache(offset, sizeof(VKSCPipelineChecksums))) {
+            return false;
+        }
+
+        VKSC_MEMCPY(&checksums, m_CacheData + offset, sizeof(VKSCPipelineChecksums));
+        return VKSCPipelineChecksums::kTag == checksums.tag;
+    }
+
+    // check the pipeline index entry, json, stage index entries and spirv code of a given pipeline index entry
+    // against the checksum record stored with it
+    // return true if a checksum record is present and all checksums match
+    bool verifyPipelineChecksums(VkPipelineCacheSafetyCriticalIndexEntry const &pipelineIndexEntry) const {
+        VKSCPipelineChecksums checksums{};
+        if (!getPipelineChecksums(pipelineIndexEntry, checksums) ||
+            VKSCPipelineChecksums::checksumPipeline(pipelineIndexEntry) != checksums.pipeline) {
+            return false;
+        }
+
+        uint8_t const *const json = getJson(pipelineIndexEntry);
+        if ((nullptr == json && pipelineIndexEntry.jsonSize > 0U) ||
+            VKSCCrc32c::update(0U, json, pipelineIndexEntry.jsonSize) != checksums.json) {
+            return false;
+        }
+
+        uint32_t code = 0U;
+        for (uint32_t stage = 0U; stage < pipelineIndexEntry.stageIndexCount; ++stage) {
+            VkPipelineCacheStageValidationIndexEntry const *const stageIndexEntry = getStageIndexEntry(pipelineIndexEntry, stage);
+            if (nullptr == stageIndexEntry) {
+                return false;
+            }
+
+            VkPipelineCacheStageValidationIndexEntry entry{};
+            VKSC_MEMCPY(&entry, stageIndexEntry, sizeof(entry));
+            uint8_t const *const spirv = getSPIRV(entry);
+            if (nullptr == spirv && entry.codeSize > 0U) {
+                return false;
+            }
+            code = VKSCPipelineChecksums::checksumStage(code, entry.codeSize, spirv);
+        }
+
+        return code == checksums.code;
+    }
+
+    // check all pipelines against the checksum records stored with them, see verifyPipelineChecksums
+    // return true if every pipeline index entry lies within the cache, and has a checksum record that all its checksums match
+    bool verifyChecksums() const {
+        VKSCPipelineIndexRange const range = pipelines();
+        if (range.size() != getPipelineIndexCount()) {
+            return false;
+        }
+
+        for (VkPipelineCacheSafetyCriticalIndexEntry const &pipelineIndexEntry : range) {
+            if (!verifyPipelineChecksums(pipelineIndexEntry)) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // return a range over the pipeline index entries
+    // the range is cut short at the first entry that does not lie within the cache, so on a malformed
+    // cache its size may be less than getPipelineIndexCount()
+    VKSCPipelineIndexRange pipelines() const {
+        uint64_t const pipelineIndexOffset = getPipelineIndexOffset();
+        uint32_t const pipelineIndexStride = getPipelineIndexStride();
+        uint32_t const count = getEntryCountInCache(pipelineIndexOffset, pipelineIndexStride, getPipelineIndexCount(),
+                                                    sizeof(VkPipelineCacheSafetyCriticalIndexEntry));
+        return VKSCPipelineIndexRange((count > 0U) ? (m_CacheData + pipelineIndexOffset) : nullptr, pipelineIndexStride, count);
+    }
+
+    // return a range over the stage index entries of <pipelineIndexEntry>
+    // the range is cut short at the first entry that does not lie within the cache, so on a malformed
+    // cache its size may be less than pipelineIndexEntry.stageIndexCount
+    VKSCStageIndexRange stages(VkPipelineCacheSafetyCriticalIndexEntry const &pipelineIndexEntry) const {
+        uint32_t const count =
+            getEntryCountInCache(pipelineIndexEntry.stageIndexOffset, pipelineIndexEntry.stageIndexStride,
+                                 pipelineIndexEntry.stageIndexCount, sizeof(VkPipelineCacheStageValidationIndexEntry));
+        return VKSCStageIndexRange((count > 0U) ? (m_CacheData + pipelineIndexEntry.stageIndexOffset) : nullptr,
+                                   pipelineIndexEntry.stageIndexStride, count);
+    }
+
+    // full structural check of the referenced pipeline cache data
+    // in addition to the checks of isValid, walks the pipeline index, all stage indices, and all json
+    // and SPIR-V ranges and makes sure that:
+    //  - no offset or size computation overflows
+    //  - the pipeline index follows the header and all entries lie within the cache
+    //  - the pipeline and stage index strides are no smaller than the corresponding entry structures
+    //  - every stage index lies within the cache and does not overlap the header or the pipeline index
+    //  - every json and SPIR-V range lies within the cache and does not overlap the header, the pipeline index,
+    //    or the stage index of its pipeline (ranges may be shared between pipelines and stages)
+    //  - absent json and SPIR-V (zero offset) have zero size
+    //  - SPIR-V code sizes are a whole number of 32-bit words (for code stored as a compressed frame,
+    //    the size once decompressed)
+    // return: true if all checks passed, in which case getUncheckedView may be used afterwards
+    bool verify() {
+        m_Verified = false;
+
+        if (!isValid()) {
+            return false;
+        }
+
+        uint64_t const headerSize = sizeof(VkPipelineCacheHeaderVersionSafetyCriticalOne);
+        uint32_t const pipelineIndexCount = getPipelineIndexCount();
+        uint32_t const pipelineIndexStride = getPipelineIndexStride();
+        uint64_t const pipelineIndexOffset = getPipelineIndexOffset();
+        uint64_t pipelineIndexSize = 0U;
+
+        if (pipelineIndexCount > 0U) {
+            if (pipelineIndexStride < sizeof(VkPipelineCacheSafetyCriticalIndexEntry) || pipelineIndexOffset < headerSize) {
+                return false;
+            }
+
+            // the last entry only needs to hold the index entry structure itself
+            pipelineIndexSize =
+                uint64_t{pipelineIndexCount - 1U} * pipelineIndexStride + sizeof(VkPipelineCacheSafetyCriticalIndexEntry);
+            if (!isRangeInCache(pipelineIndexOffset, pipelineIndexSize)) {
+                return false;
+            }
+        }
+
+        for (uint32_t i = 0U; i < pipelineIndexCount; ++i) {
+            VkPipelineCacheSafetyCriticalIndexEntry const &pipelineIndexEntry =
+                *reinterpret_cast<VkPipelineCacheSafetyCriticalIndexEntry const *>(m_CacheData + pipelineIndexOffset +
+                                                                                   uint64_t{i} * pipelineIndexStride);
+
+            uint64_t stageIndexSize = 0U;
+            if (pipelineIndexEntry.stageIndexCount > 0U) {
+                if (pipelineIndexEntry.stageIndexStride < sizeof(VkPipelineCacheStageValidationIndexEntry)) {
+                    return false;
+                }
+
+                stageIndexSize = uint64_t{pipelineIndexEntry.stageIndexCount - 1U} * pipelineIndexEntry.stageIndexStride +
+                                 sizeof(VkPipelineCacheStageValidationIndexEntry);
+                if (!isRangeInCache(pipelineIndexEntry.stageIndexOffset, stageIndexSize) ||
+                    isRangeOverlapping(pipelineIndexEntry.stageIndexOffset, stageIndexSize, 0U, headerSize) ||
+                    isRangeOverlapping(pipelineIndexEntry.stageIndexOffset, stageIndexSize, pipelineIndexOffset,
+                                       pipelineIndexSize)) {
+                    return false;
+                }
+            }
+
+            if (!isPayloadValid(pipelineIndexEntry.jsonOffset, pipelineIndexEntry.jsonSize, pipelineIndexOffset, pipelineIndexSize,
+                                pipelineIndexEntry.stageIndexOffset, stageIndexSize)) {
+                return false;
+            }
+
+            for (uint32_t j = 0U; j < pipelineIndexEntry.stageIndexCount; ++j) {
+                VkPipelineCacheStageValidationIndexEntry const &stageIndexEntry =
+                    *reinterpret_cast<VkPipelineCacheStageValidationIndexEntry const *>(
+                        m_CacheData + pipelineIndexEntry.stageIndexOffset + uint64_t{j} * pipelineIndexEntry.stageIndexStride);
+
+                if (!isPayloadValid(stageIndexEntry.codeOffset, stageIndexEntry.codeSize, pipelineIndexOffset, pipelineIndexSize,
+                                    pipelineIndexEntry.stageIndexOffset, stageIndexSize) ||
+                    (getSPIRVSize(stageIndexEntry) % sizeof(uint32_t)) != 0U) {
+                    return false;
+                }
+            }
+        }
+
+        m_Verified = true;
+        return true;
+    }
+
+    // return: true if the last call to verify was successful
+    bool isVerified() const { return m_Verified; }
+
+    // return an accessor view that performs no overflow or bounds checks on access
+    // precondition: verify was called and returned true
+    VKSCPipelineCacheUncheckedView getUncheckedView() const {
+        VKSC_ASSERT(m_Verified);
+        return VKSCPipelineCacheUncheckedView(m_CacheData, getPipelineIndexOffset(), getPipelineIndexStride(),
+                                              getPipelineIndexCount());
+    }
+
   private:
+    // return: how many of the <count> entries of <entrySize> bytes starting at <offset> with <stride> lie within the cache
+    uint32_t getEntryCountInCache(uint64_t offset, uint64_t stride, uint32_t count, uint64_t entrySize) const {
+        if ((0U == count) || (m_CacheSize < entrySize) || (m_CacheSize - entrySize < offset)) {
+            return 0U;
+        }
+
+        if (0U == stride) {
+            return count;
+        }
+
+        uint64_t const fitting = (m_CacheSize - entrySize - offset) / stride + 1U;
+        return (fitting < count) ? static_cast<uint32_t>(fitting) : count;
+    }
+
+    // return: true if the <size> bytes starting at <offset> lie within the cache
+    bool isRangeInCache(uint64_t offset, uint64_t size) const { return (offset <= m_CacheSize) && (size <= m_CacheSize - offset); }
+
+    // return pointer to the <space> bytes following the index entry of <entrySize> bytes at <entry>,
+    // nullptr if they do not lie within the cache
+    uint8_t const *getEntryMetadata(void const *const entry, uint64_t const entrySize, uint64_t const space) const {
+        uint8_t const *const entryData = static_cast<uint8_t const *>(entry);
+        if (entryData < m_CacheData) {
+            return nullptr;
+        }
+
+        uint64_t const offset = static_cast<uint64_t>(entryData - m_CacheData) + entrySize;
+        if (!isRangeInCache(offset, space)) {
+            return nullptr;
+        }
+        return m_CacheData + offset;
+    }
+
+    // return <metadata> of <size> bytes as a <T>, nullptr if it is too small or not suitably aligned
+    template <typename T>
+    static T const *getMetadataRecord(uint8_t const *const metadata, uint32_t const size) {
+        if (nullptr == metadata || size < sizeof(T) || reinterpret_cast<uintptr_t>(metadata) % alignof(T) != 0U) {
+            return nullptr;
+        }
+        return reinterpret_cast<T const *>(metadata);
+    }
+
+    // return: true if the non-empty ranges [offsetA, offsetA+sizeA) and [offsetB, offsetB+sizeB) overlap
+    // precondition: both ranges lie within the cache (so their ends do not overflow)
+    static bool isRangeOverlapping(uint64_t offsetA, uint64_t sizeA, uint64_t offsetB, uint64_t sizeB) {
+        return (sizeA > 0U) && (sizeB > 0U) && (offsetA < offsetB + sizeB) && (offsetB < offsetA + sizeA);
+    }
+
+    // return: true if the json or SPIR-V payload at <offset> of <size> bytes is absent or lies within the cache
+    // without overlapping the header, the pipeline index, or the stage index of its pipeline
+    bool isPayloadValid(uint64_t offset, uint64_t size, uint64_t pipelineIndexOffset, uint64_t pipelineIndexSize,
+                        uint64_t stageIndexOffset, uint64_t stageIndexSize) const {
+        if (0U == offset) {
+            return 0U == size;
+        }
+
+        return isRangeInCache(offset, size) &&
+               !isRangeOverlapping(offset, size, 0U, sizeof(VkPipelineCacheHeaderVersionSafetyCriticalOne)) &&
+               !isRangeOverlapping(offset, size, pipelineIndexOffset, pipelineIndexSize) &&
+               !isRangeOverlapping(offset, size, stageIndexOffset, stageIndexSize);
+    }
+
+    // return the size of the json or spirv payload of <size> bytes at <data> once decompressed, 0 if <data> is nullptr
+    static uint64_t getPayloadSize(uint64_t const size, uint8_t const *const data) {
+        if (nullptr == data) {
+            return 0U;
+        }
+
+        return VKSCPayloadFrame::isFrame(size, data) ? VKSCPayloadFrame::getDecompressedSize(data) : size;
+    }
+
+    // copy the json or spirv payload of <size> bytes at <data> to the <dstSize> bytes at <dst>, decompressing it if needed
+    static bool readPayload(uint64_t const size, uint8_t const *const data, uint64_t const dstSize, uint8_t *const dst) {
+        if (nullptr == data) {
+            return false;
+        }
+
+        if (VKSCPayloadFrame::isFrame(size, data)) {
+            return VKSCPayloadFrame::decompress(size, data, dstSize, dst);
+        }
+
+        if (dstSize != size) {
+            return false;
+        }
+
+        VKSC_MEMCPY(dst, data, static_cast<size_t>(size));
+        return true;
+    }
+
+    // pass the json or spirv payload of <size> bytes at <data> to <output>, decompressing it if needed
+    template <typename Output>
+    static bool readPayload(uint64_t const size, uint8_t const *const data, Output &output) {
+        if (nullptr == data) {
+            return false;
+        }
+
+        if (VKSCPayloadFrame::isFrame(size, data)) {
+            return VKSCPayloadFrame::decompress(size, data, output);
+        }
+
+        return (0U == size) || output(data, size);
+    }
+
     // return pointer to the pipeline cache SafetyCriticalOne structure
     VkPipelineCacheHeaderVersionSafetyCriticalOne const *getSafetyCriticalOneHeader() const {
         VkPipelineCacheHeaderVersionSafetyCriticalOne const *const sc1 =
@@ -243,6 +837,222 @@ class VKSCPipelineCacheHeaderReader {
 
     uint64_t const m_CacheSize;        // size of data pointed to by m_CacheData in bytes
     uint8_t const *const m_CacheData;  // pipeline cache data being read by this reader
+    bool m_Verified{false};            // whether the last call to verify was successful
+};
+
+// VKSCPipelineCacheIndex
+//
+// Optional companion index to VKSCPipelineCacheHeaderReader providing constant-time lookup of
+// pipeline index entries by pipeline identifier.
+//
+// Instantiate the class with a reader and call build once before performing any lookups.
+// Only the positions of the pipeline index entries are stored in an open-addressed hash table,
+// the pipeline cache blob is NOT copied and the application must maintain the lifetime of the
+// reader and the data it references while this object is instantiated.
+//
+// build - construct the hash table over all entries of the pipeline index
+//
+// getPipelineIndexEntry(UUID) - return the pipeline index entry for a specified pipeline identifier
+//
+// getPipelineIndexEntries - return the pipeline index entries for an array of pipeline identifiers
+//
+
+class VKSCPipelineCacheIndex {
+  public:
+    // initialize the index for the pipeline cache referenced by <reader>
+    // no lookups can be performed until build is called
+    VKSCPipelineCacheIndex(VKSCPipelineCacheHeaderReader const &reader) : m_Reader(reader) {}
+
+    // disable copy and assignment
+    VKSCPipelineCacheIndex(VKSCPipelineCacheIndex const &rhs) = delete;             // copy constructor
+    VKSCPipelineCacheIndex(VKSCPipelineCacheIndex &&rhs) = delete;                  // move constructor
+    VKSCPipelineCacheIndex &operator=(VKSCPipelineCacheIndex const &rhs) = delete;  // copy assignment
+    VKSCPipelineCacheIndex &operator=(VKSCPipelineCacheIndex &&rhs) = delete;       // move assignment
+
+    // destructor - delete any memory this class allocated
+    ~VKSCPipelineCacheIndex() {
+        if (m_Slots) {
+            delete[] m_Slots;
+        }
+    }
+
+    // build the hash table over all pipeline index entries of the cache
+    // if the same pipeline identifier appears multiple times, lookups return the first entry, like
+    // VKSCPipelineCacheHeaderReader::getPipelineIndexEntry(UUID) does
+    // this function can only be called once
+    // return: true if the index was built, false if it was already built or the pipeline index is malformed
+    bool build() {
+        if (m_Slots) return false;
+
+        uint32_t const pipelineIndexCount = m_Reader.getPipelineIndexCount();
+
+        // keep the load factor at or below 50% so that probe sequences stay short
+        uint64_t slotCount = 1U;
+        while (slotCount < uint64_t{pipelineIndexCount} * 2U) {
+            slotCount <<= 1U;
+        }
+
+        uint32_t *const slots = new uint32_t[static_cast<size_t>(slotCount)]();
+        uint64_t const slotMask = slotCount - 1U;
+
+        for (uint32_t i = 0U; i < pipelineIndexCount; ++i) {
+            VkPipelineCacheSafetyCriticalIndexEntry const *const pipelineIndexEntry = m_Reader.getPipelineIndexEntry(i);
+            if (nullptr == pipelineIndexEntry) {
+                delete[] slots;
+                return false;
+            }
+
+            uint64_t slot = hashIdentifier(pipelineIndexEntry->pipelineIdentifier) & slotMask;
+            bool duplicate = false;
+            while (slots[slot] != 0U) {
+                VkPipelineCacheSafetyCriticalIndexEntry const *const other = m_Reader.getPipelineIndexEntry(slots[slot] - 1U);
+                if (VKSC_MEMCMP(other->pipelineIdentifier, pipelineIndexEntry->pipelineIdentifier, VK_UUID_SIZE) == 0) {
+                    duplicate = true;
+                    break;
+                }
+                slot = (slot + 1U) & slotMask;
+            }
+
+            // slots store the pipeline index biased by one, zero denotes an empty slot
+            if (!duplicate) {
+                slots[slot] = i + 1U;
+            }
+        }
+
+        m_Slots = slots;
+        m_SlotMask = slotMask;
+        return true;
+    }
+
+    // return: true if build was called successfully
+    bool isBuilt() const { return m_Slots != nullptr; }
+
+    // return pointer to pipeline index entry for requested pipeline identifier
+    // nullptr is returned if not found or if the index was not built
+    VkPipelineCacheSafetyCriticalIndexEntry const *getPipelineIndexEntry(uint8_t const identifier[VK_UUID_SIZE]) const {
+        if (!m_Slots) {
+            return nullptr;
+        }
+
+        uint64_t slot = hashIdentifier(identifier) & m_SlotMask;
+        while (m_Slots[slot] != 0U) {
+            VkPipelineCacheSafetyCriticalIndexEntry const *const pipelineIndexEntry =
+                m_Reader.getPipelineIndexEntry(m_Slots[slot] - 1U);
+            if (VKSC_MEMCMP(identifier, pipelineIndexEntry->pipelineIdentifier, VK_UUID_SIZE) == 0) {
+                return pipelineIndexEntry;
+            }
+            slot = (slot + 1U) & m_SlotMask;
+        }
+
+        return nullptr;
+    }
+
+    // resolve <count> pipeline identifiers starting at <identifiers> and store pointers to the
+    // corresponding pipeline index entries in <entries>
+    // entries of identifiers that are not found are set to nullptr
+    // return: the number of identifiers found
+    // precondition: <entries> has room for <count> pointers
+    uint32_t getPipelineIndexEntries(uint32_t count, uint8_t const (*identifiers)[VK_UUID_SIZE],
+                                     VkPipelineCacheSafetyCriticalIndexEntry const **entries) const {
+        uint32_t found = 0U;
+        for (uint32_t i = 0U; i < count; ++i) {
+            entries[i] = getPipelineIndexEntry(identifiers[i]);
+            if (entries[i]) {
+                ++found;
+            }
+        }
+        return found;
+    }
+
+  private:
+    // pipeline identifiers are usually digests, but mix all of their bits anyway so that
+    // identifiers differing only in a few bytes still spread evenly over the table
+    static uint64_t hashIdentifier(uint8_t const identifier[VK_UUID_SIZE]) {
+        uint64_t words[2];
+        VKSC_MEMCPY(words, identifier, sizeof(words));
+
+        uint64_t hash = words[0] ^ (words[1] * 0x9E3779B97F4A7C15ULL);
+        hash ^= hash >> 33U;
+        hash *= 0xFF51AFD7ED558CCDULL;
+        hash ^= hash >> 33U;
+        hash *= 0xC4CEB9FE1A85EC53ULL;
+        hash ^= hash >> 33U;
+        return hash;
+    }
+
+    VKSCPipelineCacheHeaderReader const &m_Reader;  // reader of the pipeline cache being indexed
+    uint32_t *m_Slots{nullptr};                     // open-addressed table of biased pipeline indices
+    uint64_t m_SlotMask{0U};                        // number of slots minus one (slot count is a power of two)
+};
+
+// VKSCPipelineChecksumVerifier
+//
+// Optional companion to VKSCPipelineCacheHeaderReader verifying the checksums of each pipeline lazily, the first
+// time the pipeline is used, instead of verifying the whole pipeline cache up front with verifyChecksums.
+//
+// One byte per pipeline records whether the pipeline was verified and with which result, so each pipeline is
+// checksummed at most once. Lookups can be made concurrently from multiple threads, in which case a pipeline used
+// by several threads at the same time may be checksummed more than once, with the same result.
+// The pipeline cache blob is NOT copied and the application must maintain the lifetime of the reader and the
+// data it references while this object is instantiated.
+//
+// isPipelineValid - return whether the checksums of a pipeline match, verifying them on first use
+//
+class VKSCPipelineChecksumVerifier {
+  public:
+    // initialize the verifier for the pipeline cache referenced by <reader>
+    VKSCPipelineChecksumVerifier(VKSCPipelineCacheHeaderReader const &reader)
+        : m_Reader(reader), m_States(new std::atomic<uint8_t>[reader.getPipelineIndexCount()]()) {}
+
+    // disable copy and assignment
+    VKSCPipelineChecksumVerifier(VKSCPipelineChecksumVerifier const &rhs) = delete;             // copy constructor
+    VKSCPipelineChecksumVerifier(VKSCPipelineChecksumVerifier &&rhs) = delete;                  // move constructor
+    VKSCPipelineChecksumVerifier &operator=(VKSCPipelineChecksumVerifier const &rhs) = delete;  // copy assignment
+    VKSCPipelineChecksumVerifier &operator=(VKSCPipelineChecksumVerifier &&rhs) = delete;       // move assignment
+
+    // destructor - delete any memory this class allocated
+    ~VKSCPipelineChecksumVerifier() { delete[] m_States; }
+
+    // return true if the pipeline at <index> in the pipeline index has a checksum record that all its checksums match
+    // the pipeline is only verified on the first call for it, later calls return the remembered result
+    // false is returned if <index> is out of range
+    bool isPipelineValid(uint32_t const index) const {
+        VkPipelineCacheSafetyCriticalIndexEntry const *const pipelineIndexEntry = m_Reader.getPipelineIndexEntry(index);
+        if (nullptr == pipelineIndexEntry) {
+            return false;
+        }
+
+        uint8_t state = m_States[index].load(std::memory_order_relaxed);
+        if (kUnverified == state) {
+            state = m_Reader.verifyPipelineChecksums(*pipelineIndexEntry) ? kValid : kInvalid;
+            m_States[index].store(state, std::memory_order_relaxed);
+        }
+        return kValid == state;
+    }
+
+    // return true if the pipeline of <pipelineIndexEntry> has a checksum record that all its checksums match,
+    // see isPipelineValid(index)
+    // <pipelineIndexEntry> must be an entry of the pipeline index of the pipeline cache, e.g. as returned by
+    // VKSCPipelineCacheIndex::getPipelineIndexEntry
+    bool isPipelineValid(VkPipelineCacheSafetyCriticalIndexEntry const &pipelineIndexEntry) const {
+        uint8_t const *const entry = reinterpret_cast<uint8_t const *>(&pipelineIndexEntry);
+        uint8_t const *const index = m_Reader.getCacheData() + m_Reader.getPipelineIndexOffset();
+        uint32_t const stride = m_Reader.getPipelineIndexStride();
+        if (entry < index || 0U == stride || static_cast<uint64_t>(entry - index) % stride != 0U) {
+            return false;
+        }
+
+        uint64_t const position = static_cast<uint64_t>(entry - index) / stride;
+        return position < m_Reader.getPipelineIndexCount() && isPipelineValid(static_cast<uint32_t>(position));
+    }
+
+  private:
+    static constexpr uint8_t kUnverified = 0U;
+    static constexpr uint8_t kValid = 1U;
+    static constexpr uint8_t kInvalid = 2U;
+
+    VKSCPipelineCacheHeaderReader const &m_Reader;
+    std::atomic<uint8_t> *const m_States;  // verification state of each pipeline
 };
 
 #endif  // PCREADER_HPP
@@ -12,18 +12,347 @@
 #include <algorithm>
 #include <cstddef>
 #include <cstdint>
+#include <system_error>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <vulkan/pcutil/pcchecksum.hpp>
+#include <vulkan/pcutil/pccompress.hpp>
 
 #ifndef VKSC_ASSERT
 #include <cassert>
 #define VKSC_ASSERT assert
 #endif  // VKSC_ASSERT
+#ifndef VKSC_MEMCMP
+#include <cstring>
+#define VKSC_MEMCMP memcmp
+#endif  // VKSC_MEMCMP
 #ifndef VKSC_MEMCPY
 #include <cstring>
 #define VKSC_MEMCPY memcpy
 #endif  // VKSC_MEMCPY
+#ifndef VKSC_MEMSET
+#include <cstring>
+#define VKSC_MEMSET memset
+#endif  // VKSC_MEMSET
 
 #include <vulkan/vulkan_sc.h>
 
+// VKSCPipelineCacheSink
+//
+// Abstract destination for the sequential (streaming) write mode of VKSCPipelineCacheHeaderWriter.
+//
+// The pipeline cache blob is emitted front to back in pieces through write, so the whole blob never
+// needs to be held in memory. Implementations only need to provide writeData, see
+// VKSCPipelineCacheCallbackSink below and VKSCPipelineCacheFileSink in pcfile.hpp.
+//
+class VKSCPipelineCacheSink {
+  public:
+    VKSCPipelineCacheSink() {}
+
+    // disable copy and assignment
+    VKSCPipelineCacheSink(VKSCPipelineCacheSink const& rhs) = delete;             // copy constructor
+    VKSCPipelineCacheSink(VKSCPipelineCacheSink&& rhs) = delete;                  // move constructor
+    VKSCPipelineCacheSink& operator=(VKSCPipelineCacheSink const& rhs) = delete;  // copy assignment
+    VKSCPipelineCacheSink& operator=(VKSCPipelineCacheSink&& rhs) = delete;       // move assignment
+
+    virtual ~VKSCPipelineCacheSink() {}
+
+    // append <size> bytes starting at <data> to the output
+    // return: true on success, false otherwise
+    bool write(void const* data, uint64_t size) {
+        if (0U == size) return true;
+
+        if (!writeData(static_cast<uint8_t const*>(data), size)) return false;
+
+        m_BytesWritten += size;
+        return true;
+    }
+
+    // append <size> zero bytes to the output
+    // return: true on success, false otherwise
+    bool writeZeros(uint64_t size) {
+        static uint8_t const zeros[256]{};
+        while (size > 0U) {
+            uint64_t const chunkSize = std::min(size, static_cast<uint64_t>(sizeof(zeros)));
+            if (!write(zeros, chunkSize)) return false;
+            size -= chunkSize;
+        }
+        return true;
+    }
+
+    // return: the number of bytes successfully written to this sink so far
+    uint64_t getBytesWritten() const { return m_BytesWritten; }
+
+  protected:
+    // append <size> bytes starting at <data> to the output
+    // return: true on success, false otherwise
+    virtual bool writeData(uint8_t const* data, uint64_t size) = 0;
+
+  private:
+    uint64_t m_BytesWritten{0U};
+};
+
+// VKSCPipelineCacheCallbackSink
+//
+// Pipeline cache sink forwarding every piece of the output to an application callback.
+//
+class VKSCPipelineCacheCallbackSink : public VKSCPipelineCacheSink {
+  public:
+    // callback invoked with the <userData> given at construction and the next <size> bytes of output at <data>
+    // return: true on success, false to abort writing
+    typedef bool (*Callback)(void* userData, uint8_t const* data, uint64_t size);
+
+    // initialize the sink with the <callback> to invoke and the <userData> to pass to it
+    VKSCPipelineCacheCallbackSink(Callback callback, void* userData) : m_Callback(callback), m_UserData(userData) {}
+
+  protected:
+    bool writeData(uint8_t const* data, uint64_t size) override { return m_Callback(m_UserData, data, size); }
+
+  private:
+    Callback const m_Callback;
+    void* const m_UserData;
+};
+
+// VKSCPipelineCacheBufferSink
+//
+// Pipeline cache sink writing to an application-provided memory buffer of fixed size.
+// Writing fails once the buffer would overflow.
+//
+class VKSCPipelineCacheBufferSink : public VKSCPipelineCacheSink {
+  public:
+    // initialize the sink with the buffer of <size> bytes starting at <data>
+    VKSCPipelineCacheBufferSink(uint64_t size, uint8_t* data) : m_Size(size), m_Data(data) {}
+
+  protected:
+    bool writeData(uint8_t const* data, uint64_t size) override {
+        uint64_t const offset = getBytesWritten();
+        if (size > m_Size - offset) return false;
+
+        VKSC_MEMCPY(m_Data + offset, data, static_cast<size_t>(size));
+        return true;
+    }
+
+  private:
+    uint64_t const m_Size;
+    uint8_t* const m_Data;
+};
+
+// VKSCPipelineCacheAlignment
+//
+// Alignment policy for the sections of a pipeline cache blob written by VKSCPipelineCacheHeaderWriter.
+//
+// Each member is the alignment in bytes of the start of the corresponding section, and must be a power of two.
+// The default of 1 for every section packs all sections back to back. Padding inserted for alignment is zero-filled.
+//   - pipelineIndex: the pipeline index (e.g. 64 to start it on a cache line)
+//   - json: each json payload
+//   - stageIndex: each per-pipeline stage index
+//   - code: each SPIR-V payload (4 or more allows consuming the code as uint32_t words in place,
+//     a page size allows mapping the code directly)
+//
+struct VKSCPipelineCacheAlignment {
+    uint32_t pipelineIndex{1U};
+    uint32_t json{1U};
+    uint32_t stageIndex{1U};
+    uint32_t code{1U};
+
+    // return: <offset> rounded up to a multiple of <alignment>
+    static uint64_t align(uint64_t offset, uint32_t alignment) {
+        VKSC_ASSERT(alignment > 0U && (alignment & (alignment - 1U)) == 0U);
+        return (offset + alignment - 1U) & ~(uint64_t{alignment} - 1U);
+    }
+
+    // return: true if every alignment is a power of two
+    bool isValid() const {
+        return isPowerOfTwo(pipelineIndex) && isPowerOfTwo(json) && isPowerOfTwo(stageIndex) && isPowerOfTwo(code);
+    }
+
+  private:
+    static bool isPowerOfTwo(uint32_t value) { return value > 0U && (value & (value - 1U)) == 0U; }
+};
+
+// VKSCPipelineCachePayloadTable
+//
+// Content-addressed table of the json and SPIR-V payloads placed in a pipeline cache blob, used by the
+// deduplication mode of VKSCPipelineCacheHeaderWriter so that identical payloads are stored only once
+// and all pipeline and stage index entries referring to them share the same offset.
+//
+// Payloads are identified by a hash of their contents and compared byte-wise on hash matches.
+// The payload data is NOT copied and must outlive this object.
+//
+class VKSCPipelineCachePayloadTable {
+  public:
+    VKSCPipelineCachePayloadTable() {}
+
+    // disable copy and assignment
+    VKSCPipelineCachePayloadTable(VKSCPipelineCachePayloadTable const& rhs) = delete;             // copy constructor
+    VKSCPipelineCachePayloadTable(VKSCPipelineCachePayloadTable&& rhs) = delete;                  // move constructor
+    VKSCPipelineCachePayloadTable& operator=(VKSCPipelineCachePayloadTable const& rhs) = delete;  // copy assignment
+    VKSCPipelineCachePayloadTable& operator=(VKSCPipelineCachePayloadTable&& rhs) = delete;       // move assignment
+
+    // destructor - delete any memory this class allocated
+    ~VKSCPipelineCachePayloadTable() {
+        if (m_Slots) {
+            delete[] m_Slots;
+        }
+    }
+
+    // look up the <size> bytes of payload at <data>
+    // return: the offset of an identical payload placed earlier, or, if there is none, record the payload
+    // as placed at <offset> and return <offset>
+    // once every payload of a pipeline cache has been placed, further calls do not modify the table and
+    // can be made concurrently
+    // precondition: <size> is not zero
+    uint64_t place(uint64_t size, uint8_t const* data, uint64_t offset) {
+        VKSC_ASSERT(size > 0U);
+        uint64_t const hash = hashPayload(size, data);
+
+        if (m_Slots) {
+            for (uint64_t slot = hash & m_SlotMask; m_Slots[slot].data != nullptr; slot = (slot + 1U) & m_SlotMask) {
+                Slot const& candidate = m_Slots[slot];
+                if (candidate.hash == hash && candidate.size == size &&
+                    (candidate.data == data || VKSC_MEMCMP(candidate.data, data, static_cast<size_t>(size)) == 0)) {
+                    return candidate.offset;
+                }
+            }
+        }
+
+        // keep the load factor at or below 50%
+        if (2U * (m_PayloadCount + 1U) > m_SlotMask + 1U) {
+            grow();
+        }
+        insert(Slot{hash, size, data, offset});
+        ++m_PayloadCount;
+        m_PayloadSize += size;
+        return offset;
+    }
+
+    // return: the number of unique payloads placed
+    uint64_t getPayloadCount() const { return m_PayloadCount; }
+
+    // return: the total size in bytes of the unique payloads placed
+    uint64_t getPayloadSize() const { return m_PayloadSize; }
+
+    // return: 64-bit hash of the <size> bytes at <data>, processed a word at a time
+    // payloads with different hashes are guaranteed to differ
+    static uint64_t hashPayload(uint64_t size, uint8_t const* data) {
+        uint64_t const multiplier = 0x9E3779B97F4A7C15ULL;
+        uint64_t hash = size * multiplier;
+        uint64_t i = 0U;
+        for (; i + sizeof(uint64_t) <= size; i += sizeof(uint64_t)) {
+            uint64_t word;
+            VKSC_MEMCPY(&word, data + i, sizeof(word));
+            hash = (hash ^ (word * multiplier)) * 0xBF58476D1CE4E5B9ULL;
+            hash ^= hash >> 31U;
+        }
+        uint64_t tail = 0U;
+        VKSC_MEMCPY(&tail, data + i, static_cast<size_t>(size - i));
+        hash = (hash ^ (tail * multiplier)) * 0x94D049BB133111EBULL;
+        return hash ^ (hash >> 29U);
+    }
+
+  private:
+    struct Slot {
+        uint64_t hash;
+        uint64_t size;
+        uint8_t const* data;  // nullptr for empty slots
+        uint64_t offset;
+    };
+
+    void insert(Slot const& entry) {
+        uint64_t slot = entry.hash & m_SlotMask;
+        while (m_Slots[slot].data != nullptr) {
+            slot = (slot + 1U) & m_SlotMask;
+        }
+        m_Slots[slot] = entry;
+    }
+
+    void grow() {
+        Slot* const oldSlots = m_Slots;
+        uint64_t const oldSlotCount = oldSlots ? m_SlotMask + 1U : 0U;
+
+        uint64_t const slotCount = oldSlots ? 2U * oldSlotCount : 256U;
+        m_Slots = new Slot[slotCount]{};
+        m_SlotMask = slotCount - 1U;
+
+        for (uint64_t i = 0U; i < oldSlotCount; ++i) {
+            if (oldSlots[i].data != nullptr) {
+                insert(oldSlots[i]);
+            }
+        }
+        if (oldSlots) {
+            delete[] oldSlots;
+        }
+    }
+
+    Slot* m_Slots{nullptr};   // open addressing hash table, power-of-two size
+    uint64_t m_SlotMask{0U};  // number of slots minus one
+    uint64_t m_PayloadCount{0U};
+    uint64_t m_PayloadSize{0U};
+};
+
+// VKSCEntryMetadata
+//
+// Implementation-specific metadata record stored with a pipeline or stage index entry, in the space that a
+// pipeline or stage index stride larger than the index entry reserves after it (see
+// VKSCPipelineCacheHeaderWriter::setPipelineMetadataSize and setStageMetadataSize).
+// The record is read back in place with VKSCPipelineCacheHeaderReader::getPipelineMetadata and getStageMetadata.
+//
+// The metadata is NOT copied and the application must maintain the lifetime of the data that was passed in
+// while this object is instantiated. When writing to a memory buffer, the reserved space not covered by the record
+// is left as it is (so the application may fill it in itself), when writing to a sink it is zero-filled.
+//
+// set - set the record to the bytes at a pointer, or to a trivially copyable structure
+// getSize / getData - return the record
+// write - store the record in the reserved space of a pipeline cache blob, or append it to a sink
+//
+class VKSCEntryMetadata {
+  public:
+    // set the record to the <size> bytes at <data>
+    void set(uint32_t size, void const* data) {
+        m_Size = size;
+        m_Data = static_cast<uint8_t const*>(data);
+    }
+
+    // set the record to the structure at <record>
+    template <typename T>
+    void set(T const* record) {
+        static_assert(std::is_trivially_copyable<T>::value, "metadata records must be trivially copyable");
+        set(static_cast<uint32_t>(sizeof(T)), record);
+    }
+
+    // return: the size of the record in bytes, zero if not set
+    uint32_t getSize() const { return m_Size; }
+
+    // return: pointer to the record, nullptr if not set
+    uint8_t const* getData() const { return m_Data; }
+
+    // store the record at the start of the <space> bytes at <data>, the rest of them is not modified
+    // precondition: the record is no larger than <space>
+    void write(uint8_t* data, uint64_t space) const {
+        VKSC_ASSERT(m_Size <= space);
+        uint64_t const size = std::min(uint64_t{m_Size}, space);
+        if (size > 0U) {
+            VKSC_MEMCPY(data, m_Data, static_cast<size_t>(size));
+        }
+    }
+
+    // append the record to <sink>, followed by zeros up to <space> bytes
+    // precondition: the record is no larger than <space>
+    // return: true on success, false if <sink> failed
+    bool write(VKSCPipelineCacheSink& sink, uint64_t space) const {
+        VKSC_ASSERT(m_Size <= space);
+        uint64_t const size = std::min(uint64_t{m_Size}, space);
+        return sink.write(m_Data, size) && sink.writeZeros(space - size);
+    }
+
+  private:
+    uint32_t m_Size{0U};
+    uint8_t const* m_Data{nullptr};
+};
+
 // VKSCStageEntry
 //
 // Utility class to encapsulate a single stage entry.
@@ -31,23 +360,25 @@
 // Usage:
 //   - Instantiate the class
 //   - call setShaderCode to store the SPIR-V code for this stage entry.
+//   - (optional) call setMetadata to store an implementation-specific record in the stage index entry
 //   - (optional) call getStageEntryExtraSize to determine how much cache storage is required for this stage entry
 //   - call writeStageEntry to store the shader entry in the pipeline cache blob
 //
 // The SPIR-V code is NOT copied and the application must maintain the lifetime
 // of the data that was passed in while this object is instantiated.
 // The SPIR-V code will never be modified by this class.
+// As the stage entry only refers to the code, copying it is cheap and both copies refer to the same code.
 //
 class VKSCStageEntry {
   public:
     // initialize the stage entry with no code
     VKSCStageEntry() : m_SpirvSize(0U), m_SpirvCode(nullptr) {}
 
-    // disable copy and assignment
-    VKSCStageEntry(VKSCStageEntry const& rhs) = delete;             // copy constructor
-    VKSCStageEntry(VKSCStageEntry&& rhs) = delete;                  // move constructor
-    VKSCStageEntry& operator=(VKSCStageEntry const& rhs) = delete;  // copy assignment
-    VKSCStageEntry& operator=(VKSCStageEntry&& rhs) = delete;       // move assignment
+    // copy and assignment refer to the same code
+    VKSCStageEntry(VKSCStageEntry const& rhs) = default;             // copy constructor
+    VKSCStageEntry(VKSCStageEntry&& rhs) = default;                  // move constructor
+    VKSCStageEntry& operator=(VKSCStageEntry const& rhs) = default;  // copy assignment
+    VKSCStageEntry& operator=(VKSCStageEntry&& rhs) = default;       // move assignment
 
     // set the SPIR-V code pointer and size for this stage entry.
     // <size> bytes of SPIR-V starting at <code>.
@@ -62,45 +393,177 @@ class VKSCStageEntry {
     // param: <data> is pointer to the beginning of the pipeline cache memory
     // param: <entryoffset> is the offset in bytes from <data> at which to store the stage index entry.
     // param: <extraoffset> is the offset in bytes from <data> at which to store the SPIR-V for this stage.
+    // param: <payloads> (optional) is the table used to share identical SPIR-V between stages.
+    // param: <alignment> (optional) is the alignment policy, of which the code alignment applies.
     // operation:
     //  - writes the stage entry information as a VkPipelineCacheStageValidationIndexEntry structure in <data> at <entryOffset>
-    //  - store the spirv code starting at <extraOffset>
+    //  - store the spirv code starting at <extraOffset> (zero-padded to the code alignment), unless identical code was
+    //    already placed according to <payloads>
     // return: the advanced value of <extraOffset>
     // precondition: the memory at [data,data+size) is writeable for the pipeline cache
-    uint64_t writeStageEntry(uint64_t size, uint8_t* data, uint64_t entryOffset, uint64_t extraOffset) const {
+    uint64_t writeStageEntry(uint64_t size, uint8_t* data, uint64_t entryOffset, uint64_t extraOffset,
+                             VKSCPipelineCachePayloadTable* payloads = nullptr,
+                             VKSCPipelineCacheAlignment const& alignment = VKSCPipelineCacheAlignment{}) const {
         (void)size;
         VkPipelineCacheStageValidationIndexEntry* entry =
             reinterpret_cast<VkPipelineCacheStageValidationIndexEntry*>(data + entryOffset);
         VKSC_ASSERT(size > entryOffset + sizeof(VkPipelineCacheStageValidationIndexEntry));
 
         VkPipelineCacheStageValidationIndexEntry tmpEntry{};
+        uint64_t const nextOffset = layoutStageEntry(extraOffset, tmpEntry, payloads, alignment);
 
-        uint64_t const codeSize = m_SpirvSize;
-        if (codeSize > 0U) {
-            tmpEntry.codeSize = codeSize;
-
-            VKSC_ASSERT(size > extraOffset + codeSize);
-            uint8_t* code = data + extraOffset;
+        uint64_t const codeSize = tmpEntry.codeSize;
+        if (nextOffset != extraOffset) {
+            VKSC_ASSERT(size > tmpEntry.codeOffset + codeSize);
+            VKSC_MEMSET(data + extraOffset, 0, static_cast<size_t>(tmpEntry.codeOffset - extraOffset));
+            uint8_t* code = data + tmpEntry.codeOffset;
             VKSC_MEMCPY(code, m_SpirvCode, static_cast<size_t>(codeSize));
-
-            tmpEntry.codeOffset = extraOffset;
-            extraOffset += codeSize;
-        } else {
-            tmpEntry.codeSize = 0U;
-            tmpEntry.codeOffset = 0U;
         }
 
         VKSC_MEMCPY(entry, &tmpEntry, static_cast<size_t>(sizeof(tmpEntry)));
+        return nextOffset;
+    }
+
+    // param: <extraOffset> is the offset in bytes at which the SPIR-V for this stage is to be stored.
+    // param: <payloads> (optional) is the table used to share identical SPIR-V between stages.
+    // param: <alignment> (optional) is the alignment policy, of which the code alignment applies.
+    // operation:
+    //  - fills <entry> with the stage index entry describing this stage if its code is stored at <extraOffset>
+    //    (rounded up to the code alignment), or at the offset of identical code already placed according to <payloads>
+    //  - nothing is written to the pipeline cache
+    // return: the advanced value of <extraOffset>
+    uint64_t layoutStageEntry(uint64_t extraOffset, VkPipelineCacheStageValidationIndexEntry& entry,
+                              VKSCPipelineCachePayloadTable* payloads = nullptr,
+                              VKSCPipelineCacheAlignment const& alignment = VKSCPipelineCacheAlignment{}) const {
+        entry = VkPipelineCacheStageValidationIndexEntry{};
+
+        if (m_SpirvSize > 0U) {
+            uint64_t const codeOffset = VKSCPipelineCacheAlignment::align(extraOffset, alignment.code);
+            entry.codeSize = m_SpirvSize;
+            entry.codeOffset = payloads ? payloads->place(m_SpirvSize, m_SpirvCode, codeOffset) : codeOffset;
+            if (entry.codeOffset == codeOffset) {
+                extraOffset = codeOffset + m_SpirvSize;
+            }
+        }
+
         return extraOffset;
     }
 
+    // append the SPIR-V code of this stage entry to <sink>, unless identical code was already placed according to <payloads>
+    // param: <extraOffset> is the offset in bytes in the pipeline cache at which <sink> currently is,
+    //        it is advanced past the appended data on success
+    // param: <alignment> (optional) is the alignment policy, of which the code alignment applies.
+    // return: true on success, false otherwise
+    bool writeStageEntryData(VKSCPipelineCacheSink& sink, uint64_t& extraOffset, VKSCPipelineCachePayloadTable* payloads = nullptr,
+                             VKSCPipelineCacheAlignment const& alignment = VKSCPipelineCacheAlignment{}) const {
+        VkPipelineCacheStageValidationIndexEntry tmpEntry{};
+        uint64_t const nextOffset = layoutStageEntry(extraOffset, tmpEntry, payloads, alignment);
+
+        if (nextOffset != extraOffset &&
+            (!sink.writeZeros(tmpEntry.codeOffset - extraOffset) || !sink.write(m_SpirvCode, m_SpirvSize))) {
+            return false;
+        }
+
+        extraOffset = nextOffset;
+        return true;
+    }
+
+    // set the implementation-specific record stored after the stage index entry, see VKSCEntryMetadata
+    // the record must fit into the space reserved with VKSCPipelineCacheHeaderWriter::setStageMetadataSize
+    void setMetadata(VKSCEntryMetadata const& metadata) { m_Metadata = metadata; }
+
+    // return: the implementation-specific record stored after the stage index entry
+    VKSCEntryMetadata const& getMetadata() const { return m_Metadata; }
+
     // return: the amount of space in bytes required for the associated data (code)
     // for this stage entry.
-    uint64_t getStageEntryExtraSize() { return m_SpirvSize; }
+    uint64_t getStageEntryExtraSize() const { return m_SpirvSize; }
+
+    // return: the size in bytes of the SPIR-V code of this stage entry
+    uint64_t getShaderCodeSize() const { return m_SpirvSize; }
+
+    // return: pointer to the SPIR-V code of this stage entry, nullptr if not set
+    uint8_t const* getShaderCode() const { return m_SpirvCode; }
 
   private:
     uint64_t m_SpirvSize;
     uint8_t const* m_SpirvCode;
+    VKSCEntryMetadata m_Metadata;
+};
+
+// VKSCStageEntryArena
+//
+// Utility class to allocate the stage entries of many pipeline entries from a few large blocks
+// instead of one heap allocation per pipeline entry.
+//
+// Usage:
+//   - Instantiate the class
+//   - (optional) call reserve with the total number of stage entries expected
+//   - pass the arena to VKSCPipelineEntry::allocateStages
+//
+// Stage entries are never freed individually, all of them are released when the arena is destroyed,
+// so the arena must outlive all pipeline entries whose stages were allocated from it.
+// VKSCPipelineCacheHeaderWriter::emplacePipelineEntry uses an arena owned by the writer.
+//
+class VKSCStageEntryArena {
+  public:
+    VKSCStageEntryArena() {}
+
+    // disable copy and assignment
+    VKSCStageEntryArena(VKSCStageEntryArena const& rhs) = delete;             // copy constructor
+    VKSCStageEntryArena(VKSCStageEntryArena&& rhs) = delete;                  // move constructor
+    VKSCStageEntryArena& operator=(VKSCStageEntryArena const& rhs) = delete;  // copy assignment
+    VKSCStageEntryArena& operator=(VKSCStageEntryArena&& rhs) = delete;       // move assignment
+
+    // destructor - delete all blocks, and thus all stage entries allocated from this arena
+    ~VKSCStageEntryArena() {
+        while (m_Blocks) {
+            Block* const next = m_Blocks->next;
+            delete[] m_Blocks->stages;
+            delete m_Blocks;
+            m_Blocks = next;
+        }
+    }
+
+    // make sure that the next <stageCount> stage entries can be allocated without further heap allocations
+    void reserve(uint64_t stageCount) {
+        if (m_Blocks && m_Blocks->capacity - m_Blocks->used >= stageCount) return;
+
+        addBlock(std::max(stageCount, kMinBlockSize));
+    }
+
+    // allocate <stageCount> contiguous, default initialized stage entries
+    // return: pointer to the first stage entry, nullptr if <stageCount> is zero
+    VKSCStageEntry* allocate(uint32_t stageCount) {
+        if (0U == stageCount) return nullptr;
+
+        if (!m_Blocks || m_Blocks->capacity - m_Blocks->used < stageCount) {
+            // grow geometrically, so the number of blocks is logarithmic in the number of stage entries
+            uint64_t const blockSize = m_Blocks ? m_Blocks->capacity * 2U : kMinBlockSize;
+            addBlock(std::max(uint64_t{stageCount}, blockSize));
+        }
+
+        VKSCStageEntry* const stages = m_Blocks->stages + m_Blocks->used;
+        m_Blocks->used += stageCount;
+        return stages;
+    }
+
+  private:
+    struct Block {
+        Block* next;
+        VKSCStageEntry* stages;
+        uint64_t capacity;
+        uint64_t used;
+    };
+
+    static constexpr uint64_t kMinBlockSize = 256U;
+
+    void addBlock(uint64_t capacity) {
+        Block* const block = new Block{m_Blocks, new VKSCStageEntry[static_cast<size_t>(capacity)], capacity, 0U};
+        m_Blocks = block;
+    }
+
+    Block* m_Blocks{nullptr};  // most recently added block first, only that one is allocated from
 };
 
 // VKSCPipelineEntry
@@ -109,9 +572,12 @@ class VKSCStageEntry {
 //
 // Usage:
 //   - Instantiate the class with the pipeline identifier and required poolSize.
-//   - call allocateStages to allocate storage for per-stage entries (if being stored)
+//   - call allocateStages to allocate storage for per-stage entries (if being stored),
+//     optionally from a VKSCStageEntryArena
 //   - call setShaderStageCode to set the SPIR-V code for each stage of this pipeline (if being stored)
 //   - call setJsonCode to set the json code for this pipeline (if being stored)
+//   - (optional) call setPipelineMetadata and setStageMetadata to store implementation-specific records
+//     in the pipeline index entry and the stage index entries
 //   - (optional) call getPipelineEntrySize to determine how much cache storage is required for this pipeline entry
 //   - call writePipelineEntry to store the pipeline entry and any associated data in the pipeline cache blob
 //
@@ -119,34 +585,58 @@ class VKSCStageEntry {
 // of the data that was passed in while this object is instantiated.
 // The SPIR-V and JSON code will never be modified by this class.
 //
+// Pipeline entries can be moved (but not copied), so they can be stored in contiguous containers.
+//
 class VKSCPipelineEntry {
   public:
+    // initialize an empty pipeline entry, with a zero identifier and memory size, typically to be assigned to later
+    VKSCPipelineEntry() : m_Identifier{0U} {}
+
     // initialize a pipeline entry with the pipeline <identifier> and required <memorySize>
     VKSCPipelineEntry(uint8_t const identifier[VK_UUID_SIZE], uint64_t memorySize) : m_MemorySize(memorySize) {
         VKSC_MEMCPY(m_Identifier, identifier, VK_UUID_SIZE);
     }
 
-    // disable copy and assignment
+    // disable copy
     VKSCPipelineEntry(VKSCPipelineEntry const& rhs) = delete;             // copy constructor
-    VKSCPipelineEntry(VKSCPipelineEntry&& rhs) = delete;                  // move constructor
     VKSCPipelineEntry& operator=(VKSCPipelineEntry const& rhs) = delete;  // copy assignment
-    VKSCPipelineEntry& operator=(VKSCPipelineEntry&& rhs) = delete;       // move assignment
 
-    // destructor - delete any memory this class allocated
-    ~VKSCPipelineEntry() {
-        if (m_Stages) {
-            delete[] m_Stages;
+    // move constructor - take over the stages of <rhs>, leaving it without stages
+    VKSCPipelineEntry(VKSCPipelineEntry&& rhs) noexcept : m_MemorySize(rhs.m_MemorySize) {
+        VKSC_MEMCPY(m_Identifier, rhs.m_Identifier, VK_UUID_SIZE);
+        takeFrom(rhs);
+    }
+
+    // move assignment - release the stages of this entry and take over the stages of <rhs>, leaving it without stages
+    VKSCPipelineEntry& operator=(VKSCPipelineEntry&& rhs) noexcept {
+        if (this != &rhs) {
+            releaseStages();
+            VKSC_MEMCPY(m_Identifier, rhs.m_Identifier, VK_UUID_SIZE);
+            m_MemorySize = rhs.m_MemorySize;
+            takeFrom(rhs);
         }
+        return *this;
     }
 
+    // destructor - delete any memory this class allocated
+    ~VKSCPipelineEntry() { releaseStages(); }
+
     // allocate storage for <stageCount> stage entries
+    // param: <arena> (optional) is the arena to allocate the stage entries from, it must outlive this entry,
+    //        if not provided the stage entries are allocated on the heap and owned by this entry
     // this function can only be called once
     // return: true if memory allocated, false otherwise
-    bool allocateStages(uint32_t stageCount) {
-        if (m_Stages) return false;
+    bool allocateStages(uint32_t stageCount, VKSCStageEntryArena* arena = nullptr) {
+        if (m_Stages || m_StageCount > 0U) return false;
 
         m_StageCount = stageCount;
-        m_Stages = new VKSCStageEntry[m_StageCount];
+        if (arena) {
+            m_Stages = arena->allocate(stageCount);
+            m_OwnsStages = false;
+        } else {
+            m_Stages = new VKSCStageEntry[m_StageCount];
+            m_OwnsStages = true;
+        }
         return true;
     }
 
@@ -171,80 +661,245 @@ class VKSCPipelineEntry {
         m_JsonPointer = json;
     }
 
+    // store the <size> bytes at <metadata> as the implementation-specific record of the pipeline index entry,
+    // see VKSCEntryMetadata. The record is NOT copied and must fit into the space reserved with
+    // VKSCPipelineCacheHeaderWriter::setPipelineMetadataSize
+    void setPipelineMetadata(uint32_t size, void const* metadata) { m_Metadata.set(size, metadata); }
+
+    // store the structure at <record> as the implementation-specific record of the pipeline index entry
+    template <typename T>
+    void setPipelineMetadata(T const* record) {
+        m_Metadata.set(record);
+    }
+
+    // store the <size> bytes at <metadata> as the implementation-specific record of the stage index entry of <stage>,
+    // see VKSCEntryMetadata. The record is NOT copied and must fit into the space reserved with
+    // VKSCPipelineCacheHeaderWriter::setStageMetadataSize
+    // precondition: <stage> must be less than the value that was passed to allocateStages
+    void setStageMetadata(uint32_t stage, uint32_t size, void const* metadata) {
+        VKSCEntryMetadata record;
+        record.set(size, metadata);
+        setStageMetadata(stage, record);
+    }
+
+    // store the structure at <record> as the implementation-specific record of the stage index entry of <stage>
+    // precondition: <stage> must be less than the value that was passed to allocateStages
+    template <typename T>
+    void setStageMetadata(uint32_t stage, T const* record) {
+        VKSCEntryMetadata metadata;
+        metadata.set(record);
+        setStageMetadata(stage, metadata);
+    }
+
+    // store <metadata> as the implementation-specific record of the stage index entry of <stage>
+    // precondition: <stage> must be less than the value that was passed to allocateStages
+    void setStageMetadata(uint32_t stage, VKSCEntryMetadata const& metadata) {
+        VKSC_ASSERT(stage < m_StageCount);
+        m_Stages[stage].setMetadata(metadata);
+    }
+
+    // return: the implementation-specific record of the pipeline index entry
+    VKSCEntryMetadata const& getPipelineMetadata() const { return m_Metadata; }
+
+    // return: the pipeline identifier of this pipeline entry
+    uint8_t const* getIdentifier() const { return m_Identifier; }
+
+    // return: the required memory size of this pipeline entry
+    uint64_t getMemorySize() const { return m_MemorySize; }
+
+    // return: the size in bytes of the json of this pipeline entry
+    uint64_t getJsonSize() const { return m_JsonSize; }
+
+    // return: pointer to the json of this pipeline entry, nullptr if not set
+    uint8_t const* getJsonCode() const { return m_JsonPointer; }
+
+    // return: the number of stage entries of this pipeline entry
+    uint32_t getStageCount() const { return m_StageCount; }
+
+    // return: the stage entry for stage <stage>
+    // precondition: <stage> must be less than getStageCount
+    VKSCStageEntry const& getStageEntry(uint32_t stage) const {
+        VKSC_ASSERT(stage < m_StageCount);
+        return m_Stages[stage];
+    }
+
+    // return: the checksum record of this pipeline entry, see VKSCPipelineChecksums
+    // the record only depends on the contents of the entry, not on where it is placed in the pipeline cache
+    VKSCPipelineChecksums computeChecksums() const {
+        VkPipelineCacheSafetyCriticalIndexEntry entry{};
+        VKSC_MEMCPY(entry.pipelineIdentifier, m_Identifier, VK_UUID_SIZE);
+        entry.pipelineMemorySize = m_MemorySize;
+        entry.jsonSize = m_JsonSize;
+        entry.stageIndexCount = m_StageCount;
+
+        VKSCPipelineChecksums checksums{};
+        checksums.pipeline = VKSCPipelineChecksums::checksumPipeline(entry);
+        checksums.json = VKSCCrc32c::update(0U, m_JsonPointer, m_JsonSize);
+        for (uint32_t i = 0U; i < m_StageCount; ++i) {
+            checksums.code =
+                VKSCPipelineChecksums::checksumStage(checksums.code, m_Stages[i].getShaderCodeSize(), m_Stages[i].getShaderCode());
+        }
+        return checksums;
+    }
+
     // param: <size> is the amount of memory in bytes for the pipeline cache memory
     // param: <data> is pointer to the beginning of the pipeline cache memory
     // param: <entryoffset> is the offset in bytes from <data> at which to store the pipeline index entry.
     // param: <extraoffset> is the offset in bytes from <data> at which to store the SPIR-V for this stage.
     // param: <stageStride> is the stride between successive entries in the stage index.
+    // param: <payloads> (optional) is the table used to share identical json and SPIR-V between pipelines and stages.
+    // param: <alignment> (optional) is the alignment policy for the json, the stage index and the SPIR-V.
     // operation:
     //  - writes the pipeline entry as a VkPipelineCacheSafetyCriticalIndexEntry structure in <data> at <entryOffset>
-    //  - store any json and stage info starting at <extraOffset>
+    //  - store any json and stage info starting at <extraOffset>, json and SPIR-V already placed according to <payloads>
+    //    are not stored again, padding inserted for <alignment> is zero-filled
     // return: the advanced value of <extraOffset>
     // precondition: the memory at [data,data+size) is writeable for the pipeline cache
     uint64_t writePipelineEntry(uint64_t size, uint8_t* data, uint64_t entryOffset, uint64_t extraOffset,
-                                uint32_t const stageStride) const {
+                                uint32_t const stageStride, VKSCPipelineCachePayloadTable* payloads = nullptr,
+                                VKSCPipelineCacheAlignment const& alignment = VKSCPipelineCacheAlignment{}) const {
         VkPipelineCacheSafetyCriticalIndexEntry* entry =
             reinterpret_cast<VkPipelineCacheSafetyCriticalIndexEntry*>(data + entryOffset);
         VKSC_ASSERT(size > entryOffset + sizeof(VkPipelineCacheSafetyCriticalIndexEntry));
 
         VkPipelineCacheSafetyCriticalIndexEntry tmpEntry{};
-
-        VKSC_MEMCPY(tmpEntry.pipelineIdentifier, m_Identifier, VK_UUID_SIZE);
-        tmpEntry.pipelineMemorySize = m_MemorySize;
-
-        // write optional json
-        uint64_t const jsonSize = m_JsonSize;
-        if (jsonSize > 0U) {
-            tmpEntry.jsonSize = jsonSize;
-
-            VKSC_ASSERT(size > extraOffset + jsonSize);
-            uint8_t* json = data + extraOffset;
+        uint64_t const nextOffset = layoutPipelineEntry(extraOffset, stageStride, tmpEntry, payloads, alignment);
+
+        // write optional json, unless it refers to an earlier copy
+        uint64_t const jsonSize = tmpEntry.jsonSize;
+        if (jsonSize > 0U && tmpEntry.jsonOffset >= extraOffset) {
+            VKSC_ASSERT(size > tmpEntry.jsonOffset + jsonSize);
+            VKSC_MEMSET(data + extraOffset, 0, static_cast<size_t>(tmpEntry.jsonOffset - extraOffset));
+            uint8_t* json = data + tmpEntry.jsonOffset;
             VKSC_MEMCPY(json, m_JsonPointer, static_cast<size_t>(jsonSize));
-
-            tmpEntry.jsonOffset = extraOffset;
-
-            extraOffset += jsonSize;
-        } else {
-            tmpEntry.jsonSize = 0U;
-            tmpEntry.jsonOffset = 0U;
+            extraOffset = tmpEntry.jsonOffset + jsonSize;
         }
 
         // write the stageIndex
-        uint32_t const stageCount = m_StageCount;
+        uint32_t const stageCount = tmpEntry.stageIndexCount;
         if (stageCount > 0U) {
-            uint64_t indexSize = stageCount * stageStride;
-            VKSC_ASSERT(size > extraOffset + indexSize);
-            uint64_t currentOffset = extraOffset;
-
-            tmpEntry.stageIndexCount = stageCount;
-            tmpEntry.stageIndexStride = stageStride;
-            tmpEntry.stageIndexOffset = currentOffset;
-            extraOffset += indexSize;
+            uint64_t const indexSize = uint64_t{stageCount} * stageStride;
+            VKSC_ASSERT(size > tmpEntry.stageIndexOffset + indexSize);
+            VKSC_MEMSET(data + extraOffset, 0, static_cast<size_t>(tmpEntry.stageIndexOffset - extraOffset));
+            uint64_t currentOffset = tmpEntry.stageIndexOffset;
+            extraOffset = tmpEntry.stageIndexOffset + indexSize;
 
             for (uint32_t i = 0U; i < stageCount; ++i) {
-                extraOffset = m_Stages[i].writeStageEntry(size, data, currentOffset, extraOffset);
+                extraOffset = m_Stages[i].writeStageEntry(size, data, currentOffset, extraOffset, payloads, alignment);
+                m_Stages[i].getMetadata().write(data + currentOffset + sizeof(VkPipelineCacheStageValidationIndexEntry),
+                                                stageStride - sizeof(VkPipelineCacheStageValidationIndexEntry));
                 currentOffset += stageStride;
             }
             VKSC_ASSERT(currentOffset == tmpEntry.stageIndexOffset + indexSize);
-        } else {
-            tmpEntry.stageIndexCount = 0U;
-            tmpEntry.stageIndexStride = 0U;
-            tmpEntry.stageIndexOffset = 0U;
+            VKSC_ASSERT(extraOffset == nextOffset);
         }
 
         VKSC_MEMCPY(entry, &tmpEntry, static_cast<size_t>(sizeof(tmpEntry)));
+        return nextOffset;
+    }
+
+    // param: <extraOffset> is the offset in bytes at which the json, stage index and SPIR-V of this pipeline are to be stored.
+    // param: <stageStride> is the stride between successive entries in the stage index.
+    // param: <payloads> (optional) is the table used to share identical json and SPIR-V between pipelines and stages.
+    // param: <alignment> (optional) is the alignment policy for the json, the stage index and the SPIR-V.
+    // operation:
+    //  - fills <entry> with the pipeline index entry describing this pipeline if its data is stored at <extraOffset>,
+    //    json and SPIR-V already placed according to <payloads> are referred to at their existing offset
+    //  - nothing is written to the pipeline cache
+    // return: the advanced value of <extraOffset>
+    uint64_t layoutPipelineEntry(uint64_t extraOffset, uint32_t const stageStride, VkPipelineCacheSafetyCriticalIndexEntry& entry,
+                                 VKSCPipelineCachePayloadTable* payloads = nullptr,
+                                 VKSCPipelineCacheAlignment const& alignment = VKSCPipelineCacheAlignment{}) const {
+        entry = VkPipelineCacheSafetyCriticalIndexEntry{};
+
+        VKSC_MEMCPY(entry.pipelineIdentifier, m_Identifier, VK_UUID_SIZE);
+        entry.pipelineMemorySize = m_MemorySize;
+
+        // optional json comes first
+        if (m_JsonSize > 0U) {
+            uint64_t const jsonOffset = VKSCPipelineCacheAlignment::align(extraOffset, alignment.json);
+            entry.jsonSize = m_JsonSize;
+            entry.jsonOffset = payloads ? payloads->place(m_JsonSize, m_JsonPointer, jsonOffset) : jsonOffset;
+            if (entry.jsonOffset == jsonOffset) {
+                extraOffset = jsonOffset + m_JsonSize;
+            }
+        }
+
+        // followed by the stage index and the code of each stage
+        if (m_StageCount > 0U) {
+            entry.stageIndexCount = m_StageCount;
+            entry.stageIndexStride = stageStride;
+            entry.stageIndexOffset = VKSCPipelineCacheAlignment::align(extraOffset, alignment.stageIndex);
+            extraOffset = entry.stageIndexOffset + uint64_t{m_StageCount} * stageStride;
+
+            for (uint32_t i = 0U; i < m_StageCount; ++i) {
+                VkPipelineCacheStageValidationIndexEntry stageEntry{};
+                extraOffset = m_Stages[i].layoutStageEntry(extraOffset, stageEntry, payloads, alignment);
+            }
+        }
+
         return extraOffset;
     }
 
+    // param: <sink> is the output to append the data of this pipeline entry to
+    // param: <extraOffset> is the offset in bytes in the pipeline cache at which <sink> currently is,
+    //        it is advanced past the appended data on success
+    // param: <stageStride> is the stride between successive entries in the stage index.
+    // param: <payloads> (optional) is the table used to share identical json and SPIR-V between pipelines and stages,
+    //        it must already contain the payloads of all preceding pipeline entries
+    // param: <alignment> (optional) is the alignment policy for the json, the stage index and the SPIR-V.
+    // operation:
+    //  - appends the json, the stage index and all stage code in the same layout as writePipelineEntry
+    //  - the pipeline index entry itself is not written, use layoutPipelineEntry to obtain it
+    // return: true on success, false if <sink> failed
+    bool writePipelineEntryData(VKSCPipelineCacheSink& sink, uint64_t& extraOffset, uint32_t const stageStride,
+                                VKSCPipelineCachePayloadTable* payloads = nullptr,
+                                VKSCPipelineCacheAlignment const& alignment = VKSCPipelineCacheAlignment{}) const {
+        VkPipelineCacheSafetyCriticalIndexEntry tmpEntry{};
+        uint64_t const nextOffset = layoutPipelineEntry(extraOffset, stageStride, tmpEntry, payloads, alignment);
+
+        uint64_t currentOffset = extraOffset;
+        if (tmpEntry.jsonSize > 0U && tmpEntry.jsonOffset >= currentOffset) {
+            if (!sink.writeZeros(tmpEntry.jsonOffset - currentOffset) || !sink.write(m_JsonPointer, tmpEntry.jsonSize)) {
+                return false;
+            }
+            currentOffset = tmpEntry.jsonOffset + tmpEntry.jsonSize;
+        }
+
+        if (m_StageCount > 0U) {
+            if (!sink.writeZeros(tmpEntry.stageIndexOffset - currentOffset)) return false;
+
+            uint64_t const codeOffset = tmpEntry.stageIndexOffset + uint64_t{m_StageCount} * stageStride;
+            currentOffset = codeOffset;
+            for (uint32_t i = 0U; i < m_StageCount; ++i) {
+                VkPipelineCacheStageValidationIndexEntry stageEntry{};
+                currentOffset = m_Stages[i].layoutStageEntry(currentOffset, stageEntry, payloads, alignment);
+                if (!sink.write(&stageEntry, sizeof(stageEntry)) ||
+                    !m_Stages[i].getMetadata().write(sink, stageStride - sizeof(stageEntry))) {
+                    return false;
+                }
+            }
+
+            currentOffset = codeOffset;
+            for (uint32_t i = 0U; i < m_StageCount; ++i) {
+                if (!m_Stages[i].writeStageEntryData(sink, currentOffset, payloads, alignment)) return false;
+            }
+        }
+
+        VKSC_ASSERT(currentOffset == nextOffset);
+        extraOffset = nextOffset;
+        return true;
+    }
+
     // param: <stageStride> is the stride between successive entries in the stage index.
     // return: the amount of space in bytes required for the additional data for this pipeline entry,
     // includes json, stage index, and all associated stage data (code).
-    uint64_t getPipelineEntrySize(uint32_t const stageStride) {
+    uint64_t getPipelineEntrySize(uint32_t const stageStride) const {
         uint64_t stageIndexSize = 0U;
 
         uint32_t const stageCount = m_StageCount;
         if (stageCount > 0U) {
-            stageIndexSize = stageCount * stageStride;
+            stageIndexSize = uint64_t{stageCount} * stageStride;
             uint64_t extraSize = 0U;
 
             for (uint32_t i = 0U; i < stageCount; ++i) {
@@ -257,12 +912,41 @@ class VKSCPipelineEntry {
     }
 
   private:
+    // take over the json and stages of <rhs>, leaving it without them
+    void takeFrom(VKSCPipelineEntry& rhs) {
+        m_Metadata = rhs.m_Metadata;
+        m_JsonSize = rhs.m_JsonSize;
+        m_JsonPointer = rhs.m_JsonPointer;
+        m_StageCount = rhs.m_StageCount;
+        m_Stages = rhs.m_Stages;
+        m_OwnsStages = rhs.m_OwnsStages;
+
+        rhs.m_Metadata = VKSCEntryMetadata{};
+        rhs.m_JsonSize = 0U;
+        rhs.m_JsonPointer = nullptr;
+        rhs.m_StageCount = 0U;
+        rhs.m_Stages = nullptr;
+        rhs.m_OwnsStages = false;
+    }
+
+    // delete the stages if owned by this entry
+    void releaseStages() {
+        if (m_Stages && m_OwnsStages) {
+            delete[] m_Stages;
+        }
+        m_Stages = nullptr;
+        m_StageCount = 0U;
+        m_OwnsStages = false;
+    }
+
     uint8_t m_Identifier[VK_UUID_SIZE];
-    uint64_t const m_MemorySize;
+    uint64_t m_MemorySize{0U};
     uint64_t m_JsonSize{0U};
     uint8_t const* m_JsonPointer{nullptr};
+    VKSCEntryMetadata m_Metadata;
     uint32_t m_StageCount{0U};
     VKSCStageEntry* m_Stages{nullptr};
+    bool m_OwnsStages{false};  // whether m_Stages was allocated by this entry, as opposed to an arena
 };
 
 // VKSCPipelineCacheHeaderWriter
@@ -277,16 +961,32 @@ class VKSCPipelineEntry {
 //        and call setVendorID, setDeviceID, and setPipelineCacheUUID
 //   - call allocatePipelineIndex to allocate storage for pointers to pipeline entries
 //   - call setPipelineEntry for each pipeline entry to be stored in the pipeline cache
+//   - alternatively, have the writer own the pipeline entries: (optionally) call reservePipelineEntries,
+//     then call emplacePipelineEntry for each pipeline entry to be stored in the pipeline cache
 //   - (optional) call setImplementationData to store implementation-specific data in the pipeline index
 //   - (optional) call setPipelineIndexStride to override the default stride for the pipeline index
 //   - (optional) call setPipelineIndexOffset to override the default offset for the pipeline index
 //   - (optional) call setStageIndexStride to override the default stride for the stage entry index
+//   - (optional) call setPipelineMetadataSize and/or setStageMetadataSize to reserve space for the implementation-specific
+//     records set on the pipeline entries (see VKSCEntryMetadata), instead of setting the strides directly
+//   - (optional) call setDeduplicatePayloads to store identical json and SPIR-V payloads only once
+//   - (optional) call setLayoutAlignment to align the pipeline index, json, stage index and SPIR-V sections
+//   - (optional) call setCompressPayloads to store json and SPIR-V payloads as compressed frames
+//   - (optional) call setPipelineChecksums to store a checksum record with each pipeline index entry
 //   - (optional) call getPipelineIndexSize to determine how much cache storage is required for the
 //     pipeline index and associated data
 //   - call writeHeaderSafetyCriticalOne to write the header at the start of the pipeline cache blob
 //   - call writePipelineIndex to write the pipline index and all associated data starting at
 //     the previously set offset
+//   - alternatively, call writePipelineIndexParallel instead of writePipelineIndex to copy the pipeline
+//     entries on multiple threads
+//   - alternatively, call writePipelineCache to emit the whole pipeline cache blob (header, pipeline index
+//     and all associated data) sequentially to a VKSCPipelineCacheSink instead of the two calls above
 
+// reservePipelineEntries - reserve contiguous storage for writer-owned pipeline entries and their stage entries
+//
+// emplacePipelineEntry - append a writer-owned pipeline entry, with its stage entries allocated from a writer-owned arena
+//
 // setPipelineIndexStride - set the stride between successive entries in the pipeline index.
 //   defaults to size of VkPipelineCacheSafetyCriticalIndexEntry.
 //
@@ -296,10 +996,39 @@ class VKSCPipelineEntry {
 // setStageIndexStride - set the stride between successive entries in the per-pipeline stage index
 //   defaults to size of VkPipelineCacheStageValidationIndexEntry.
 //
+// setPipelineMetadataSize / setStageMetadataSize - set the pipeline or stage index stride to leave room for
+//   implementation-specific records of the given size after each index entry. The space reserved by the strides
+//   holds the record set on each pipeline or stage entry (see VKSCEntryMetadata), if any.
+//
+// setDeduplicatePayloads - store each distinct json and SPIR-V payload once, and have all pipeline and stage
+//   index entries with identical contents refer to that single copy. Disabled by default.
+//
+// getDeduplicationSavings - return the number of bytes saved by payload deduplication
+//
+// setCompressPayloads - store each json and SPIR-V payload as a compressed frame (see pccompress.hpp) if that makes it
+//   smaller, the index entries then refer to the frame. Disabled by default.
+//
+// getCompressionSavings - return the number of bytes saved by payload compression
+//
+// setPipelineChecksums - store a VKSCPipelineChecksums record in the last 16 bytes of each pipeline index entry,
+//   which is added to the pipeline index stride. Disabled by default.
+//
+// getPipelineIndexStride - return the stride of the pipeline index, including the checksum record if enabled
+//
+// setLayoutAlignment - set the alignment of the pipeline index, and of each json payload, stage index and SPIR-V
+//   payload, see VKSCPipelineCacheAlignment. Defaults to no alignment (all sections packed back to back).
+//
 // writeHeaderSafetyCriticalOne - write the safety critical header at the start of the cache blob
 //
 // writePipelineIndex - write the pipeline index and all associated data starting at the previously set offset
 //
+// writePipelineIndexParallel - same as writePipelineIndex, but copies the pipeline entries concurrently
+//   either on the given number of threads or through an application-provided executor
+//
+// writePipelineCache - stream the whole pipeline cache blob to a sink, holding at most one entry of it in memory
+//
+// getPipelineCacheSize - return the size of the whole pipeline cache blob
+//
 
 class VKSCPipelineCacheHeaderWriter {
   public:
@@ -313,24 +1042,76 @@ class VKSCPipelineCacheHeaderWriter {
         VKSC_MEMCPY(m_PipelineCacheUUID, pipelineCacheUUID, VK_UUID_SIZE);
     }
 
+    // disable copy and assignment
+    VKSCPipelineCacheHeaderWriter(VKSCPipelineCacheHeaderWriter const& rhs) = delete;             // copy constructor
+    VKSCPipelineCacheHeaderWriter(VKSCPipelineCacheHeaderWriter&& rhs) = delete;                  // move constructor
+    VKSCPipelineCacheHeaderWriter& operator=(VKSCPipelineCacheHeaderWriter const& rhs) = delete;  // copy assignment
+    VKSCPipelineCacheHeaderWriter& operator=(VKSCPipelineCacheHeaderWriter&& rhs) = delete;       // move assignment
+
     // destructor - delete any memory this class allocated
     ~VKSCPipelineCacheHeaderWriter() {
         if (m_PipelineIndex) {
             delete[] m_PipelineIndex;
         }
+        if (m_Entries) {
+            delete[] m_Entries;
+        }
     }
 
     // allocate storage for <pipelineCount> pointers for pipeline index entries
-    // this function can only be called once
+    // this function can only be called once, and not together with reservePipelineEntries or emplacePipelineEntry
     // return: true if memory allocated, false otherwise
     bool allocatePipelineIndex(uint32_t pipelineCount) {
-        if (m_PipelineIndex || m_PipelineCount > 0U) return false;
+        if (m_PipelineIndex || m_Entries || m_PipelineCount > 0U) return false;
 
         m_PipelineCount = pipelineCount;
         m_PipelineIndex = new VKSCPipelineEntry*[m_PipelineCount];
         return true;
     }
 
+    // reserve storage for <pipelineCount> writer-owned pipeline entries with <stageCount> stage entries in total
+    // Entries returned by emplacePipelineEntry remain at the same address as long as no more than the reserved
+    // number of pipeline entries is emplaced.
+    // return: true if memory allocated, false if allocatePipelineIndex was called
+    bool reservePipelineEntries(uint32_t pipelineCount, uint64_t stageCount = 0U) {
+        if (m_PipelineIndex) return false;
+
+        if (pipelineCount > m_EntryCapacity) {
+            growEntries(pipelineCount);
+        }
+        m_StageArena.reserve(stageCount);
+        return true;
+    }
+
+    // append a writer-owned pipeline entry with the pipeline <identifier>, required <memorySize>, and storage for
+    // <stageCount> stage entries allocated from the writer's arena, the pipeline index follows emplace order
+    // The returned entry is to be completed with setShaderStageCode and setJsonCode. It is owned by this object
+    // and remains valid until the next emplacePipelineEntry call that exceeds the capacity reserved with
+    // reservePipelineEntries.
+    // return: pointer to the new pipeline entry, nullptr if allocatePipelineIndex was called
+    VKSCPipelineEntry* emplacePipelineEntry(uint8_t const identifier[VK_UUID_SIZE], uint64_t memorySize, uint32_t stageCount = 0U) {
+        if (m_PipelineIndex) return nullptr;
+
+        if (m_PipelineCount == m_EntryCapacity) {
+            growEntries(std::max(16U, m_EntryCapacity * 2U));
+        }
+
+        VKSCPipelineEntry* const entry = &m_Entries[m_PipelineCount++];
+        *entry = VKSCPipelineEntry(identifier, memorySize);
+        entry->allocateStages(stageCount, &m_StageArena);
+        return entry;
+    }
+
+    // return: the number of pipeline entries in the pipeline index
+    uint32_t getPipelineEntryCount() const { return m_PipelineCount; }
+
+    // return: the pipeline entry at <index> in the pipeline index, either set with setPipelineEntry or emplaced
+    // precondition: <index> must be less than getPipelineEntryCount
+    VKSCPipelineEntry const* getPipelineEntry(uint32_t index) const {
+        VKSC_ASSERT(index < m_PipelineCount);
+        return m_PipelineIndex ? m_PipelineIndex[index] : &m_Entries[index];
+    }
+
     // save a pointer to the pipeline <entry> at the specified <index> in the pipeline index
     // The pipeline entry is NOT copied and the application must maintain the lifetime
     // of the data that was passed in while this object is instantiated.
@@ -367,6 +1148,76 @@ class VKSCPipelineCacheHeaderWriter {
         m_StageIndexStride = std::max(static_cast<uint32_t>(sizeof(VkPipelineCacheStageValidationIndexEntry)), stride);
     }
 
+    // reserve <size> bytes after each pipeline index entry for the record set with VKSCPipelineEntry::setPipelineMetadata
+    // The pipeline index stride is set to the size of VkPipelineCacheSafetyCriticalIndexEntry plus <size>, rounded up
+    // to a multiple of 8 bytes so that the index entries and the records stay 8-byte aligned if the pipeline index is.
+    void setPipelineMetadataSize(uint32_t size) {
+        setPipelineIndexStride(
+            static_cast<uint32_t>(VKSCPipelineCacheAlignment::align(sizeof(VkPipelineCacheSafetyCriticalIndexEntry) + size, 8U)));
+    }
+
+    // reserve <size> bytes after each stage index entry for the record set with VKSCPipelineEntry::setStageMetadata
+    // The stage index stride is set to the size of VkPipelineCacheStageValidationIndexEntry plus <size>, rounded up
+    // to a multiple of 8 bytes so that the index entries and the records stay 8-byte aligned if the stage index is
+    // (set a stage index alignment of 8 with setLayoutAlignment to access the records in place).
+    void setStageMetadataSize(uint32_t size) {
+        setStageIndexStride(
+            static_cast<uint32_t>(VKSCPipelineCacheAlignment::align(sizeof(VkPipelineCacheStageValidationIndexEntry) + size, 8U)));
+    }
+
+    // enable or disable payload deduplication
+    // When enabled, json and SPIR-V payloads are hashed while the layout is computed, and each payload whose
+    // contents are identical to an earlier one is not stored again, its index entry refers to the earlier copy.
+    // This affects all write functions as well as getPipelineIndexSize and getPipelineCacheSize.
+    void setDeduplicatePayloads(bool deduplicate) { m_DeduplicatePayloads = deduplicate; }
+
+    // set the alignment of the sections of the pipeline cache blob
+    // The pipeline index is written at the offset set with setPipelineIndexOffset rounded up to the pipeline index
+    // alignment, and each json payload, stage index and SPIR-V payload starts at a multiple of its alignment.
+    // Offsets are relative to the start of the pipeline cache blob, so the blob itself must be suitably aligned in
+    // memory for the alignment to carry over to the addresses. Padding is zero-filled.
+    // This affects all write functions as well as getPipelineIndexSize and getPipelineCacheSize.
+    // precondition: every alignment in <alignment> is a power of two
+    void setLayoutAlignment(VKSCPipelineCacheAlignment const& alignment) {
+        VKSC_ASSERT(alignment.isValid());
+        m_Alignment = alignment;
+    }
+
+    // return: the alignment of the sections of the pipeline cache blob
+    VKSCPipelineCacheAlignment const& getLayoutAlignment() const { return m_Alignment; }
+
+    // enable or disable pipeline checksums
+    // When enabled, the pipeline index stride is increased by the size of VKSCPipelineChecksums, and the checksum
+    // record of each pipeline (see VKSCPipelineEntry::computeChecksums) is stored in the last bytes of its pipeline
+    // index entry, after any space reserved with setPipelineIndexStride. VKSCPipelineCacheHeaderReader verifies
+    // the checksums with verifyChecksums and verifyPipelineChecksums.
+    // This affects all write functions as well as getPipelineIndexSize and getPipelineCacheSize.
+    void setPipelineChecksums(bool checksums) { m_PipelineChecksums = checksums; }
+
+    // return: the stride in bytes between successive entries in the pipeline index, i.e. the stride set with
+    // setPipelineIndexStride plus the size of the checksum record if pipeline checksums are enabled
+    uint32_t getPipelineIndexStride() const {
+        return m_PipelineIndexStride + (m_PipelineChecksums ? static_cast<uint32_t>(sizeof(VKSCPipelineChecksums)) : 0U);
+    }
+
+    // enable or disable payload compression
+    // When enabled, each json and SPIR-V payload is compressed into a frame (see VKSCPayloadCompressor), and the
+    // frame is stored instead of the payload if it is smaller. The jsonSize and codeSize of the index entries are
+    // then the size of the frame, VKSCPipelineCacheHeaderReader recognizes frames and decompresses them on request.
+    // Payloads that already are compressed frames are stored as they are. Combined with deduplication, identical
+    // payloads still share a single frame.
+    // The payloads are compressed anew by every write function and by getPipelineIndexSize, getPipelineCacheSize,
+    // getDeduplicationSavings and getCompressionSavings, and the frames are held in memory for the duration of the call.
+    // Compressed pipeline caches are only meaningful to applications using this library to read them, an
+    // implementation consuming the pipeline cache must be given one written without compression.
+    void setCompressPayloads(bool compress) { m_CompressPayloads = compress; }
+
+    // return: the offset in bytes into the pipeline cache where the pipeline index is written, i.e. the offset set with
+    // setPipelineIndexOffset rounded up to the pipeline index alignment
+    uint64_t getAlignedPipelineIndexOffset() const {
+        return VKSCPipelineCacheAlignment::align(m_PipelineIndexOffset, m_Alignment.pipelineIndex);
+    }
+
     // set the vendorID
     void setVendorID(uint32_t vendorID) { m_VendorID = vendorID; }
 
@@ -389,16 +1240,7 @@ class VKSCPipelineCacheHeaderWriter {
         (void)size;
         VKSC_ASSERT(size > sizeof(VkPipelineCacheHeaderVersionSafetyCriticalOne));
         VkPipelineCacheHeaderVersionSafetyCriticalOne* sc1 = reinterpret_cast<VkPipelineCacheHeaderVersionSafetyCriticalOne*>(data);
-        sc1->headerVersionOne.headerSize = sizeof(VkPipelineCacheHeaderVersionSafetyCriticalOne);
-        sc1->headerVersionOne.headerVersion = VK_PIPELINE_CACHE_HEADER_VERSION_SAFETY_CRITICAL_ONE;
-        sc1->headerVersionOne.vendorID = m_VendorID;
-        sc1->headerVersionOne.deviceID = m_DeviceID;
-        VKSC_MEMCPY(sc1->headerVersionOne.pipelineCacheUUID, m_PipelineCacheUUID, VK_UUID_SIZE);
-        sc1->validationVersion = VK_PIPELINE_CACHE_VALIDATION_VERSION_SAFETY_CRITICAL_ONE;
-        sc1->implementationData = m_ImplementationData;
-        sc1->pipelineIndexCount = m_PipelineCount;
-        sc1->pipelineIndexStride = m_PipelineIndexStride;
-        sc1->pipelineIndexOffset = m_PipelineIndexOffset;
+        fillHeaderSafetyCriticalOne(*sc1);
     }
 
     // write the Pipeline Index and all associated data at mPipelineIndexOffset bytes into <data>
@@ -406,37 +1248,418 @@ class VKSCPipelineCacheHeaderWriter {
     // param: <data> is pointer to the beginning of the pipeline cache memory
     // returns the offset in bytes into <data> which immediately follows the written information
     // precondition: the memory at [data,data+size) is writeable for the pipeline cache
-    // No implementation-specific per-pipeline or per-stage metadata is written, but space is reserved if
-    // setPipelineIndexStride and/or setStageIndexStride were called appropriately.
+    // The per-pipeline and per-stage metadata records set on the entries are written after their index entries, into
+    // the space reserved with setPipelineIndexStride/setPipelineMetadataSize and setStageIndexStride/setStageMetadataSize,
+    // and the checksum record of each pipeline is written at the end of its index entry if pipeline checksums are enabled.
     uint64_t writePipelineIndex(uint64_t size, uint8_t* data) const {
-        uint64_t indexSize = m_PipelineCount * m_PipelineIndexStride;
-        uint64_t extraOffset = m_PipelineIndexOffset + indexSize;
+        uint64_t const indexOffset = getAlignedPipelineIndexOffset();
+        uint32_t const indexStride = getPipelineIndexStride();
+        uint64_t indexSize = uint64_t{m_PipelineCount} * indexStride;
+        uint64_t extraOffset = indexOffset + indexSize;
         VKSC_ASSERT(size > extraOffset);
+        VKSC_MEMSET(data + m_PipelineIndexOffset, 0, static_cast<size_t>(indexOffset - m_PipelineIndexOffset));
 
-        uint64_t currentOffset = m_PipelineIndexOffset;
+        VKSCPipelineCachePayloadTable payloadTable;
+        VKSCPipelineCachePayloadTable* const payloads = m_DeduplicatePayloads ? &payloadTable : nullptr;
+        CompressedEntries const entries(*this);
+
+        uint64_t currentOffset = indexOffset;
         for (uint32_t i = 0U; i < m_PipelineCount; ++i) {
-            extraOffset = m_PipelineIndex[i]->writePipelineEntry(size, data, currentOffset, extraOffset, m_StageIndexStride);
-            currentOffset += m_PipelineIndexStride;
+            extraOffset = entries.getPipelineEntry(i)->writePipelineEntry(size, data, currentOffset, extraOffset,
+                                                                          m_StageIndexStride, payloads, m_Alignment);
+            writeIndexMetadata(data + currentOffset, *entries.getPipelineEntry(i));
+            currentOffset += indexStride;
         }
 
         return extraOffset;
     }
 
+    // write the Pipeline Index and all associated data at mPipelineIndexOffset bytes into <data> using <threadCount> threads
+    // the output is byte-identical to that of writePipelineIndex
+    // param: <size> is the amount of memory in bytes for the pipeline cache memory
+    // param: <data> is pointer to the beginning of the pipeline cache memory
+    // param: <threadCount> is the number of threads to use, including the calling thread
+    // returns the offset in bytes into <data> which immediately follows the written information
+    // precondition: the memory at [data,data+size) is writeable for the pipeline cache
+    uint64_t writePipelineIndexParallel(uint64_t size, uint8_t* data, uint32_t threadCount) const {
+        return writePipelineIndexParallel(size, data, threadCount, [](uint32_t taskCount, auto const& task) {
+            std::vector<std::thread> threads;
+            threads.reserve(taskCount - 1U);
+            uint32_t threadedCount = 1U;
+            for (; threadedCount < taskCount; ++threadedCount) {
+                try {
+                    threads.emplace_back(task, threadedCount);
+                } catch (std::system_error const&) {
+                    break;
+                }
+            }
+            // the tasks that could not be given a thread run on the calling thread
+            task(0U);
+            for (uint32_t i = threadedCount; i < taskCount; ++i) {
+                task(i);
+            }
+            for (std::thread& thread : threads) {
+                thread.join();
+            }
+        });
+    }
+
+    // write the Pipeline Index and all associated data at mPipelineIndexOffset bytes into <data> using <executor>
+    // the output is byte-identical to that of writePipelineIndex
+    // param: <size> is the amount of memory in bytes for the pipeline cache memory
+    // param: <data> is pointer to the beginning of the pipeline cache memory
+    // param: <taskCount> is the number of tasks to split the work into, each task covers about the same amount of data
+    // param: <executor> is invoked once as executor(taskCount, task), and must call task(taskIndex) exactly once for each
+    //        taskIndex in [0, taskCount), possibly concurrently, and return only after all these calls completed
+    // operation:
+    //  - compresses the payloads sequentially, if enabled
+    //  - computes the offset of the data of each pipeline entry in a sequential layout pass
+    //    (this is also where payloads are deduplicated, if enabled)
+    //  - the tasks then write disjoint ranges of pipeline entries
+    // returns the offset in bytes into <data> which immediately follows the written information
+    // precondition: the memory at [data,data+size) is writeable for the pipeline cache
+    template <typename Executor>
+    uint64_t writePipelineIndexParallel(uint64_t size, uint8_t* data, uint32_t taskCount, Executor&& executor) const {
+        uint64_t const indexOffset = getAlignedPipelineIndexOffset();
+        uint32_t const indexStride = getPipelineIndexStride();
+        uint64_t const indexSize = uint64_t{m_PipelineCount} * indexStride;
+        uint64_t const dataOffset = indexOffset + indexSize;
+        VKSC_ASSERT(size > dataOffset);
+        VKSC_MEMSET(data + m_PipelineIndexOffset, 0, static_cast<size_t>(indexOffset - m_PipelineIndexOffset));
+
+        if (m_PipelineCount == 0U) {
+            return dataOffset;
+        }
+
+        // layout pass: the offset of the data of each pipeline entry
+        // the payload table is complete afterwards, so the tasks below only read it
+        VKSCPipelineCachePayloadTable payloadTable;
+        VKSCPipelineCachePayloadTable* const payloads = m_DeduplicatePayloads ? &payloadTable : nullptr;
+        CompressedEntries const entries(*this);
+
+        uint64_t* const extraOffsets = new uint64_t[m_PipelineCount];
+        uint64_t extraOffset = dataOffset;
+        for (uint32_t i = 0U; i < m_PipelineCount; ++i) {
+            extraOffsets[i] = extraOffset;
+            VkPipelineCacheSafetyCriticalIndexEntry entry{};
+            extraOffset =
+                entries.getPipelineEntry(i)->layoutPipelineEntry(extraOffset, m_StageIndexStride, entry, payloads, m_Alignment);
+        }
+
+        // write pass: each task covers the pipeline entries whose data starts in its share of the data
+        taskCount = std::max(1U, std::min(taskCount, m_PipelineCount));
+        uint64_t const taskDataSize = (extraOffset - dataOffset) / taskCount;
+        auto const taskBegin = [&](uint32_t taskIndex) -> uint32_t {
+            if (taskIndex == taskCount) return m_PipelineCount;
+            uint64_t const* const begin =
+                std::lower_bound(extraOffsets, extraOffsets + m_PipelineCount, dataOffset + taskDataSize * taskIndex);
+            return static_cast<uint32_t>(begin - extraOffsets);
+        };
+        auto const task = [&](uint32_t taskIndex) {
+            uint32_t const end = taskBegin(taskIndex + 1U);
+            for (uint32_t i = taskBegin(taskIndex); i < end; ++i) {
+                uint64_t const entryOffset = indexOffset + uint64_t{i} * indexStride;
+                entries.getPipelineEntry(i)->writePipelineEntry(size, data, entryOffset, extraOffsets[i], m_StageIndexStride,
+                                                                payloads, m_Alignment);
+                writeIndexMetadata(data + entryOffset, *entries.getPipelineEntry(i));
+            }
+        };
+        executor(taskCount, task);
+
+        delete[] extraOffsets;
+        return extraOffset;
+    }
+
+    // write the whole pipeline cache blob sequentially to <sink>
+    // operation:
+    //  - appends the Safety Critical header
+    //  - appends zeros up to the pipeline index offset (the region reserved for implementation-specific data)
+    //  - appends the pipeline index, then the json, stage index and code of each pipeline, in the same
+    //    layout as writePipelineIndex; reserved per-pipeline and per-stage metadata space is zero-filled
+    // The layout is computed on the fly in two passes over the pipeline entries, so apart from the pipeline
+    // entries themselves (and the payload table, if deduplication is enabled, and the compressed frames, if
+    // compression is enabled) no memory proportional to the size of the pipeline cache is needed.
+    // return: true if getPipelineCacheSize bytes were appended to <sink>, false if <sink> failed
+    bool writePipelineCache(VKSCPipelineCacheSink& sink) const {
+        [[maybe_unused]] uint64_t const startOffset = sink.getBytesWritten();
+
+        VkPipelineCacheHeaderVersionSafetyCriticalOne header{};
+        fillHeaderSafetyCriticalOne(header);
+        uint64_t const indexOffset = getAlignedPipelineIndexOffset();
+        if (!sink.write(&header, sizeof(header)) || !sink.writeZeros(indexOffset - sizeof(header))) return false;
+
+        VKSCPipelineCachePayloadTable payloadTable;
+        VKSCPipelineCachePayloadTable* const payloads = m_DeduplicatePayloads ? &payloadTable : nullptr;
+        CompressedEntries const entries(*this);
+
+        // first pass: the pipeline index
+        uint64_t const dataOffset = indexOffset + uint64_t{m_PipelineCount} * getPipelineIndexStride();
+        uint64_t extraOffset = dataOffset;
+        for (uint32_t i = 0U; i < m_PipelineCount; ++i) {
+            VkPipelineCacheSafetyCriticalIndexEntry entry{};
+            extraOffset =
+                entries.getPipelineEntry(i)->layoutPipelineEntry(extraOffset, m_StageIndexStride, entry, payloads, m_Alignment);
+            if (!sink.write(&entry, sizeof(entry)) ||
+                !entries.getPipelineEntry(i)->getPipelineMetadata().write(sink, m_PipelineIndexStride - sizeof(entry))) {
+                return false;
+            }
+            if (m_PipelineChecksums) {
+                VKSCPipelineChecksums const checksums = entries.getPipelineEntry(i)->computeChecksums();
+                if (!sink.write(&checksums, sizeof(checksums))) return false;
+            }
+        }
+
+        // second pass: the data of each pipeline
+        VKSC_ASSERT(sink.getBytesWritten() - startOffset == dataOffset);
+        extraOffset = dataOffset;
+        for (uint32_t i = 0U; i < m_PipelineCount; ++i) {
+            if (!entries.getPipelineEntry(i)->writePipelineEntryData(sink, extraOffset, m_StageIndexStride, payloads,
+                                                                     m_Alignment)) {
+                return false;
+            }
+        }
+
+        VKSC_ASSERT(sink.getBytesWritten() - startOffset == extraOffset);
+        return true;
+    }
+
+    // return: the size in bytes of the whole pipeline cache blob, including the header, the region reserved
+    // before the pipeline index, the pipeline index and all associated data.
+    uint64_t getPipelineCacheSize() const { return m_PipelineIndexOffset + getPipelineIndexSize(); }
+
     // return: the amount of space in bytes required for the pipeline index and all associated data.
-    // includes pipeline index and all associated pipeline entry data (json, stage index, stage code).
+    // includes pipeline index and all associated pipeline entry data (json, stage index, stage code),
+    // as well as any padding required by the layout alignment, starting from the offset set with setPipelineIndexOffset.
     // Does NOT include the size of the initial VkPipelineCacheHeaderVersionSafetyCriticalOne header.
     uint64_t getPipelineIndexSize() const {
-        uint64_t indexSize = m_PipelineCount * m_PipelineIndexStride;
+        if (m_DeduplicatePayloads || m_CompressPayloads) {
+            CompressedEntries const entries(*this);
+            VKSCPipelineCachePayloadTable payloads;
+            return layoutPipelineIndex(entries, m_DeduplicatePayloads ? &payloads : nullptr) - m_PipelineIndexOffset;
+        }
+        if (m_Alignment.pipelineIndex > 1U || m_Alignment.json > 1U || m_Alignment.stageIndex > 1U || m_Alignment.code > 1U) {
+            return layoutPipelineIndex(CompressedEntries(*this), nullptr) - m_PipelineIndexOffset;
+        }
+
+        uint64_t indexSize = uint64_t{m_PipelineCount} * getPipelineIndexStride();
         uint64_t extraSize = 0U;
 
         for (uint32_t i = 0U; i < m_PipelineCount; ++i) {
-            extraSize += m_PipelineIndex[i]->getPipelineEntrySize(m_StageIndexStride);
+            extraSize += getPipelineEntry(i)->getPipelineEntrySize(m_StageIndexStride);
         }
 
         return indexSize + extraSize;
     }
 
+    // return: the number of bytes of json and SPIR-V payloads that deduplication avoids storing
+    // (zero if deduplication is disabled)
+    uint64_t getDeduplicationSavings() const {
+        if (!m_DeduplicatePayloads) {
+            return 0U;
+        }
+
+        CompressedEntries const entries(*this);
+        VKSCPipelineCachePayloadTable payloads;
+        return layoutPipelineIndex(entries, nullptr) - layoutPipelineIndex(entries, &payloads);
+    }
+
+    // return: the number of bytes of json and SPIR-V payloads that compression avoids storing, after deduplication
+    // if that is enabled as well (zero if compression is disabled)
+    uint64_t getCompressionSavings() const {
+        if (!m_CompressPayloads) {
+            return 0U;
+        }
+
+        CompressedEntries const entries(*this);
+        CompressedEntries const uncompressed(*this, false);
+        VKSCPipelineCachePayloadTable payloads;
+        VKSCPipelineCachePayloadTable compressedPayloads;
+        return layoutPipelineIndex(uncompressed, m_DeduplicatePayloads ? &payloads : nullptr) -
+               layoutPipelineIndex(entries, m_DeduplicatePayloads ? &compressedPayloads : nullptr);
+    }
+
   private:
+    // The pipeline entries of a writer as they are to be stored: if payload compression is enabled, copies of the
+    // pipeline entries referring to compressed frames instead of the original payloads, otherwise the pipeline
+    // entries themselves. Frames are compressed once for each distinct payload and owned by this object.
+    class CompressedEntries {
+      public:
+        // compress the payloads of the pipeline entries of <writer>, if <compress> and payload compression is enabled
+        explicit CompressedEntries(VKSCPipelineCacheHeaderWriter const& writer, bool compress = true) : m_Writer(writer) {
+            if (!compress || !writer.m_CompressPayloads || writer.m_PipelineCount == 0U) return;
+
+            uint64_t stageCount = 0U;
+            for (uint32_t i = 0U; i < writer.m_PipelineCount; ++i) {
+                stageCount += writer.getPipelineEntry(i)->getStageCount();
+            }
+            uint64_t const payloadCount = writer.m_PipelineCount + stageCount;
+            m_FrameSizes = new uint64_t[payloadCount];
+            m_Frames = new uint8_t const*[payloadCount];
+            m_StageArena.reserve(stageCount);
+            m_Entries = new VKSCPipelineEntry[writer.m_PipelineCount];
+
+            VKSCPayloadCompressor compressor;
+            VKSCPipelineCachePayloadTable payloads;  // index of the frame of each distinct payload
+            for (uint32_t i = 0U; i < writer.m_PipelineCount; ++i) {
+                VKSCPipelineEntry const* const source = writer.getPipelineEntry(i);
+                VKSCPipelineEntry& entry = m_Entries[i];
+                entry = VKSCPipelineEntry(source->getIdentifier(), source->getMemorySize());
+                entry.setPipelineMetadata(source->getPipelineMetadata().getSize(), source->getPipelineMetadata().getData());
+
+                uint64_t jsonSize = source->getJsonSize();
+                uint8_t const* json = source->getJsonCode();
+                compressPayload(compressor, payloads, jsonSize, json);
+                entry.setJsonCode(jsonSize, json);
+
+                entry.allocateStages(source->getStageCount(), &m_StageArena);
+                for (uint32_t j = 0U; j < source->getStageCount(); ++j) {
+                    uint64_t codeSize = source->getStageEntry(j).getShaderCodeSize();
+                    uint8_t const* code = source->getStageEntry(j).getShaderCode();
+                    compressPayload(compressor, payloads, codeSize, code);
+                    entry.setShaderStageCode(j, codeSize, code);
+                    entry.setStageMetadata(j, source->getStageEntry(j).getMetadata());
+                }
+            }
+        }
+
+        // disable copy and assignment
+        CompressedEntries(CompressedEntries const& rhs) = delete;             // copy constructor
+        CompressedEntries(CompressedEntries&& rhs) = delete;                  // move constructor
+        CompressedEntries& operator=(CompressedEntries const& rhs) = delete;  // copy assignment
+        CompressedEntries& operator=(CompressedEntries&& rhs) = delete;       // move assignment
+
+        // destructor - delete any memory this class allocated
+        ~CompressedEntries() {
+            if (m_Entries) {
+                delete[] m_Entries;
+            }
+            if (m_FrameSizes) {
+                delete[] m_FrameSizes;
+            }
+            if (m_Frames) {
+                delete[] m_Frames;
+            }
+            while (m_Blocks) {
+                FrameBlock* const next = m_Blocks->next;
+                delete[] m_Blocks->data;
+                delete m_Blocks;
+                m_Blocks = next;
+            }
+        }
+
+        // return: the pipeline entry at <index> in the pipeline index, as it is to be stored
+        VKSCPipelineEntry const* getPipelineEntry(uint32_t index) const {
+            return m_Entries ? &m_Entries[index] : m_Writer.getPipelineEntry(index);
+        }
+
+      private:
+        // storage for frames, allocated in large blocks
+        struct FrameBlock {
+            FrameBlock* next;
+            uint8_t* data;
+            uint64_t capacity;  // bytes of frames the block can hold
+            uint64_t used;      // bytes of frames stored in the block
+        };
+
+        // replace the <size> bytes of payload at <data> with its frame, if the frame is smaller
+        // identical payloads are compressed once and share the frame
+        void compressPayload(VKSCPayloadCompressor& compressor, VKSCPipelineCachePayloadTable& payloads, uint64_t& size,
+                             uint8_t const*& data) {
+            if (size == 0U || size > VKSCPayloadCompressor::getMaxPayloadSize() || VKSCPayloadFrame::isFrame(size, data)) {
+                return;
+            }
+
+            uint64_t const index = payloads.place(size, data, m_FrameCount);
+            if (index == m_FrameCount) {
+                uint8_t* const frame = allocateFrame(VKSCPayloadCompressor::getMaxFrameSize(size));
+                uint64_t const frameSize = compressor.compress(size, data, VKSCPayloadCompressor::getMaxFrameSize(size), frame);
+                if (frameSize > 0U && frameSize < size) {
+                    m_Blocks->used += frameSize;
+                    m_FrameSizes[index] = frameSize;
+                    m_Frames[index] = frame;
+                } else {
+                    m_FrameSizes[index] = size;
+                    m_Frames[index] = data;
+                }
+                ++m_FrameCount;
+            }
+
+            size = m_FrameSizes[index];
+            data = m_Frames[index];
+        }
+
+        // return: pointer to <size> bytes of unused space in the current block, starting a new block if necessary
+        // the space is only taken once the used size of the current block is advanced
+        uint8_t* allocateFrame(uint64_t size) {
+            if (!m_Blocks || m_Blocks->capacity - m_Blocks->used < size) {
+                uint64_t const capacity = std::max(size, kBlockSize);
+                m_Blocks = new FrameBlock{m_Blocks, new uint8_t[capacity], capacity, 0U};
+            }
+            return m_Blocks->data + m_Blocks->used;
+        }
+
+        static constexpr uint64_t kBlockSize = 1U << 20U;
+
+        VKSCPipelineCacheHeaderWriter const& m_Writer;
+        VKSCPipelineEntry* m_Entries{nullptr};  // copies of the pipeline entries, nullptr if not compressing
+        VKSCStageEntryArena m_StageArena;       // storage for the stage entries of m_Entries
+        uint64_t* m_FrameSizes{nullptr};        // size of the frame of each distinct payload
+        uint8_t const** m_Frames{nullptr};      // frame of each distinct payload, or the payload if not compressible
+        uint64_t m_FrameCount{0U};              // number of distinct payloads
+        FrameBlock* m_Blocks{nullptr};          // storage for the frames, most recent block first
+    };
+
+    // move the writer-owned pipeline entries to new storage for <capacity> entries
+    void growEntries(uint32_t capacity) {
+        VKSCPipelineEntry* const entries = new VKSCPipelineEntry[capacity];
+        for (uint32_t i = 0U; i < m_PipelineCount; ++i) {
+            entries[i] = std::move(m_Entries[i]);
+        }
+        if (m_Entries) {
+            delete[] m_Entries;
+        }
+        m_Entries = entries;
+        m_EntryCapacity = capacity;
+    }
+
+    // store the metadata record of <entry> after its pipeline index entry at <indexEntry>, followed by
+    // the checksum record if pipeline checksums are enabled
+    void writeIndexMetadata(uint8_t* indexEntry, VKSCPipelineEntry const& entry) const {
+        entry.getPipelineMetadata().write(indexEntry + sizeof(VkPipelineCacheSafetyCriticalIndexEntry),
+                                          m_PipelineIndexStride - sizeof(VkPipelineCacheSafetyCriticalIndexEntry));
+        if (m_PipelineChecksums) {
+            VKSCPipelineChecksums const checksums = entry.computeChecksums();
+            VKSC_MEMCPY(indexEntry + m_PipelineIndexStride, &checksums, sizeof(checksums));
+        }
+    }
+
+    // return: the offset in bytes following the pipeline index and all associated data of <entries>,
+    // using <payloads> (optional) to deduplicate payloads
+    uint64_t layoutPipelineIndex(CompressedEntries const& entries, VKSCPipelineCachePayloadTable* payloads) const {
+        uint64_t extraOffset = getAlignedPipelineIndexOffset() + uint64_t{m_PipelineCount} * getPipelineIndexStride();
+        for (uint32_t i = 0U; i < m_PipelineCount; ++i) {
+            VkPipelineCacheSafetyCriticalIndexEntry entry{};
+            extraOffset =
+                entries.getPipelineEntry(i)->layoutPipelineEntry(extraOffset, m_StageIndexStride, entry, payloads, m_Alignment);
+        }
+
+        return extraOffset;
+    }
+
+    // fill <sc1> with the Safety Critical header describing this pipeline cache
+    void fillHeaderSafetyCriticalOne(VkPipelineCacheHeaderVersionSafetyCriticalOne& sc1) const {
+        sc1.headerVersionOne.headerSize = sizeof(VkPipelineCacheHeaderVersionSafetyCriticalOne);
+        sc1.headerVersionOne.headerVersion = VK_PIPELINE_CACHE_HEADER_VERSION_SAFETY_CRITICAL_ONE;
+        sc1.headerVersionOne.vendorID = m_VendorID;
+        sc1.headerVersionOne.deviceID = m_DeviceID;
+        VKSC_MEMCPY(sc1.headerVersionOne.pipelineCacheUUID, m_PipelineCacheUUID, VK_UUID_SIZE);
+        sc1.validationVersion = VK_PIPELINE_CACHE_VALIDATION_VERSION_SAFETY_CRITICAL_ONE;
+        sc1.implementationData = m_ImplementationData;
+        sc1.pipelineIndexCount = m_PipelineCount;
+        sc1.pipelineIndexStride = getPipelineIndexStride();
+        sc1.pipelineIndexOffset = getAlignedPipelineIndexOffset();
+    }
+
     uint32_t m_VendorID{0U};
     uint32_t m_DeviceID{0U};
     uint8_t m_PipelineCacheUUID[VK_UUID_SIZE]{0U};
@@ -445,9 +1668,17 @@ class VKSCPipelineCacheHeaderWriter {
     uint32_t m_PipelineIndexStride{sizeof(VkPipelineCacheSafetyCriticalIndexEntry)};
     uint64_t m_PipelineIndexOffset{sizeof(VkPipelineCacheHeaderVersionSafetyCriticalOne)};
     uint32_t m_StageIndexStride{sizeof(VkPipelineCacheStageValidationIndexEntry)};
+    bool m_DeduplicatePayloads{false};
+    bool m_CompressPayloads{false};
+    bool m_PipelineChecksums{false};
+    VKSCPipelineCacheAlignment m_Alignment{};
 
     uint32_t m_PipelineCount{0U};
-    VKSCPipelineEntry** m_PipelineIndex{nullptr};
+    VKSCPipelineEntry** m_PipelineIndex{nullptr};  // pipeline entries set with setPipelineEntry
+
+    VKSCPipelineEntry* m_Entries{nullptr};  // pipeline entries owned by this object, added with emplacePipelineEntry
+    uint32_t m_EntryCapacity{0U};
+    VKSCStageEntryArena m_StageArena;  // storage for the stage entries of m_Entries
 };
 
 #endif  // PCWRITER_HPP
@@ -7,7 +7,10 @@
 
 #pragma once
 
+#include <algorithm>
+#include <ctype.h>
 #include <string>
+#include <string_view>
 #include <sstream>
 #include <stdlib.h>
 
@@ -46,11 +49,12 @@ class Base {
         static constexpr size_t kDefaultSize = 32768;
         static constexpr size_t kDefaultAlignment = 64;
 
-        MemoryBlock(size_t size = kDefaultSize) : size_(size), used_bytes_(0) {
+        // aligned_alloc requires the size to be a multiple of the alignment
+        MemoryBlock(size_t size = kDefaultSize) : size_((size + kDefaultAlignment - 1) & ~(kDefaultAlignment - 1)), used_bytes_(0) {
 #ifdef _WIN32
-            block_ = reinterpret_cast<uint8_t*>(_aligned_malloc(size, kDefaultAlignment));
+            block_ = reinterpret_cast<uint8_t*>(_aligned_malloc(size_, kDefaultAlignment));
 #else
-            block_ = reinterpret_cast<uint8_t*>(aligned_alloc(kDefaultAlignment, size));
+            block_ = reinterpret_cast<uint8_t*>(aligned_alloc(kDefaultAlignment, size_));
 #endif
         }
 
@@ -69,6 +73,9 @@ class Base {
             }
         }
 
+        // Makes the whole block available again, invalidating all previous allocations
+        void Clear() { used_bytes_ = 0; }
+
       private:
         MemoryBlock(const MemoryBlock&) = delete;
         MemoryBlock& operator=(const MemoryBlock&) = delete;
@@ -111,6 +118,7 @@ class Base {
 
     void ClearStatusAndMessages() {
         status_ = true;
+        message_sink_.str(std::string{});
         message_sink_.clear();
     }
 
@@ -122,18 +130,24 @@ class Base {
 
     template <typename T>
     T* AllocMem(size_t count = 1) {
-        if (memory_blocks_.empty()) {
-            memory_blocks_.emplace_back();
-        }
-        void* ptr = memory_blocks_.back().Alloc(alignof(T), count * sizeof(T));
-        if (ptr == nullptr) {
-            memory_blocks_.emplace_back(std::max(MemoryBlock::kDefaultSize, count * sizeof(T)));
-            ptr = memory_blocks_.back().Alloc(alignof(T), count * sizeof(T));
+        // Blocks kept by FreeAllMem are filled again in order before allocating a new one
+        for (; current_block_ < memory_blocks_.size(); ++current_block_) {
+            void* ptr = memory_blocks_[current_block_].Alloc(alignof(T), count * sizeof(T));
+            if (ptr != nullptr) {
+                return reinterpret_cast<T*>(ptr);
+            }
         }
-        return reinterpret_cast<T*>(ptr);
+        memory_blocks_.emplace_back(std::max(MemoryBlock::kDefaultSize, count * sizeof(T)));
+        return reinterpret_cast<T*>(memory_blocks_.back().Alloc(alignof(T), count * sizeof(T)));
     }
 
-    void FreeAllMem() { memory_blocks_.clear(); }
+    // Invalidates all allocations, but keeps the memory blocks for reuse until the object is destroyed
+    void FreeAllMem() {
+        for (auto& block : memory_blocks_) {
+            block.Clear();
+        }
+        current_block_ = 0;
+    }
 
     std::stringstream& Error() {
         if (message_sink_.rdbuf()->in_avail() > 0) {
@@ -154,6 +168,33 @@ class Base {
         return message_sink_;
     }
 
+    // Calls <f> with each '|' separated name of the flags string <str>, with all whitespace removed from the names. The names
+    // are the same as std::getline would split, i.e. there is no empty name after a trailing '|', but there is one between two
+    // consecutive '|' characters. Only names with whitespace inside them need to be copied, all others are passed as views
+    // into <str>.
+    template <typename F>
+    void ForEachFlagName(std::string_view str, F&& f) {
+        auto is_space = [](char c) { return isspace(static_cast<unsigned char>(c)) != 0; };
+        size_t begin = 0;
+        while (begin < str.size()) {
+            const size_t end = std::min(str.find('|', begin), str.size());
+            std::string_view name = str.substr(begin, end - begin);
+            while (!name.empty() && is_space(name.front())) {
+                name.remove_prefix(1);
+            }
+            while (!name.empty() && is_space(name.back())) {
+                name.remove_suffix(1);
+            }
+            if (std::any_of(name.begin(), name.end(), is_space)) {
+                flag_name_.assign(name);
+                flag_name_.erase(std::remove_if(flag_name_.begin(), flag_name_.end(), is_space), flag_name_.end());
+                name = flag_name_;
+            }
+            f(name);
+            begin = end + 1;
+        }
+    }
+
     const char* GetMessages() {
         if (message_sink_.rdbuf()->in_avail() > 0) {
             messages_ = message_sink_.str();
@@ -186,9 +227,12 @@ class Base {
     std::stringstream message_sink_{};
     std::string messages_{};
 
+    std::string flag_name_{};
+
     std::vector<LocationDesc> location_{};
 
     std::vector<MemoryBlock> memory_blocks_{};
+    size_t current_block_{0};
 };
 
 }  // namespace pcjson
@@ -0,0 +1,89 @@
+/*
+ * Copyright (c) 2025 The Khronos Group Inc.
+ * Copyright (c) 2025 RasterGrid Kft.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+
+namespace pcjson {
+
+// Reads 8 bytes of <str> as a little-endian integer, regardless of the byte order of the host
+inline uint64_t LoadNameWord(const char* str) {
+    uint64_t word;
+    memcpy(&word, str, sizeof(word));
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+    word = __builtin_bswap64(word);
+#endif
+    return word;
+}
+
+// Hash of a constant name processing 8 bytes at a time, json_parse_generator.py computes the same when building the name
+// tables. The last partial word is read as the last 8 bytes of the name, overlapping with the previous word, or zero padded
+// if the name is shorter than 8 bytes.
+inline uint64_t HashName(std::string_view name) {
+    constexpr uint64_t kMultiplier = 0x9e3779b97f4a7c15ull;
+    const size_t size = name.size();
+    uint64_t hash = size * kMultiplier;
+    auto mix = [&](uint64_t word) {
+        hash = (hash ^ word) * kMultiplier;
+        hash ^= hash >> 32;
+    };
+    size_t offset = 0;
+    for (; offset + 8 <= size; offset += 8) {
+        mix(LoadNameWord(name.data() + offset));
+    }
+    if (offset < size) {
+        if (size >= 8) {
+            mix(LoadNameWord(name.data() + size - 8));
+        } else {
+            char padded[8] = {};
+            memcpy(padded, name.data(), size);
+            mix(LoadNameWord(padded));
+        }
+    }
+    return hash;
+}
+
+// Slot of a name with <hash> in a name table of <entry_count> entries, given the displacement of its bucket
+constexpr size_t NameTableSlot(uint64_t hash, uint32_t displacement, size_t entry_count) {
+    uint32_t x = static_cast<uint32_t>(hash) ^ displacement;
+    x ^= x >> 16;
+    x *= 0x7feb352du;
+    x ^= x >> 15;
+    x *= 0x846ca68bu;
+    x ^= x >> 16;
+    return x % entry_count;
+}
+
+template <typename T>
+struct NameTableEntry {
+    std::string_view name;
+    T value;
+};
+
+// Minimal perfect hash table from the names of enum constants and flag bits to their values, generated by
+// json_parse_generator.py. The names are split into buckets by the upper half of their hash, and the generator picks a
+// displacement for each bucket that moves all of its names into slots not taken by other buckets, so a lookup is one hash,
+// one slot computation and one string comparison. The tables are constant initialized, they need no allocation or static
+// initialization at runtime.
+template <typename T, size_t BucketCount, size_t EntryCount>
+struct NameTable {
+    uint32_t displacements[BucketCount];
+    NameTableEntry<T> entries[EntryCount];
+
+    // Returns the entry of <name>, or nullptr if <name> is not in the table
+    const NameTableEntry<T>* Find(std::string_view name) const {
+        const uint64_t hash = HashName(name);
+        const NameTableEntry<T>& entry = entries[NameTableSlot(hash, displacements[(hash >> 32) % BucketCount], EntryCount)];
+        return entry.name == name ? &entry : nullptr;
+    }
+};
+
+}  // namespace pcjson
@@ -8,18 +8,37 @@
 #include "vksc_pipeline_json_parse.hpp"
 #include "vksc_pipeline_json.h"
 
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <thread>
 #include <unordered_map>
 #include <string_view>
 #include <string.h>
+#include <system_error>
+#include <vector>
 
 namespace pcjson {
 
+// The parser keeps its JSON reader, the scratch containers used while resolving object names and the output memory
+// blocks across calls, so parsing many pipeline JSONs with the same parser only resets them instead of re-creating them.
 class Parser : private ParserBase {
   public:
+    Parser() : reader_(Json::CharReaderBuilder{}.newCharReader()) {}
+
     void SetAcceptLegacyInvalidInputData(bool enable) { accept_legacy_invalid_input_data_ = enable; }
 
+    void SetStreamingParsing(bool enable) { streaming_parsing_ = enable; }
+
+    void SetThreadCount(uint32_t thread_count) { thread_count_ = thread_count; }
+
     bool ParsePipelineJson(const char* pPipelineJson, VpjData* pPipelineData, const char** ppMessages) {
+        return ParsePipelineJson(pPipelineJson, pPipelineJson != nullptr ? strlen(pPipelineJson) : 0, pPipelineData, ppMessages);
+    }
+
+    bool ParsePipelineJson(const char* pPipelineJson, size_t pipelineJsonSize, VpjData* pPipelineData, const char** ppMessages) {
         ClearStatusAndMessages();
+        data_ = VpjData{};
 
         if (pPipelineJson == nullptr) {
             Error() << "pPipelineJson is NULL";
@@ -29,30 +48,36 @@ class Parser : private ParserBase {
             Error() << "pPipelineData is NULL";
         }
 
-        Json::Value json{};
-        if (IsStatusOK()) {
-            Json::CharReaderBuilder builder{};
-            std::unique_ptr<Json::CharReader> reader(builder.newCharReader());
-            Json::String json_errors{};
-            if (!reader->parse(pPipelineJson, pPipelineJson + strlen(pPipelineJson), &json, &json_errors)) {
-                Error() << "Failed to parse pipeline JSON:" << std::endl << json_errors;
+        if (streaming_parsing_) {
+            if (accept_legacy_invalid_input_data_) {
+                RelaxLegacyInvalidInputData();
             }
-        }
 
-        if (accept_legacy_invalid_input_data_) {
-            PatchLegacyInvalidInputData(json);
-        }
+            if (IsStatusOK()) {
+                StreamPipelineJson(pPipelineJson, pipelineJsonSize);
+            }
+        } else {
+            Json::Value& json = json_;
+            json = Json::Value{};
+            if (IsStatusOK()) {
+                ParseJson(pPipelineJson, pipelineJsonSize, "Failed to parse pipeline JSON:");
+            }
 
-        if (IsStatusOK()) {
-            parse_PipelineUUID(json);
-            parse_EnabledExtensions(json);
+            if (accept_legacy_invalid_input_data_) {
+                PatchLegacyInvalidInputData(json);
+            }
 
-            if (json.isMember("GraphicsPipelineState")) {
-                parse_GraphicsPipelineState(json["GraphicsPipelineState"]);
-            } else if (json.isMember("ComputePipelineState")) {
-                parse_ComputePipelineState(json["ComputePipelineState"]);
-            } else {
-                Error() << "Unknown pipeline type (no GraphicsPipelineState or ComputePipelineState is found)";
+            if (IsStatusOK()) {
+                parse_PipelineUUID(json);
+                parse_EnabledExtensions(json);
+
+                if (json.isMember("GraphicsPipelineState")) {
+                    parse_GraphicsPipelineState(json["GraphicsPipelineState"]);
+                } else if (json.isMember("ComputePipelineState")) {
+                    parse_ComputePipelineState(json["ComputePipelineState"]);
+                } else {
+                    Error() << "Unknown pipeline type (no GraphicsPipelineState or ComputePipelineState is found)";
+                }
             }
         }
 
@@ -78,74 +103,28 @@ class Parser : private ParserBase {
             Error() << "pStruct is NULL";
         }
 
-        Json::Value json{};
-        if (IsStatusOK()) {
-            Json::CharReaderBuilder builder{};
-            std::unique_ptr<Json::CharReader> reader(builder.newCharReader());
-            Json::String json_errors{};
-            if (!reader->parse(pJson, pJson + strlen(pJson), &json, &json_errors)) {
-                Error() << "Failed to parse JSON:" << std::endl << json_errors;
+        if (streaming_parsing_) {
+            if (IsStatusOK()) {
+                StreamSingleStructJson(pJson, pStruct);
+            }
+        } else {
+            Json::Value& json = json_;
+            json = Json::Value{};
+            if (IsStatusOK()) {
+                ParseJson(pJson, strlen(pJson), "Failed to parse JSON:");
             }
-        }
 
-        VkStructureType stype{};
-        if (IsStatusOK()) {
-            if (json.isMember("sType")) {
-                stype = parse_VkStructureType(json["sType"], CreateScope("$.sType"));
-            } else {
-                Error() << "Missing sType from JSON";
+            VkStructureType stype{};
+            if (IsStatusOK()) {
+                if (json.isMember("sType")) {
+                    stype = parse_VkStructureType(json["sType"], CreateScope("$.sType"));
+                } else {
+                    Error() << "Missing sType from JSON";
+                }
             }
-        }
 
-        if (IsStatusOK()) {
-            switch (stype) {
-                case VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO:
-                    *reinterpret_cast<VkGraphicsPipelineCreateInfo*>(pStruct) =
-                        parse_VkGraphicsPipelineCreateInfo(json, CreateScope("$"));
-                    break;
-                case VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO:
-                    *reinterpret_cast<VkComputePipelineCreateInfo*>(pStruct) =
-                        parse_VkComputePipelineCreateInfo(json, CreateScope("$"));
-                    break;
-                case VK_STRUCTURE_TYPE_SAMPLER_YCBCR_CONVERSION_CREATE_INFO:
-                    *reinterpret_cast<VkSamplerYcbcrConversionCreateInfo*>(pStruct) =
-                        parse_VkSamplerYcbcrConversionCreateInfo(json, CreateScope("$"));
-                    break;
-                case VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO:
-                    *reinterpret_cast<VkSamplerCreateInfo*>(pStruct) = parse_VkSamplerCreateInfo(json, CreateScope("$"));
-                    break;
-                case VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO:
-                    *reinterpret_cast<VkDescriptorSetLayoutCreateInfo*>(pStruct) =
-                        parse_VkDescriptorSetLayoutCreateInfo(json, CreateScope("$"));
-                    break;
-                case VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO:
-                    *reinterpret_cast<VkPipelineLayoutCreateInfo*>(pStruct) =
-                        parse_VkPipelineLayoutCreateInfo(json, CreateScope("$"));
-                    break;
-                case VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2:
-                    *reinterpret_cast<VkPhysicalDeviceFeatures2*>(pStruct) =
-                        parse_VkPhysicalDeviceFeatures2(json, CreateScope("$"));
-                    break;
-                case VK_STRUCTURE_TYPE_RENDER_PASS_CREATE_INFO:
-                    *reinterpret_cast<VkRenderPassCreateInfo*>(pStruct) = parse_VkRenderPassCreateInfo(json, CreateScope("$"));
-                    break;
-                case VK_STRUCTURE_TYPE_RENDER_PASS_CREATE_INFO_2:
-                    *reinterpret_cast<VkRenderPassCreateInfo2*>(pStruct) = parse_VkRenderPassCreateInfo2(json, CreateScope("$"));
-                    break;
-                case VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO:
-                    *reinterpret_cast<VkShaderModuleCreateInfo*>(pStruct) = parse_VkShaderModuleCreateInfo(json, CreateScope("$"));
-                    break;
-                case VK_STRUCTURE_TYPE_DEVICE_OBJECT_RESERVATION_CREATE_INFO:
-                    *reinterpret_cast<VkDeviceObjectReservationCreateInfo*>(pStruct) =
-                        parse_VkDeviceObjectReservationCreateInfo(json, CreateScope("$"));
-                    break;
-                case VK_STRUCTURE_TYPE_PIPELINE_OFFLINE_CREATE_INFO:
-                    *reinterpret_cast<VkPipelineOfflineCreateInfo*>(pStruct) =
-                        parse_VkPipelineOfflineCreateInfo(json, CreateScope("$"));
-                    break;
-                default:
-                    Error() << "Unsupported structure type: " << stype;
-                    break;
+            if (IsStatusOK()) {
+                parse_SingleStruct(json, stype, pStruct);
             }
         }
 
@@ -156,13 +135,502 @@ class Parser : private ParserBase {
         return IsStatusOK();
     }
 
-    void FreeOutputs() { FreeAllMem(); }
+    // Parses <count> pipeline JSONs on up to thread_count_ threads. Each thread parses with its own worker parser, which has
+    // the same configuration as this one, and the outputs (including copies of the messages) are stored in the output
+    // memory of the worker, so they stay valid until FreeOutputs is called on this parser.
+    bool ParsePipelineJsonBatch(uint32_t count, const char* const* ppPipelineJsons, const size_t* pPipelineJsonSizes,
+                                VpjData* pPipelineData, bool* pResults, const char** ppMessages) {
+        if (count > 0 && (ppPipelineJsons == nullptr || pPipelineData == nullptr)) {
+            return false;
+        }
+
+        const uint32_t thread_count =
+            std::min(std::max(thread_count_ != 0 ? thread_count_ : std::thread::hardware_concurrency(), 1u), count);
+        while (workers_.size() < thread_count) {
+            workers_.push_back(std::make_unique<Parser>());
+        }
+
+        // The pipeline JSONs are handed out one at a time so that workers stay busy regardless of the size distribution
+        std::atomic<uint32_t> next_index{0};
+        std::atomic<bool> all_succeeded{true};
+        auto worker = [&](Parser& parser) {
+            parser.accept_legacy_invalid_input_data_ = accept_legacy_invalid_input_data_;
+            parser.streaming_parsing_ = streaming_parsing_;
+            for (uint32_t i = next_index++; i < count; i = next_index++) {
+                const char* json = ppPipelineJsons[i];
+                const size_t size = pPipelineJsonSizes != nullptr ? pPipelineJsonSizes[i] : (json != nullptr ? strlen(json) : 0);
+                const char* messages = nullptr;
+                const bool result = parser.ParsePipelineJson(json, size, &pPipelineData[i], &messages);
+                if (!result) {
+                    all_succeeded = false;
+                }
+                if (pResults != nullptr) {
+                    pResults[i] = result;
+                }
+                if (ppMessages != nullptr) {
+                    ppMessages[i] = messages != nullptr ? parser.alloc_and_copy_name(messages) : nullptr;
+                }
+            }
+        };
+        std::vector<std::thread> threads;
+        threads.reserve(thread_count > 0 ? thread_count - 1 : 0);
+        for (uint32_t t = 1; t < thread_count; ++t) {
+            try {
+                threads.emplace_back(worker, std::ref(*workers_[t]));
+            } catch (const std::system_error&) {
+                // The threads started so far and the calling thread take over the rest of the pipeline JSONs
+                break;
+            }
+        }
+        if (thread_count > 0) {
+            worker(*workers_[0]);
+        }
+        for (std::thread& thread : threads) {
+            thread.join();
+        }
+
+        return all_succeeded;
+    }
+
+    void FreeOutputs() {
+        FreeAllMem();
+        for (auto& worker : workers_) {
+            worker->FreeOutputs();
+        }
+    }
 
     VpjParser Handle() { return reinterpret_cast<VpjParser>(this); }
 
     static Parser* FromHandle(VpjParser handle) { return reinterpret_cast<Parser*>(handle); }
 
   private:
+    // Parses the <size> bytes at <pJson> into json_ with the reader kept by the parser, the input does not need to be
+    // null-terminated
+    void ParseJson(const char* pJson, size_t size, const char* error_message) {
+        json_errors_.clear();
+        if (!reader_->parse(pJson, pJson + size, &json_, &json_errors_)) {
+            Error() << error_message << std::endl << json_errors_;
+        }
+    }
+
+    // Parses the structure of <stype> from <json> into <pStruct>, <json> is either a Json::Value or a JsonTokenizer at the
+    // start of the structure
+    template <typename Value>
+    void parse_SingleStruct(Value& json, VkStructureType stype, void* pStruct) {
+        switch (stype) {
+            case VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO:
+                *reinterpret_cast<VkGraphicsPipelineCreateInfo*>(pStruct) =
+                    parse_VkGraphicsPipelineCreateInfo(json, CreateScope("$"));
+                break;
+            case VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO:
+                *reinterpret_cast<VkComputePipelineCreateInfo*>(pStruct) =
+                    parse_VkComputePipelineCreateInfo(json, CreateScope("$"));
+                break;
+            case VK_STRUCTURE_TYPE_SAMPLER_YCBCR_CONVERSION_CREATE_INFO:
+                *reinterpret_cast<VkSamplerYcbcrConversionCreateInfo*>(pStruct) =
+                    parse_VkSamplerYcbcrConversionCreateInfo(json, CreateScope("$"));
+                break;
+            case VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO:
+                *reinterpret_cast<VkSamplerCreateInfo*>(pStruct) = parse_VkSamplerCreateInfo(json, CreateScope("$"));
+                break;
+            case VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO:
+                *reinterpret_cast<VkDescriptorSetLayoutCreateInfo*>(pStruct) =
+                    parse_VkDescriptorSetLayoutCreateInfo(json, CreateScope("$"));
+                break;
+            case VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO:
+                *reinterpret_cast<VkPipelineLayoutCreateInfo*>(pStruct) = parse_VkPipelineLayoutCreateInfo(json, CreateScope("$"));
+                break;
+            case VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2:
+                *reinterpret_cast<VkPhysicalDeviceFeatures2*>(pStruct) = parse_VkPhysicalDeviceFeatures2(json, CreateScope("$"));
+                break;
+            case VK_STRUCTURE_TYPE_RENDER_PASS_CREATE_INFO:
+                *reinterpret_cast<VkRenderPassCreateInfo*>(pStruct) = parse_VkRenderPassCreateInfo(json, CreateScope("$"));
+                break;
+            case VK_STRUCTURE_TYPE_RENDER_PASS_CREATE_INFO_2:
+                *reinterpret_cast<VkRenderPassCreateInfo2*>(pStruct) = parse_VkRenderPassCreateInfo2(json, CreateScope("$"));
+                break;
+            case VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO:
+                *reinterpret_cast<VkShaderModuleCreateInfo*>(pStruct) = parse_VkShaderModuleCreateInfo(json, CreateScope("$"));
+                break;
+            case VK_STRUCTURE_TYPE_DEVICE_OBJECT_RESERVATION_CREATE_INFO:
+                *reinterpret_cast<VkDeviceObjectReservationCreateInfo*>(pStruct) =
+                    parse_VkDeviceObjectReservationCreateInfo(json, CreateScope("$"));
+                break;
+            case VK_STRUCTURE_TYPE_PIPELINE_OFFLINE_CREATE_INFO:
+                *reinterpret_cast<VkPipelineOfflineCreateInfo*>(pStruct) =
+                    parse_VkPipelineOfflineCreateInfo(json, CreateScope("$"));
+                break;
+            default:
+                Error() << "Unsupported structure type: " << stype;
+                break;
+        }
+    }
+
+    // Object sections of the pipeline states, in the order in which they refer to the names of the previous one
+    enum ObjectSection : uint32_t {
+        kYcbcrSamplers,
+        kImmutableSamplers,
+        kDescriptorSetLayouts,
+        kPipelineLayout,
+        kObjectSectionCount,
+    };
+
+    // Parses the <size> bytes at <pJson> in a single pass with the tokenizer kept by the parser, directly into data_,
+    // without building a Json::Value document first. The input does not need to be null-terminated.
+    void StreamPipelineJson(const char* pJson, size_t size) {
+        JsonTokenizer& json = tokenizer_;
+        json.Reset(pJson, size);
+
+        bool has_pipeline_uuid = false;
+        bool has_graphics_pipeline_state = false;
+        bool has_compute_pipeline_state = false;
+        if (json.BeginObject()) {
+            std::string_view key;
+            while (json.NextMember(key)) {
+                if (key == "PipelineUUID") {
+                    has_pipeline_uuid = true;
+                    stream_PipelineUUID(json);
+                } else if (key == "EnabledExtensions") {
+                    stream_EnabledExtensions(json);
+                } else if (key == "GraphicsPipelineState") {
+                    // Takes precedence over a ComputePipelineState that came earlier
+                    has_graphics_pipeline_state = true;
+                    data_.graphicsPipelineState = VpjGraphicsPipelineState{};
+                    stream_GraphicsPipelineState(json);
+                } else if (key == "ComputePipelineState" && !has_graphics_pipeline_state) {
+                    has_compute_pipeline_state = true;
+                    stream_ComputePipelineState(json);
+                } else {
+                    json.Skip();
+                }
+            }
+        } else {
+            json.Skip();
+        }
+
+        if (json.HasError()) {
+            // Report only the syntax error, like the Json::Value based parsing does
+            ClearStatusAndMessages();
+            Error() << "Failed to parse pipeline JSON:" << std::endl << json.GetError();
+            return;
+        }
+
+        if (!has_pipeline_uuid) {
+            Warn() << "No PipelineUUID";
+        }
+
+        if (!has_graphics_pipeline_state && !has_compute_pipeline_state) {
+            Error() << "Unknown pipeline type (no GraphicsPipelineState or ComputePipelineState is found)";
+        }
+    }
+
+    void StreamSingleStructJson(const char* pJson, void* pStruct) {
+        JsonTokenizer& json = tokenizer_;
+        json.Reset(pJson, strlen(pJson));
+
+        const size_t stype_position = json.FindMember("sType");
+        VkStructureType stype{};
+        if (stype_position != JsonTokenizer::kNoPosition) {
+            stype = parse_VkStructureType(json.ReadScalarAt(stype_position), CreateScope("$.sType"));
+        } else if (!json.HasError()) {
+            Error() << "Missing sType from JSON";
+        }
+
+        if (IsStatusOK() && !json.HasError()) {
+            parse_SingleStruct(json, stype, pStruct);
+        }
+
+        if (json.HasError()) {
+            ClearStatusAndMessages();
+            Error() << "Failed to parse JSON:" << std::endl << json.GetError();
+        }
+    }
+
+    void stream_GraphicsPipelineState(JsonTokenizer& json) {
+        if (!json.BeginObject()) {
+            json.Skip();
+            Error() << "Invalid GraphicsPipelineState format";
+            return;
+        }
+
+        auto& state = data_.graphicsPipelineState;
+        auto graphics_pipeline_state_loc = CreateScope("$.GraphicsPipelineState");
+        bool has_pipeline = false;
+        bool has_renderpass = false;
+        size_t renderpass2_position = JsonTokenizer::kNoPosition;
+        stream_CommonPipelineState(json, state, [&](std::string_view key) {
+            if (key == "GraphicsPipeline") {
+                has_pipeline = true;
+                auto graphics_pipeline = AllocMem<VkGraphicsPipelineCreateInfo>();
+                state.pGraphicsPipeline = graphics_pipeline;
+                *graphics_pipeline = parse_VkGraphicsPipelineCreateInfo(json, CreateScope("GraphicsPipeline"));
+            } else if (key == "Renderpass") {
+                has_renderpass = true;
+                auto renderpass = AllocMem<VkRenderPassCreateInfo>();
+                state.pRenderPass = renderpass;
+                *renderpass = parse_VkRenderPassCreateInfo(json, CreateScope("Renderpass"));
+            } else if (key == "Renderpass2") {
+                // Only used if there is no Renderpass, which may still come later
+                renderpass2_position = json.Tell();
+                json.Skip();
+            } else {
+                return false;
+            }
+            return true;
+        });
+
+        if (!has_pipeline) {
+            Error() << "Missing GraphicsPipeline";
+        }
+
+        if (!has_renderpass && renderpass2_position != JsonTokenizer::kNoPosition) {
+            const size_t end = json.Tell();
+            json.Seek(renderpass2_position);
+            auto renderpass2 = AllocMem<VkRenderPassCreateInfo2>();
+            state.pRenderPass = renderpass2;
+            *renderpass2 = parse_VkRenderPassCreateInfo2(json, CreateScope("Renderpass2"));
+            json.Seek(end);
+        } else if (!has_renderpass) {
+            Error() << "Missing both Renderpass and Renderpass2";
+        }
+    }
+
+    void stream_ComputePipelineState(JsonTokenizer& json) {
+        if (!json.BeginObject()) {
+            json.Skip();
+            Error() << "Invalid ComputePipelineState format";
+            return;
+        }
+
+        auto& state = data_.computePipelineState;
+        auto compute_pipeline_state_loc = CreateScope("$.ComputePipelineState");
+        bool has_pipeline = false;
+        stream_CommonPipelineState(json, state, [&](std::string_view key) {
+            if (key == "ComputePipeline") {
+                has_pipeline = true;
+                auto compute_pipeline = AllocMem<VkComputePipelineCreateInfo>();
+                state.pComputePipeline = compute_pipeline;
+                *compute_pipeline = parse_VkComputePipelineCreateInfo(json, CreateScope("ComputePipeline"));
+                return true;
+            }
+            return false;
+        });
+
+        if (!has_pipeline) {
+            Error() << "Missing ComputePipeline";
+        }
+    }
+
+    // Parses the members of the pipeline state object the tokenizer is in, passing the keys of the members specific to
+    // the pipeline type to <parse_member>, which returns false for unknown ones. Object names are resolved to indices
+    // like ResolveObjectNames does, so an object section referring to the names of a section that has not been parsed
+    // yet is only parsed after all the other members.
+    template <typename T, typename ParseMember>
+    void stream_CommonPipelineState(JsonTokenizer& json, T& state, ParseMember&& parse_member) {
+        static constexpr std::string_view section_names[kObjectSectionCount] = {
+            "YcbcrSamplers",
+            "ImmutableSamplers",
+            "DescriptorSetLayouts",
+            "PipelineLayout",
+        };
+        size_t section_positions[kObjectSectionCount];
+        std::fill(std::begin(section_positions), std::end(section_positions), JsonTokenizer::kNoPosition);
+        bool sections_parsed[kObjectSectionCount] = {};
+
+        // The names refer to output memory allocated during this call, so the maps are only valid within it
+        ycbcr_sampler_indices_.clear();
+        immutable_sampler_indices_.clear();
+        ds_layout_indices_.clear();
+
+        bool has_shader_file_names = false;
+        std::string_view key;
+        while (json.NextMember(key)) {
+            const auto section = static_cast<uint32_t>(std::find(std::begin(section_names), std::end(section_names), key) -
+                                                       std::begin(section_names));
+            if (section < kObjectSectionCount) {
+                if (section == kYcbcrSamplers || sections_parsed[section - 1]) {
+                    stream_ObjectSection(json, state, section);
+                    sections_parsed[section] = true;
+                } else {
+                    section_positions[section] = json.Tell();
+                    json.Skip();
+                }
+            } else if (key == "ShaderFileNames") {
+                has_shader_file_names = true;
+                stream_ShaderFileNames(json, state);
+            } else if (key == "PhysicalDeviceFeatures") {
+                auto feature = AllocMem<VkPhysicalDeviceFeatures2>();
+                state.pPhysicalDeviceFeatures = feature;
+                if (accept_legacy_invalid_input_data_) {
+                    *feature = parse_filtered_VkPhysicalDeviceFeatures2(json, CreateScope("PhysicalDeviceFeatures"));
+                } else {
+                    *feature = parse_VkPhysicalDeviceFeatures2(json, CreateScope("PhysicalDeviceFeatures"));
+                }
+            } else if (!parse_member(key)) {
+                json.Skip();
+            }
+        }
+
+        const size_t end = json.Tell();
+        for (uint32_t section = 0; section < kObjectSectionCount; ++section) {
+            if (!sections_parsed[section] && section_positions[section] != JsonTokenizer::kNoPosition) {
+                json.Seek(section_positions[section]);
+                stream_ObjectSection(json, state, section);
+                sections_parsed[section] = true;
+            }
+        }
+        json.Seek(end);
+
+        if (!sections_parsed[kPipelineLayout]) {
+            Error() << "Missing PipelineLayout";
+        }
+
+        if (!has_shader_file_names) {
+            Error() << "Missing ShaderFileNames";
+        }
+    }
+
+    template <typename T>
+    void stream_ObjectSection(JsonTokenizer& json, T& state, uint32_t section) {
+        switch (section) {
+            case kYcbcrSamplers:
+                stream_NamedObjects<VkSamplerYcbcrConversionCreateInfo>(
+                    json, "YcbcrSamplers", state.ycbcrSamplerCount, state.pYcbcrSamplers, state.ppYcbcrSamplerNames,
+                    ycbcr_sampler_indices_,
+                    [&](const LocationScope& l) { return parse_VkSamplerYcbcrConversionCreateInfo(json, l); });
+                break;
+            case kImmutableSamplers:
+                json.SetHandleNames(VK_OBJECT_TYPE_SAMPLER_YCBCR_CONVERSION, &ycbcr_sampler_indices_);
+                stream_NamedObjects<VkSamplerCreateInfo>(
+                    json, "ImmutableSamplers", state.immutableSamplerCount, state.pImmutableSamplers, state.ppImmutableSamplerNames,
+                    immutable_sampler_indices_, [&](const LocationScope& l) { return parse_VkSamplerCreateInfo(json, l); });
+                break;
+            case kDescriptorSetLayouts:
+                json.SetHandleNames(VK_OBJECT_TYPE_SAMPLER, &immutable_sampler_indices_);
+                stream_NamedObjects<VkDescriptorSetLayoutCreateInfo>(
+                    json, "DescriptorSetLayouts", state.descriptorSetLayoutCount, state.pDescriptorSetLayouts,
+                    state.ppDescriptorSetLayoutNames, ds_layout_indices_,
+                    [&](const LocationScope& l) { return parse_VkDescriptorSetLayoutCreateInfo(json, l); });
+                break;
+            case kPipelineLayout: {
+                json.SetHandleNames(VK_OBJECT_TYPE_DESCRIPTOR_SET_LAYOUT, &ds_layout_indices_);
+                auto pipeline_layout = AllocMem<VkPipelineLayoutCreateInfo>();
+                state.pPipelineLayout = pipeline_layout;
+                *pipeline_layout = parse_VkPipelineLayoutCreateInfo(json, CreateScope("PipelineLayout"));
+                break;
+            }
+            default:
+                json.Skip();
+                break;
+        }
+        json.SetHandleNames(VK_OBJECT_TYPE_UNKNOWN, nullptr);
+    }
+
+    // Parses an array of objects each having a single member, named after the object it creates, into <count>
+    // structures of type S parsed by <parse> and the names, remembering which index each name is at in <indices>
+    template <typename S, typename Parse>
+    void stream_NamedObjects(JsonTokenizer& json, const char* section, uint32_t& count, const void*& p_structs,
+                             const char**& pp_names, JsonTokenizer::HandleNames& indices, Parse&& parse) {
+        const uint32_t size = json.PeekArraySize();
+        if (!json.BeginArray()) {
+            json.Skip();
+            Error() << "Invalid " << section << " format";
+            return;
+        }
+
+        auto structs = AllocMem<S>(size);
+        auto names = AllocMem<const char*>(size);
+        count = size;
+        p_structs = structs;
+        pp_names = names;
+        for (uint32_t i = 0; json.NextElement(); ++i) {
+            std::string_view name;
+            if (i >= size || !json.BeginObject()) {
+                json.Skip();
+                Error() << "Invalid " << section << " format";
+            } else if (json.NextMember(name)) {
+                names[i] = alloc_and_copy_name(name);  // Remember object name
+                indices[names[i]] = i;                 // Remember which index the name is at
+                structs[i] = parse(CreateScope(section, i));
+                while (json.NextMember(name)) {
+                    json.Skip();
+                }
+            } else {
+                Error() << "Invalid " << section << " format";
+            }
+        }
+    }
+
+    template <typename T>
+    void stream_ShaderFileNames(JsonTokenizer& json, T& state) {
+        static constexpr JsonMember members[] = {
+            {"stage"},
+            {"filename"},
+        };
+        const uint32_t size = json.PeekArraySize();
+        if (!json.BeginArray()) {
+            json.Skip();
+            Error() << "Invalid ShaderFileNames format";
+            return;
+        }
+
+        state.shaderFileNameCount = size;
+        auto shaders = AllocMem<VpjShaderFileName>(size);
+        state.pShaderFileNames = shaders;
+        for (uint32_t i = 0; json.NextElement(); ++i) {
+            if (i >= size) {
+                json.Skip();
+                continue;
+            }
+            auto shader_loc = CreateScope("ShaderFileNames", i);
+            shaders[i] = VpjShaderFileName{};
+            auto parse_member = [&](uint32_t member) {
+                if (member == 0) {
+                    shaders[i].stage = parse_VkShaderStageFlagBits(json.ReadScalar(), CreateScope("stage"));
+                } else {
+                    shaders[i].pFilename = parse_string(json.ReadScalar(), CreateScope("filename"));
+                }
+            };
+            if (!json.ParseObject(members, parse_member)) {
+                Error() << "Invalid format";
+            }
+        }
+    }
+
+    void stream_PipelineUUID(JsonTokenizer& json) {
+        if (json.PeekArraySize() == 16 && json.BeginArray()) {
+            for (uint32_t i = 0; json.NextElement(); ++i) {
+                const auto json_uuid_byte = json.ReadScalar();
+                if (i < 16 && json_uuid_byte.isIntegral()) {
+                    data_.pipelineUUID[i] = parse_uint8_t(json_uuid_byte, CreateScope("$.PipelineUUID", i));
+                } else {
+                    Error() << "Invalid PipelineUUID format";
+                }
+            }
+        } else {
+            json.Skip();
+            Error() << "Invalid PipelineUUID format";
+        }
+    }
+
+    void stream_EnabledExtensions(JsonTokenizer& json) {
+        const uint32_t size = json.PeekArraySize();
+        if (!json.BeginArray()) {
+            json.Skip();
+            Error() << "Invalid EnabledExtensions format";
+            return;
+        }
+
+        data_.enabledExtensionCount = size;
+        data_.ppEnabledExtensions = AllocMem<const char*>(size);
+        for (uint32_t i = 0; json.NextElement(); ++i) {
+            const auto json_ext = json.ReadScalar();
+            if (i < size) {
+                data_.ppEnabledExtensions[i] = parse_string(json_ext, CreateScope("$.EnabledExtensions", i));
+            }
+        }
+    }
+
     template <typename T>
     void parse_CommonPipelineState(Json::Value& json, T& state) {
         if (json.isMember("YcbcrSamplers")) {
@@ -249,16 +717,13 @@ class Parser : private ParserBase {
 
     template <typename T>
     void ResolveObjectNames(Json::Value& json, T& state) {
-        std::unordered_map<std::string_view, uint32_t> ycbcr_sampler_indices{};
-        std::unordered_map<std::string_view, uint32_t> immutable_sampler_indices{};
-        std::unordered_map<std::string_view, uint32_t> ds_layout_indices{};
-
-        auto alloc_and_copy_name = [&](const std::string_view& src) {
-            auto dst = AllocMem<char>(src.length() + 1);  // null-terminator
-            std::copy(src.begin(), src.end(), dst);
-            dst[src.length()] = '\0';
-            return dst;
-        };
+        // The names refer to output memory allocated during this call, so the maps are only valid within it
+        auto& ycbcr_sampler_indices = ycbcr_sampler_indices_;
+        auto& immutable_sampler_indices = immutable_sampler_indices_;
+        auto& ds_layout_indices = ds_layout_indices_;
+        ycbcr_sampler_indices.clear();
+        immutable_sampler_indices.clear();
+        ds_layout_indices.clear();
 
         if (json.isMember("YcbcrSamplers")) {
             const auto& json_ycbcr_samplers = json["YcbcrSamplers"];
@@ -455,6 +920,13 @@ class Parser : private ParserBase {
         }
     }
 
+    const char* alloc_and_copy_name(const std::string_view& src) {
+        auto dst = AllocMem<char>(src.length() + 1);  // null-terminator
+        std::copy(src.begin(), src.end(), dst);
+        dst[src.length()] = '\0';
+        return dst;
+    }
+
     Json::Value* find_StructInChain(Json::Value* json, const char* sType) {
         while (json->isObject()) {
             if ((*json)["sType"].asString() == sType) {
@@ -487,6 +959,10 @@ class Parser : private ParserBase {
             }
         }
 
+        RelaxLegacyInvalidInputData();
+    }
+
+    void RelaxLegacyInvalidInputData() {
         // Issue #2
         // The legacy generator will incorrectly include Vulkan-only stage flags that do not exist in Vulkan SC.
         // This is handled by enabling relaxed enum matching, making related errors only warnings.
@@ -501,6 +977,20 @@ class Parser : private ParserBase {
     VpjData data_;
 
     bool accept_legacy_invalid_input_data_{false};
+    bool streaming_parsing_{false};
+
+    // State reused across calls
+    std::unique_ptr<Json::CharReader> reader_;
+    Json::Value json_{};
+    Json::String json_errors_{};
+    std::unordered_map<std::string_view, uint32_t> ycbcr_sampler_indices_{};
+    std::unordered_map<std::string_view, uint32_t> immutable_sampler_indices_{};
+    std::unordered_map<std::string_view, uint32_t> ds_layout_indices_{};
+    JsonTokenizer tokenizer_{};
+
+    // Used by ParsePipelineJsonBatch, 0 means one thread per hardware thread
+    uint32_t thread_count_{0};
+    std::vector<std::unique_ptr<Parser>> workers_{};
 };
 
 }  // namespace pcjson
@@ -513,14 +1003,31 @@ void vpjSetAcceptLegacyInvalidInputData(VpjParser parser, bool enable) {
     pcjson::Parser::FromHandle(parser)->SetAcceptLegacyInvalidInputData(enable);
 }
 
+void vpjSetStreamingParsing(VpjParser parser, bool enable) { pcjson::Parser::FromHandle(parser)->SetStreamingParsing(enable); }
+
 bool vpjParsePipelineJson(VpjParser parser, const char* pPipelineJson, VpjData* pPipelineData, const char** ppMessages) {
     return pcjson::Parser::FromHandle(parser)->ParsePipelineJson(pPipelineJson, pPipelineData, ppMessages);
 }
 
+bool vpjParsePipelineJsonWithSize(VpjParser parser, const char* pPipelineJson, size_t pipelineJsonSize, VpjData* pPipelineData,
+                                  const char** ppMessages) {
+    return pcjson::Parser::FromHandle(parser)->ParsePipelineJson(pPipelineJson, pipelineJsonSize, pPipelineData, ppMessages);
+}
+
 bool vpjParseSingleStructJson(VpjParser parser, const char* pJson, void* pStruct, const char** ppMessages) {
     return pcjson::Parser::FromHandle(parser)->ParseSingleStructJson(pJson, pStruct, ppMessages);
 }
 
+void vpjSetParserThreadCount(VpjParser parser, uint32_t threadCount) {
+    pcjson::Parser::FromHandle(parser)->SetThreadCount(threadCount);
+}
+
+bool vpjParsePipelineJsonBatch(VpjParser parser, uint32_t pipelineJsonCount, const char* const* ppPipelineJsons,
+                               const size_t* pPipelineJsonSizes, VpjData* pPipelineData, bool* pResults, const char** ppMessages) {
+    return pcjson::Parser::FromHandle(parser)->ParsePipelineJsonBatch(pipelineJsonCount, ppPipelineJsons, pPipelineJsonSizes,
+                                                                      pPipelineData, pResults, ppMessages);
+}
+
 void vpjFreeParserOutputs(VpjParser parser) { pcjson::Parser::FromHandle(parser)->FreeOutputs(); }
 
 void vpjDestroyParser(VpjParser parser) { delete pcjson::Parser::FromHandle(parser); }
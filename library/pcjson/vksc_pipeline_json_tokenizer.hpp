@@ -0,0 +1,871 @@
+/*
+ * Copyright (c) 2025 The Khronos Group Inc.
+ * Copyright (c) 2025 RasterGrid Kft.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <vulkan/vulkan.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iterator>
+#include <limits>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace pcjson {
+
+// A scalar value read by JsonTokenizer. It provides the subset of the Json::Value interface used by the generated parse
+// methods, with the same type checks and conversions, so that those can take either. The string of a string value is only
+// valid until the next value is read from the tokenizer.
+class JsonScalar {
+  public:
+    enum class Type { kNull, kBoolean, kInt, kUInt, kReal, kString, kArray, kObject };
+
+    JsonScalar() = default;
+    explicit JsonScalar(Type type) : type_(type) {}
+
+    static JsonScalar Boolean(bool value) {
+        JsonScalar s(Type::kBoolean);
+        s.bool_ = value;
+        return s;
+    }
+    static JsonScalar Int(int64_t value) {
+        JsonScalar s(Type::kInt);
+        s.int_ = value;
+        return s;
+    }
+    static JsonScalar UInt(uint64_t value) {
+        JsonScalar s(Type::kUInt);
+        s.uint_ = value;
+        return s;
+    }
+    static JsonScalar Real(double value) {
+        JsonScalar s(Type::kReal);
+        s.real_ = value;
+        return s;
+    }
+    static JsonScalar String(const char* str, size_t size) {
+        JsonScalar s(Type::kString);
+        s.str_ = str;
+        s.str_size_ = size;
+        return s;
+    }
+
+    bool isNull() const { return type_ == Type::kNull; }
+    bool isBool() const { return type_ == Type::kBoolean; }
+    bool isString() const { return type_ == Type::kString; }
+    bool isArray() const { return type_ == Type::kArray; }
+    bool isObject() const { return type_ == Type::kObject; }
+    bool isDouble() const { return type_ == Type::kInt || type_ == Type::kUInt || type_ == Type::kReal; }
+
+    bool isInt() const {
+        switch (type_) {
+            case Type::kInt:
+                return int_ >= INT32_MIN && int_ <= INT32_MAX;
+            case Type::kUInt:
+                return uint_ <= uint64_t(INT32_MAX);
+            case Type::kReal:
+                return real_ >= INT32_MIN && real_ <= INT32_MAX && IsIntegral(real_);
+            default:
+                return false;
+        }
+    }
+
+    bool isUInt() const {
+        switch (type_) {
+            case Type::kInt:
+                return int_ >= 0 && uint64_t(int_) <= UINT32_MAX;
+            case Type::kUInt:
+                return uint_ <= UINT32_MAX;
+            case Type::kReal:
+                return real_ >= 0 && real_ <= UINT32_MAX && IsIntegral(real_);
+            default:
+                return false;
+        }
+    }
+
+    bool isInt64() const {
+        switch (type_) {
+            case Type::kInt:
+                return true;
+            case Type::kUInt:
+                return uint_ <= uint64_t(INT64_MAX);
+            case Type::kReal:
+                return real_ >= double(INT64_MIN) && real_ < double(INT64_MAX) && IsIntegral(real_);
+            default:
+                return false;
+        }
+    }
+
+    bool isUInt64() const {
+        switch (type_) {
+            case Type::kInt:
+                return int_ >= 0;
+            case Type::kUInt:
+                return true;
+            case Type::kReal:
+                return real_ >= 0 && real_ < kMaxUInt64AsDouble && IsIntegral(real_);
+            default:
+                return false;
+        }
+    }
+
+    bool isIntegral() const {
+        switch (type_) {
+            case Type::kInt:
+            case Type::kUInt:
+                return true;
+            case Type::kReal:
+                return real_ >= double(INT64_MIN) && real_ < kMaxUInt64AsDouble && IsIntegral(real_);
+            default:
+                return false;
+        }
+    }
+
+    int asInt() const { return static_cast<int>(asInt64()); }
+    unsigned int asUInt() const { return static_cast<unsigned int>(asUInt64()); }
+
+    int64_t asInt64() const {
+        switch (type_) {
+            case Type::kInt:
+                return int_;
+            case Type::kUInt:
+                return static_cast<int64_t>(uint_);
+            case Type::kReal:
+                return static_cast<int64_t>(real_);
+            case Type::kBoolean:
+                return bool_ ? 1 : 0;
+            default:
+                return 0;
+        }
+    }
+
+    uint64_t asUInt64() const {
+        switch (type_) {
+            case Type::kInt:
+                return static_cast<uint64_t>(int_);
+            case Type::kUInt:
+                return uint_;
+            case Type::kReal:
+                return static_cast<uint64_t>(real_);
+            case Type::kBoolean:
+                return bool_ ? 1 : 0;
+            default:
+                return 0;
+        }
+    }
+
+    float asFloat() const {
+        switch (type_) {
+            case Type::kInt:
+                return static_cast<float>(int_);
+            case Type::kUInt:
+                return static_cast<float>(uint_);
+            case Type::kReal:
+                return static_cast<float>(real_);
+            case Type::kBoolean:
+                return bool_ ? 1.0f : 0.0f;
+            default:
+                return 0.0f;
+        }
+    }
+
+    const char* asCString() const { return type_ == Type::kString ? str_ : ""; }
+
+    std::string asString() const {
+        switch (type_) {
+            case Type::kString:
+                return std::string(str_, str_size_);
+            case Type::kBoolean:
+                return bool_ ? "true" : "false";
+            case Type::kInt:
+                return std::to_string(int_);
+            case Type::kUInt:
+                return std::to_string(uint_);
+            case Type::kReal: {
+                char buffer[32];
+                snprintf(buffer, sizeof(buffer), "%.17g", real_);
+                return buffer;
+            }
+            default:
+                return "";
+        }
+    }
+
+    bool getString(const char** begin, const char** end) const {
+        if (type_ != Type::kString) {
+            return false;
+        }
+        *begin = str_;
+        *end = str_ + str_size_;
+        return true;
+    }
+
+  private:
+    static constexpr double kMaxUInt64AsDouble = 18446744073709551615.0;
+
+    static bool IsIntegral(double value) {
+        double integral_part;
+        return modf(value, &integral_part) == 0.0;
+    }
+
+    Type type_{Type::kNull};
+    union {
+        bool bool_;
+        int64_t int_;
+        uint64_t uint_;
+        double real_{0.0};
+    };
+    const char* str_{nullptr};
+    size_t str_size_{0};
+};
+
+// A member of a structure parsed with JsonTokenizer::ParseObject, with the index of the member its parsing depends on
+// (e.g. the length of an array), if any
+struct JsonMember {
+    static constexpr uint32_t kNoDependency = UINT32_MAX;
+
+    std::string_view name;
+    uint32_t dependency{kNoDependency};
+};
+
+// Positions of the sType and pNext members of an extensible structure, recorded by JsonTokenizer::ParseObject
+struct JsonStructLinks {
+    size_t stype;
+    size_t next;
+};
+
+// Pull tokenizer used to parse JSON directly into the output structures without building a document tree.
+//
+// Values are consumed one at a time in document order. As the whole input is available, positions can be recorded and
+// returned to later, which is used to handle members that depend on members coming later in the document. The accepted
+// syntax matches the default settings of Json::CharReaderBuilder: comments and trailing commas are allowed, and the
+// input following the root value is ignored.
+//
+// After a syntax error all further reads return null values and empty containers, the error is returned by GetError.
+class JsonTokenizer {
+  public:
+    static constexpr size_t kNoPosition = std::numeric_limits<size_t>::max();
+
+    using HandleNames = std::unordered_map<std::string_view, uint32_t>;
+
+    void Reset(const char* json, size_t size) {
+        begin_ = json;
+        end_ = json + size;
+        pos_ = 0;
+        expect_first_ = false;
+        missing_ = false;
+        error_.clear();
+        skipped_ends_.clear();
+        if (size >= 3 && memcmp(json, "\xEF\xBB\xBF", 3) == 0) {
+            pos_ = 3;
+        }
+    }
+
+    bool HasError() const { return !error_.empty(); }
+    const std::string& GetError() const { return error_; }
+
+    // Object and array traversal: Begin* consumes the opening bracket and returns true if the next value is an object
+    // or array, and consumes nothing otherwise. Next* moves to the next member or element and returns false (consuming
+    // the closing bracket) after the last one. The value of each member or element has to be consumed before moving on.
+    bool BeginObject() { return BeginContainer('{'); }
+    bool BeginArray() { return BeginContainer('['); }
+
+    bool NextMember(std::string_view& key) {
+        if (!NextItem('}')) {
+            return false;
+        }
+        if (Peek() != '"') {
+            return Fail("Missing '}' or object member name");
+        }
+        if (!ReadString(key_scratch_, key)) {
+            return false;
+        }
+        if (Peek() != ':') {
+            return Fail("Missing ':' after object member name");
+        }
+        ++pos_;
+        return true;
+    }
+
+    bool NextElement() { return NextItem(']'); }
+
+    // Consumes the next value, objects and arrays are skipped and returned as a value of the corresponding type
+    JsonScalar ReadScalar() {
+        if (missing_ || HasError()) {
+            missing_ = false;
+            return JsonScalar{};
+        }
+        switch (Peek()) {
+            case '{':
+                Skip();
+                return JsonScalar(JsonScalar::Type::kObject);
+            case '[':
+                Skip();
+                return JsonScalar(JsonScalar::Type::kArray);
+            case '"': {
+                std::string_view str;
+                if (!ReadString(value_scratch_, str)) {
+                    return JsonScalar{};
+                }
+                if (str.data() != value_scratch_.data()) {
+                    value_scratch_.assign(str.data(), str.size());
+                }
+                return JsonScalar::String(value_scratch_.c_str(), value_scratch_.size());
+            }
+            case 't':
+                return ReadLiteral("true") ? JsonScalar::Boolean(true) : JsonScalar{};
+            case 'f':
+                return ReadLiteral("false") ? JsonScalar::Boolean(false) : JsonScalar{};
+            case 'n':
+                ReadLiteral("null");
+                return JsonScalar{};
+            default:
+                return ReadNumber();
+        }
+    }
+
+    // Consumes the next value as the handle of an object of <type>, replacing object names with their indices if names
+    // are set for <type>. Numbers are looked up as names too, by their string form, and values that are not a known name
+    // are returned as null values.
+    JsonScalar ReadHandle(VkObjectType type) {
+        JsonScalar value = ReadScalar();
+        if (handle_names_ == nullptr || type != handle_names_type_) {
+            return value;
+        }
+        HandleNames::const_iterator it = handle_names_->end();
+        if (value.isString()) {
+            it = handle_names_->find(std::string_view(value.asCString()));
+        } else if (!value.isNull() && !value.isArray() && !value.isObject()) {
+            it = handle_names_->find(value.asString());
+        }
+        return it != handle_names_->end() ? JsonScalar::UInt(it->second) : JsonScalar{};
+    }
+
+    void SetHandleNames(VkObjectType type, const HandleNames* names) {
+        handle_names_type_ = type;
+        handle_names_ = names;
+    }
+
+    // Consumes the next value, validating its syntax. The extents of the objects and arrays are remembered until the
+    // next Reset, so skipping them again (e.g. when a member is parsed after the member it depends on, or a nested pNext
+    // chain is skipped by each structure in it) takes constant time.
+    void Skip() {
+        if (missing_ || HasError()) {
+            missing_ = false;
+            return;
+        }
+        const size_t base_depth = skip_stack_.size();
+        do {
+            const char c = Peek();
+            if (c == '{' || c == '[') {
+                if (const auto it = skipped_ends_.find(pos_); it != skipped_ends_.end()) {
+                    pos_ = it->second;
+                    expect_first_ = false;
+                } else {
+                    skip_stack_.push_back(SkippedContainer{pos_, c == '{' ? '}' : ']'});
+                    ++pos_;
+                    expect_first_ = true;
+                }
+            } else if (c == '"') {
+                std::string_view str;
+                ReadString(skip_scratch_, str);
+            } else {
+                ReadScalar();
+            }
+            while (skip_stack_.size() > base_depth && !HasError()) {
+                if (skip_stack_.back().closing_bracket == '}') {
+                    std::string_view key;
+                    if (NextMember(key)) {
+                        break;
+                    }
+                } else if (NextElement()) {
+                    break;
+                }
+                skipped_ends_.emplace(skip_stack_.back().begin, pos_);
+                skip_stack_.pop_back();
+            }
+        } while (skip_stack_.size() > base_depth && !HasError());
+        skip_stack_.resize(base_depth);
+    }
+
+    // return: whether the next value is a string equal to <str>, without consuming it
+    bool PeekString(std::string_view str) {
+        if (missing_ || Peek() != '"') {
+            return false;
+        }
+        const char* raw = begin_ + pos_ + 1;
+        if (static_cast<size_t>(end_ - raw) > str.size() && memcmp(raw, str.data(), str.size()) == 0 && raw[str.size()] == '"') {
+            return true;
+        }
+        if (memchr(raw, '\\', std::min(static_cast<size_t>(end_ - raw), str.size() * 6 + 1)) == nullptr) {
+            return false;
+        }
+        const State state = SaveState();
+        const JsonScalar value = ReadScalar();
+        const bool equal = value.isString() && std::string_view(value.asCString()) == str;
+        RestoreState(state);
+        return equal;
+    }
+
+    // return: the position of the next value
+    size_t Tell() const { return pos_; }
+
+    // Continues at <position> (the next value is missing and is read as null if it is kNoPosition)
+    void Seek(size_t position) {
+        if (position == kNoPosition) {
+            missing_ = true;
+        } else {
+            pos_ = position;
+            missing_ = false;
+        }
+    }
+
+    // return: the value at <position> (null if it is kNoPosition), without changing the current position
+    JsonScalar ReadScalarAt(size_t position) {
+        const State state = SaveState();
+        Seek(position);
+        const JsonScalar value = ReadScalar();
+        RestoreState(state);
+        return value;
+    }
+
+    // return: whether there is an object at <position>, continuing at <position> if there is
+    bool SeekObject(size_t position) {
+        if (position == kNoPosition) {
+            return false;
+        }
+        Seek(position);
+        return Peek() == '{';
+    }
+
+    // return: the position of the value of the member named <key> of the object that is the next value (kNoPosition if
+    // there is no such member), without changing the current position
+    size_t FindMember(std::string_view key) {
+        const State state = SaveState();
+        size_t position = kNoPosition;
+        if (BeginObject()) {
+            std::string_view member;
+            while (NextMember(member)) {
+                if (member == key) {
+                    position = Tell();
+                    break;
+                }
+                Skip();
+            }
+        }
+        RestoreState(state);
+        return position;
+    }
+
+    // return: the number of elements of the array that is the next value (zero if it is not an array), without
+    // consuming it
+    uint32_t PeekArraySize() {
+        const State state = SaveState();
+        uint32_t size = 0;
+        if (BeginArray()) {
+            for (; NextElement(); ++size) {
+                Skip();
+            }
+        }
+        RestoreState(state);
+        return size;
+    }
+
+    // return: <length> clamped to the number of array elements the rest of the input can hold, to bound the memory
+    // allocated for an array of a length coming from the input before its elements are counted
+    uint32_t ArrayCapacity(uint64_t length) const {
+        const uint64_t capacity = (Size() - std::min(pos_, Size())) / 2 + 1;
+        return static_cast<uint32_t>(std::min<uint64_t>({length, capacity, UINT32_MAX}));
+    }
+
+    // Parses the members of the object that is the next value by calling <parse_member> with the index of each member in
+    // <members> once the tokenizer is at its value. Members coming before the member they depend on are parsed after the
+    // object, as are missing members, which are read as null. Unknown members are skipped, except for sType and pNext
+    // which are recorded in <links>, if specified.
+    // return: whether the value was an object or null
+    template <size_t N, typename ParseMember>
+    bool ParseObject(const JsonMember (&members)[N], ParseMember&& parse_member, JsonStructLinks* links = nullptr) {
+        constexpr size_t kParsed = kNoPosition - 1;
+        size_t positions[N];
+        std::fill(std::begin(positions), std::end(positions), kNoPosition);
+        if (links != nullptr) {
+            *links = JsonStructLinks{kNoPosition, kNoPosition};
+        }
+
+        bool valid = true;
+        if (BeginObject()) {
+            std::string_view key;
+            size_t hint = 0;
+            while (NextMember(key)) {
+                const size_t index = FindMemberIndex(members, key, hint);
+                if (index < N) {
+                    const uint32_t dependency = members[index].dependency;
+                    if (dependency == JsonMember::kNoDependency || positions[dependency] == kParsed) {
+                        parse_member(static_cast<uint32_t>(index));
+                        positions[index] = kParsed;
+                    } else {
+                        positions[index] = Tell();
+                        Skip();
+                    }
+                    hint = index + 1;
+                } else {
+                    if (links != nullptr && key == "sType") {
+                        links->stype = Tell();
+                    } else if (links != nullptr && key == "pNext") {
+                        links->next = Tell();
+                    }
+                    Skip();
+                }
+            }
+        } else {
+            valid = ReadScalar().isNull();
+        }
+
+        const State state = SaveState();
+        for (size_t index = 0; index < N; ++index) {
+            if (positions[index] != kParsed) {
+                Seek(positions[index]);
+                parse_member(static_cast<uint32_t>(index));
+            }
+        }
+        RestoreState(state);
+        return valid;
+    }
+
+  private:
+    struct State {
+        size_t pos;
+        bool expect_first;
+        bool missing;
+    };
+
+    State SaveState() const { return State{pos_, expect_first_, missing_}; }
+
+    void RestoreState(const State& state) {
+        pos_ = state.pos;
+        expect_first_ = state.expect_first;
+        missing_ = state.missing;
+    }
+
+    // return: the index of the member named <key>, looking from <hint> first as members usually come in order
+    template <size_t N>
+    static size_t FindMemberIndex(const JsonMember (&members)[N], std::string_view key, size_t hint) {
+        for (size_t i = 0; i < N; ++i) {
+            const size_t index = (hint + i) % N;
+            if (members[index].name == key) {
+                return index;
+            }
+        }
+        return N;
+    }
+
+    // return: the next character after whitespace and comments, or zero at the end of the input
+    char Peek() {
+        while (pos_ < Size()) {
+            const char c = begin_[pos_];
+            if (c == ' ' || c == '\t' || c == '\r' || c == '\n') {
+                ++pos_;
+            } else if (c == '/' && pos_ + 1 < Size() && begin_[pos_ + 1] == '*') {
+                const char* comment_end = Find(begin_ + pos_ + 2, "*/");
+                if (comment_end == nullptr) {
+                    Fail("Missing '*/' at the end of comment");
+                    return 0;
+                }
+                pos_ = comment_end + 2 - begin_;
+            } else if (c == '/' && pos_ + 1 < Size() && begin_[pos_ + 1] == '/') {
+                while (pos_ < Size() && begin_[pos_] != '\n' && begin_[pos_] != '\r') {
+                    ++pos_;
+                }
+            } else {
+                return c;
+            }
+        }
+        return 0;
+    }
+
+    size_t Size() const { return static_cast<size_t>(end_ - begin_); }
+
+    const char* Find(const char* from, const char* str) const {
+        const size_t length = strlen(str);
+        for (const char* p = from; p + length <= end_; ++p) {
+            if (memcmp(p, str, length) == 0) {
+                return p;
+            }
+        }
+        return nullptr;
+    }
+
+    bool BeginContainer(char bracket) {
+        if (missing_ || HasError() || Peek() != bracket) {
+            return false;
+        }
+        ++pos_;
+        expect_first_ = true;
+        return true;
+    }
+
+    bool NextItem(char closing_bracket) {
+        if (HasError()) {
+            return false;
+        }
+        char c = Peek();
+        if (!expect_first_) {
+            if (c == ',') {
+                ++pos_;
+                c = Peek();
+            } else if (c != closing_bracket) {
+                return Fail(closing_bracket == '}' ? "Missing ',' or '}' in object declaration"
+                                                   : "Missing ',' or ']' in array declaration");
+            }
+        }
+        expect_first_ = false;
+        if (c == closing_bracket) {
+            ++pos_;
+            return false;
+        }
+        return true;
+    }
+
+    bool ReadLiteral(std::string_view literal) {
+        if (Size() - pos_ >= literal.size() && memcmp(begin_ + pos_, literal.data(), literal.size()) == 0) {
+            pos_ += literal.size();
+            return true;
+        }
+        return Fail("Syntax error: value, object or array expected.");
+    }
+
+    // Reads a number with the same rules as Json::Reader: integers are kept exact if they fit 64 bits
+    JsonScalar ReadNumber() {
+        const size_t start = pos_;
+        auto is_digit = [&] { return pos_ < Size() && begin_[pos_] >= '0' && begin_[pos_] <= '9'; };
+        if (pos_ < Size() && begin_[pos_] == '-') {
+            ++pos_;
+        } else if (!is_digit()) {
+            Fail("Syntax error: value, object or array expected.");
+            return JsonScalar{};
+        }
+        bool is_real = false;
+        while (is_digit()) {
+            ++pos_;
+        }
+        if (pos_ < Size() && begin_[pos_] == '.') {
+            is_real = true;
+            for (++pos_; is_digit();) {
+                ++pos_;
+            }
+        }
+        if (pos_ < Size() && (begin_[pos_] == 'e' || begin_[pos_] == 'E')) {
+            is_real = true;
+            ++pos_;
+            if (pos_ < Size() && (begin_[pos_] == '+' || begin_[pos_] == '-')) {
+                ++pos_;
+            }
+            while (is_digit()) {
+                ++pos_;
+            }
+        }
+
+        const std::string_view token(begin_ + start, pos_ - start);
+        const bool negative = token[0] == '-';
+        if (!is_real) {
+            const uint64_t limit = negative ? uint64_t(INT64_MAX) + 1 : UINT64_MAX;
+            uint64_t value = 0;
+            bool overflow = false;
+            for (size_t i = negative ? 1 : 0; i < token.size() && !overflow; ++i) {
+                const uint64_t digit = token[i] - '0';
+                overflow = value > (limit - digit) / 10;
+                value = value * 10 + digit;
+            }
+            if (!overflow) {
+                if (negative) {
+                    return JsonScalar::Int(value == uint64_t(INT64_MAX) + 1 ? INT64_MIN : -static_cast<int64_t>(value));
+                }
+                return value <= uint64_t(INT64_MAX) ? JsonScalar::Int(static_cast<int64_t>(value)) : JsonScalar::UInt(value);
+            }
+        }
+
+        number_scratch_.assign(token.data(), token.size());
+        char* parse_end = nullptr;
+        const double value = strtod(number_scratch_.c_str(), &parse_end);
+        if (parse_end != number_scratch_.c_str() + number_scratch_.size()) {
+            Fail("'" + number_scratch_ + "' is not a number.");
+            return JsonScalar{};
+        }
+        return JsonScalar::Real(value);
+    }
+
+    // Reads a string, <str> refers to the input if it has no escape sequences and to <scratch> otherwise
+    bool ReadString(std::string& scratch, std::string_view& str) {
+        const size_t start = ++pos_;
+        while (pos_ < Size() && begin_[pos_] != '"' && begin_[pos_] != '\\') {
+            ++pos_;
+        }
+        if (pos_ < Size() && begin_[pos_] == '"') {
+            str = std::string_view(begin_ + start, pos_ - start);
+            ++pos_;
+            return true;
+        }
+
+        scratch.assign(begin_ + start, pos_ - start);
+        while (pos_ < Size() && begin_[pos_] != '"') {
+            const char c = begin_[pos_++];
+            if (c != '\\') {
+                scratch.push_back(c);
+                continue;
+            }
+            if (pos_ == Size()) {
+                break;
+            }
+            switch (begin_[pos_++]) {
+                case '"':
+                    scratch.push_back('"');
+                    break;
+                case '/':
+                    scratch.push_back('/');
+                    break;
+                case '\\':
+                    scratch.push_back('\\');
+                    break;
+                case 'b':
+                    scratch.push_back('\b');
+                    break;
+                case 'f':
+                    scratch.push_back('\f');
+                    break;
+                case 'n':
+                    scratch.push_back('\n');
+                    break;
+                case 'r':
+                    scratch.push_back('\r');
+                    break;
+                case 't':
+                    scratch.push_back('\t');
+                    break;
+                case 'u':
+                    if (!ReadCodePoint(scratch)) {
+                        return false;
+                    }
+                    break;
+                default:
+                    return Fail("Bad escape sequence in string");
+            }
+        }
+        if (pos_ == Size()) {
+            return Fail("Missing '\"' at the end of string");
+        }
+        ++pos_;
+        str = scratch;
+        return true;
+    }
+
+    bool ReadHex4(uint32_t& value) {
+        if (Size() - pos_ < 4) {
+            return Fail("Bad unicode escape sequence in string: four digits expected.");
+        }
+        value = 0;
+        for (size_t i = 0; i < 4; ++i) {
+            const char c = begin_[pos_++];
+            value <<= 4;
+            if (c >= '0' && c <= '9') {
+                value += c - '0';
+            } else if (c >= 'a' && c <= 'f') {
+                value += c - 'a' + 10;
+            } else if (c >= 'A' && c <= 'F') {
+                value += c - 'A' + 10;
+            } else {
+                return Fail("Bad unicode escape sequence in string: hexadecimal digit expected.");
+            }
+        }
+        return true;
+    }
+
+    // Reads the code point of a \u escape sequence (and of the second half of a surrogate pair) as UTF-8
+    bool ReadCodePoint(std::string& scratch) {
+        uint32_t code_point = 0;
+        if (!ReadHex4(code_point)) {
+            return false;
+        }
+        if (code_point >= 0xD800 && code_point <= 0xDBFF) {
+            uint32_t low_surrogate = 0;
+            if (Size() - pos_ < 2 || begin_[pos_] != '\\' || begin_[pos_ + 1] != 'u') {
+                return Fail("expecting another \\u token to begin the second half of a unicode surrogate pair");
+            }
+            pos_ += 2;
+            if (!ReadHex4(low_surrogate)) {
+                return false;
+            }
+            if (low_surrogate < 0xDC00 || low_surrogate > 0xDFFF) {
+                return Fail("expecting another \\u token to begin the second half of a unicode surrogate pair");
+            }
+            code_point = 0x10000 + ((code_point & 0x3FF) << 10) + (low_surrogate & 0x3FF);
+        }
+
+        if (code_point < 0x80) {
+            scratch.push_back(static_cast<char>(code_point));
+        } else if (code_point < 0x800) {
+            scratch.push_back(static_cast<char>(0xC0 | (code_point >> 6)));
+            scratch.push_back(static_cast<char>(0x80 | (code_point & 0x3F)));
+        } else if (code_point < 0x10000) {
+            scratch.push_back(static_cast<char>(0xE0 | (code_point >> 12)));
+            scratch.push_back(static_cast<char>(0x80 | ((code_point >> 6) & 0x3F)));
+            scratch.push_back(static_cast<char>(0x80 | (code_point & 0x3F)));
+        } else {
+            scratch.push_back(static_cast<char>(0xF0 | (code_point >> 18)));
+            scratch.push_back(static_cast<char>(0x80 | ((code_point >> 12) & 0x3F)));
+            scratch.push_back(static_cast<char>(0x80 | ((code_point >> 6) & 0x3F)));
+            scratch.push_back(static_cast<char>(0x80 | (code_point & 0x3F)));
+        }
+        return true;
+    }
+
+    bool Fail(const std::string& message) {
+        if (!HasError()) {
+            size_t line = 1;
+            size_t line_start = 0;
+            for (size_t i = 0; i < pos_ && i < Size(); ++i) {
+                if (begin_[i] == '\n') {
+                    ++line;
+                    line_start = i + 1;
+                }
+            }
+            error_ = "Line " + std::to_string(line) + ", Column " + std::to_string(pos_ - line_start + 1) + ": " + message;
+        }
+        return false;
+    }
+
+    const char* begin_{nullptr};
+    const char* end_{nullptr};
+    size_t pos_{0};
+    bool expect_first_{false};
+    bool missing_{false};
+    std::string error_{};
+
+    VkObjectType handle_names_type_{VK_OBJECT_TYPE_UNKNOWN};
+    const HandleNames* handle_names_{nullptr};
+
+    // Reused across values and parses to avoid allocations
+    std::string key_scratch_{};
+    std::string value_scratch_{};
+    std::string number_scratch_{};
+    std::string skip_scratch_{};
+
+    struct SkippedContainer {
+        size_t begin;
+        char closing_bracket;
+    };
+    std::vector<SkippedContainer> skip_stack_{};
+    std::unordered_map<size_t, size_t> skipped_ends_{};
+};
+
+}  // namespace pcjson
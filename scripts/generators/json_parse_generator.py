@@ -6,11 +6,65 @@
 # SPDX-License-Identifier: Apache-2.0
 
 import os
+import re
 from base_generator import BaseGenerator
 from generators.generator_utils import PlatformGuardHelper
 from vulkan_object import (Handle, Struct, Enum, Bitmask, Flags, Member)
 from generators.generator_utils import PipelineJsonHelper, StructMemberHelper, TypeCategory
 
+# Mirrors HashName of vksc_pipeline_json_name_table.hpp
+def hashName(name: str) -> int:
+    multiplier = 0x9e3779b97f4a7c15
+    data = name.encode()
+    hash = (len(data) * multiplier) & 0xFFFFFFFFFFFFFFFF
+    words = [data[offset:offset + 8] for offset in range(0, len(data) - 7, 8)]
+    if len(data) % 8 != 0:
+        words.append(data[-8:] if len(data) >= 8 else data.ljust(8, b'\0'))
+    for word in words:
+        hash = ((hash ^ int.from_bytes(word, 'little')) * multiplier) & 0xFFFFFFFFFFFFFFFF
+        hash ^= hash >> 32
+    return hash
+
+# Mirrors NameTableSlot of vksc_pipeline_json_name_table.hpp
+def nameTableSlot(hash: int, displacement: int, entryCount: int) -> int:
+    x = (hash & 0xFFFFFFFF) ^ displacement
+    x ^= x >> 16
+    x = (x * 0x7feb352d) & 0xFFFFFFFF
+    x ^= x >> 15
+    x = (x * 0x846ca68b) & 0xFFFFFFFF
+    x ^= x >> 16
+    return x % entryCount
+
+# Builds the minimal perfect hash table of <entries> (name, value expression pairs) for a NameTable, using the hash and
+# displace scheme: buckets are placed in decreasing size order, each with the first displacement that moves all of its
+# names into free slots
+def buildNameTable(entries: list[tuple[str, str]], namesPerBucket: int = 4) -> tuple[list[int], list[tuple[str, str]]]:
+    names = [name for name, _ in entries]
+    assert len(set(names)) == len(names), 'Duplicate names in name table'
+    entryCount = len(entries)
+    bucketCount = max(1, (entryCount + namesPerBucket - 1) // namesPerBucket)
+    hashes = [hashName(name) for name in names]
+    buckets = [[] for _ in range(bucketCount)]
+    for i, hash in enumerate(hashes):
+        buckets[(hash >> 32) % bucketCount].append(i)
+
+    displacements = [0] * bucketCount
+    slots = [None] * entryCount
+    for bucket in sorted(range(bucketCount), key=lambda b: (-len(buckets[b]), b)):
+        if not buckets[bucket]:
+            continue
+        displacement = 0
+        while True:
+            bucketSlots = [nameTableSlot(hashes[i], displacement, entryCount) for i in buckets[bucket]]
+            if len(set(bucketSlots)) == len(bucketSlots) and all(slots[slot] is None for slot in bucketSlots):
+                break
+            displacement += 1
+            assert displacement < 0x100000, 'Failed to find a perfect hash, names of a bucket collide'
+        displacements[bucket] = displacement
+        for i, slot in zip(buckets[bucket], bucketSlots):
+            slots[slot] = entries[i]
+    return displacements, slots
+
 class JsonParseGenerator(BaseGenerator):
     def __init__(self):
         BaseGenerator.__init__(self)
@@ -36,21 +90,21 @@ class JsonParseGenerator(BaseGenerator):
             #include <vulkan/vulkan.h>
 
             #include <string>
-            #include <sstream>
             #include <string_view>
-            #include <unordered_map>
             #include <algorithm>
             #include <limits>
 
             #include "vksc_pipeline_json_base.hpp"
+            #include "vksc_pipeline_json_name_table.hpp"
+            #include "vksc_pipeline_json_tokenizer.hpp"
 
             namespace pcjson {
-
-            class ParserBase : protected Base {
             ''')
 
         self.generatedMethods: dict[str] = {}
 
+        self.name_tables: list[str] = []
+
         self.parse_basic_methods: list[str] = []
         self.parse_Handle_methods: list[str] = []
         self.parse_Enum_c_str_methods: list[str] = []
@@ -59,6 +113,8 @@ class JsonParseGenerator(BaseGenerator):
         self.parse_Bitmask_methods: list[str] = []
         self.parse_structChain_methods: list[str] = []
         self.parse_struct_contents_methods: list[str] = []
+        self.parse_stream_structChain_methods: list[str] = []
+        self.parse_stream_struct_contents_methods: list[str] = []
 
         self.basicTypes: list[str] = []
 
@@ -70,6 +126,10 @@ class JsonParseGenerator(BaseGenerator):
             self.genStructChainMethod(struct)
 
         out.append(f'''
+            // Perfect hash tables of the enum constant and flag bit names accepted by the parser
+            {"".join(self.name_tables)}
+
+            class ParserBase : protected Base {{
                 // NOTE: As legacy pipeline JSONs produced by the old generators have syntax errors
                 // such as integers represented by strings containing numbers and including enum values
                 // that do not exist in Vulkan SC, we provide a bunch of knobs for the parser to enable
@@ -90,8 +150,11 @@ class JsonParseGenerator(BaseGenerator):
                 {"".join(self.parse_Flags_methods)}
                 {"".join(self.parse_Bitmask_methods)}
                 {"".join(self.parse_structChain_methods)}
+                // Streaming variants of the structure parse methods reading directly from a JsonTokenizer
+                {"".join(self.parse_stream_structChain_methods)}
               private:
                 {"".join(self.parse_struct_contents_methods)}
+                {"".join(self.parse_stream_struct_contents_methods)}
             }};
 
             }}  // namespace pcjson
@@ -147,6 +210,62 @@ class JsonParseGenerator(BaseGenerator):
                 return s;
             }
             ''')
+        self.parse_stream_structChain_methods.append('''
+            VkShaderModuleCreateInfo parse_VkShaderModuleCreateInfo(JsonTokenizer& json, const LocationScope& l) {
+                static constexpr JsonMember members[] = {
+                    {"sType"},
+                    {"pNext"},
+                    {"flags"},
+                    {"codeSize"},
+                    {"pCode", 3},
+                };
+                VkShaderModuleCreateInfo s{ VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO, nullptr };
+                auto parse_member = [&](uint32_t member) {
+                    switch (member) {
+                        case 0:
+                            if (const auto json_stype = json.ReadScalar(); !json_stype.isString()) {
+                                Error() << "Invalid sType format";
+                            } else if (strcmp(json_stype.asCString(), "VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO") != 0) {
+                                Error() << "Invalid sType value: " << json_stype.asCString();
+                            }
+                            break;
+                        case 1:
+                            if (const auto json_pnext = json.ReadScalar(); !json_pnext.isString() || strcmp(json_pnext.asCString(), "NULL") != 0) {
+                                Error() << "Unexpected non-NULL pNext";
+                            }
+                            break;
+                        case 2:
+                            if (const auto json_flags = json.ReadScalar(); !json_flags.isUInt() || json_flags.asUInt() != 0) {
+                                Error() << "Unexpected non-zero flags";
+                            }
+                            break;
+                        case 3:
+                            s.codeSize = parse_size_t(json.ReadScalar(), CreateScope("codeSize"));
+                            break;
+                        case 4:
+                            if (s.codeSize == 0) {
+                                s.pCode = nullptr;
+                                const auto json_pcode = json.ReadScalar();
+                                if (!(json_pcode.isNull() ||
+                                    (json_pcode.isString() && ((json_pcode.asString() == "") || (json_pcode.asString() == "NULL"))))) {
+                                    Error() << "pCode is not empty or not NULL but codeSize is zero";
+                                }
+                            } else {
+                                size_t size = 0;
+                                s.pCode = reinterpret_cast<const uint32_t*>(parse_binary(json, CreateScope("pCode"), size));
+                                if (size != s.codeSize) {
+                                    Error() << "pCode binary size (" << size << ") does not match expected size (" << s.codeSize << ")";
+                                }
+                            }
+                            break;
+                    }
+                };
+                if (!json.ParseObject(members, parse_member)) {
+                    Error() << "Invalid format";
+                }
+                return s;
+            }
+            ''')
 
         # VkPhysicalDeviceFeatures2 structure filtering is another special case for which we provide an explicit API
         # NOTE: This is needed to sanitize invalid input produced by the legacy generator
@@ -196,6 +315,60 @@ class JsonParseGenerator(BaseGenerator):
             }
             ''')
 
+        # The streaming variant parses the filtered structure directly, building the same chain as parsing the output of
+        # filter_VkPhysicalDeviceFeatures2 would
+        self.parse_stream_structChain_methods.append('''
+            VkPhysicalDeviceFeatures2 parse_filtered_VkPhysicalDeviceFeatures2(JsonTokenizer& json, const LocationScope& l) {
+                const size_t begin = json.Tell();
+                json.Skip();
+                const size_t end = json.Tell();
+
+                size_t base = JsonTokenizer::kNoPosition;
+                VkBaseOutStructure* pnext = nullptr;
+                JsonStructLinks links{};
+                size_t p = begin;
+                while (json.SeekObject(p)) {
+                    size_t next = json.FindMember("pNext");
+                    const auto json_stype = json.ReadScalarAt(json.FindMember("sType"));
+                    if (!json_stype.isString()) {
+                        break;
+                    }
+                    const char* stype = json_stype.asCString();
+                    if (strcmp(stype, "VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2") == 0) {
+                        base = p;
+                    }
+            ''')
+        for feature_struct_name in self.vk.structs['VkPhysicalDeviceFeatures2'].extendedBy:
+            feature_struct = self.vk.structs[feature_struct_name]
+            self.parse_stream_structChain_methods.extend(guard_helper.add_guard(feature_struct.protect))
+            self.parse_stream_structChain_methods.append(f'''
+                    else if (strcmp(stype, "{feature_struct.sType}") == 0) {{
+                        auto s = AllocMem<{feature_struct.name}>();
+                        *s = parse_{feature_struct.name}_contents(json, CreateScope("pNext<{feature_struct.name}>", true), &links);
+                        s->sType = {feature_struct.sType};
+                        s->pNext = pnext;
+                        pnext = reinterpret_cast<VkBaseOutStructure*>(s);
+                        next = links.next;
+                    }}
+                ''')
+        self.parse_stream_structChain_methods.extend(guard_helper.add_guard(None))
+        self.parse_stream_structChain_methods.append('''
+                    else {
+                        Warn() << "Ignoring structure with type \\"" << stype << "\\" as it is not a physical device feature structure";
+                    }
+                    p = next;
+                }
+
+                json.Seek(base);
+                VkPhysicalDeviceFeatures2 s = parse_VkPhysicalDeviceFeatures2_contents(json, l);
+                s.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
+                s.pNext = pnext;
+
+                json.Seek(end);
+                return s;
+            }
+            ''')
+
     def genBasicMethods(self):
         self.basicTypes = ['int8_t', 'uint8_t', 'int16_t', 'uint16_t', 'int32_t', 'uint32_t', 'int64_t', 'uint64_t', 'float', 'size_t']
         self.basicTypes.extend(['VkBool32', 'VkDeviceSize', 'VkSampleMask'])
@@ -219,7 +392,8 @@ class JsonParseGenerator(BaseGenerator):
                             float_constants.append(enum_name)
 
         self.parse_basic_methods.append(f'''
-            int8_t parse_int8_t(const Json::Value& v, const LocationScope&) {{
+            template <typename Value>
+            int8_t parse_int8_t(const Value& v, const LocationScope&) {{
                 if (v.isInt() && v.asInt() >= INT8_MIN && v.asInt() <= INT8_MAX) {{
                     return v.asInt();
                 }} else if (accept_integers_as_strings_ && v.isString()) {{
@@ -232,7 +406,8 @@ class JsonParseGenerator(BaseGenerator):
                 }}
             }}
 
-            int16_t parse_int16_t(const Json::Value& v, const LocationScope&) {{
+            template <typename Value>
+            int16_t parse_int16_t(const Value& v, const LocationScope&) {{
                 if (v.isInt() && v.asInt() >= INT16_MIN && v.asInt() <= INT16_MAX) {{
                     return v.asInt();
                 }} else if (accept_integers_as_strings_ && v.isString()) {{
@@ -245,7 +420,8 @@ class JsonParseGenerator(BaseGenerator):
                 }}
             }}
 
-            int32_t parse_int32_t(const Json::Value& v, const LocationScope&) {{
+            template <typename Value>
+            int32_t parse_int32_t(const Value& v, const LocationScope&) {{
                 if (v.isInt() && v.asInt() >= INT32_MIN && v.asInt() <= INT32_MAX) {{
                     return v.asInt();
                 }} else if (accept_integers_as_strings_ && v.isString()) {{
@@ -258,7 +434,8 @@ class JsonParseGenerator(BaseGenerator):
                 }}
             }}
 
-            int64_t parse_int64_t(const Json::Value& v, const LocationScope&) {{
+            template <typename Value>
+            int64_t parse_int64_t(const Value& v, const LocationScope&) {{
                 if (v.isInt64()) {{
                     return v.asInt64();
                 }} else if (accept_integers_as_strings_ && v.isString()) {{
@@ -271,7 +448,8 @@ class JsonParseGenerator(BaseGenerator):
                 }}
             }}
 
-            uint8_t parse_uint8_t(const Json::Value& v, const LocationScope&) {{
+            template <typename Value>
+            uint8_t parse_uint8_t(const Value& v, const LocationScope&) {{
                 if (v.isUInt() && v.asUInt() <= UINT8_MAX) {{
                     return v.asUInt();
                 }} else if (accept_integers_as_strings_ && v.isString()) {{
@@ -284,7 +462,8 @@ class JsonParseGenerator(BaseGenerator):
                 }}
             }}
 
-            uint16_t parse_uint16_t(const Json::Value& v, const LocationScope&) {{
+            template <typename Value>
+            uint16_t parse_uint16_t(const Value& v, const LocationScope&) {{
                 if (v.isUInt() && v.asUInt() <= UINT16_MAX) {{
                     return v.asUInt();
                 }} else if (accept_integers_as_strings_ && v.isString()) {{
@@ -297,7 +476,8 @@ class JsonParseGenerator(BaseGenerator):
                 }}
             }}
 
-            uint32_t parse_uint32_t(const Json::Value& v, const LocationScope&) {{
+            template <typename Value>
+            uint32_t parse_uint32_t(const Value& v, const LocationScope&) {{
                 if (v.isUInt() && v.asUInt() <= UINT32_MAX) {{
                     return v.asUInt();
                 }} else if(v.isString()) {{
@@ -320,7 +500,8 @@ class JsonParseGenerator(BaseGenerator):
                 }}
             }}
 
-            uint64_t parse_uint64_t(const Json::Value& v, const LocationScope&) {{
+            template <typename Value>
+            uint64_t parse_uint64_t(const Value& v, const LocationScope&) {{
                 if (v.isUInt64()) {{
                     return v.asUInt64();
                 }} else if(v.isString()) {{
@@ -343,7 +524,8 @@ class JsonParseGenerator(BaseGenerator):
                 }}
             }}
 
-            float parse_float(const Json::Value& v, const LocationScope& l) {{
+            template <typename Value>
+            float parse_float(const Value& v, const LocationScope& l) {{
                 if (v.isDouble()) {{
                     return v.asFloat();
                 }} else if(v.isString()) {{
@@ -363,7 +545,8 @@ class JsonParseGenerator(BaseGenerator):
                 }}
             }}
 
-            size_t parse_size_t(const Json::Value& v, const LocationScope& l) {{
+            template <typename Value>
+            size_t parse_size_t(const Value& v, const LocationScope& l) {{
                 if constexpr(sizeof(&v) == 8) {{
                     return parse_uint64_t(v, l);
                 }} else {{
@@ -371,11 +554,13 @@ class JsonParseGenerator(BaseGenerator):
                 }}
             }}
 
-            VkDeviceSize parse_VkDeviceSize(const Json::Value& v, const LocationScope& l) {{
+            template <typename Value>
+            VkDeviceSize parse_VkDeviceSize(const Value& v, const LocationScope& l) {{
                 return parse_uint64_t(v, l);
             }}
 
-            const char* parse_string(const Json::Value& v, const LocationScope&) {{
+            template <typename Value>
+            const char* parse_string(const Value& v, const LocationScope&) {{
                 if (v.isString()) {{
                     const char *first, *last;
                     v.getString(&first, &last);
@@ -408,6 +593,34 @@ class JsonParseGenerator(BaseGenerator):
                     size = v.size();
                     return result;
                 }}
+                return parse_base64(v, size);
+            }}
+
+            void* parse_binary(JsonTokenizer& json, const LocationScope&, size_t& size) {{
+                const uint32_t array_size = json.PeekArraySize();
+                if (json.BeginArray()) {{ // TODO: Consider removing. Array path is preserved for historical reasons.
+                    uint8_t* result = array_size > 0 ? AllocMem<uint8_t>(array_size) : nullptr;
+                    bool valid = true;
+                    for (uint32_t i = 0; json.NextElement(); ++i) {{
+                        const auto element = json.ReadScalar();
+                        if (valid && element.isUInt() && element.asUInt() <= 255) {{
+                            result[i] = element.asUInt();
+                        }} else if (valid) {{
+                            Error() << "Binary array has non-unsigned integral value or is out of [0-255] range.";
+                            valid = false;
+                        }}
+                    }}
+                    if (!valid) {{
+                        return nullptr;
+                    }}
+                    size = array_size;
+                    return result;
+                }}
+                return parse_base64(json.ReadScalar(), size);
+            }}
+
+            template <typename Value>
+            void* parse_base64(const Value& v, size_t& size) {{
                 if (!v.isString()) {{
                     Error() << "Base64 encoded binary not a string";
                     return nullptr;
@@ -456,7 +669,8 @@ class JsonParseGenerator(BaseGenerator):
                 return result;
             }}
 
-            VkBool32 parse_VkBool32(const Json::Value& v, const LocationScope&) {{
+            template <typename Value>
+            VkBool32 parse_VkBool32(const Value& v, const LocationScope&) {{
                 if (v.isString()) {{
                     auto value = v.asCString();
                     if (strcmp(value, "VK_TRUE") == 0) {{
@@ -476,7 +690,8 @@ class JsonParseGenerator(BaseGenerator):
                 }}
             }}
 
-            VkSampleMask parse_VkSampleMask(const Json::Value& v, const LocationScope& l) {{
+            template <typename Value>
+            VkSampleMask parse_VkSampleMask(const Value& v, const LocationScope& l) {{
                 return parse_uint32_t(v, l);
             }}
             ''')
@@ -506,7 +721,8 @@ class JsonParseGenerator(BaseGenerator):
     def genHandleMethod(self, handle: Handle) -> str:
         # Handles are converted to uint64_t values through constructor syntax
         self.parse_Handle_methods.append(f'''
-            {handle.name} parse_{handle.name}(const Json::Value& json, const LocationScope& l) {{
+            template <typename Value>
+            {handle.name} parse_{handle.name}(const Value& json, const LocationScope& l) {{
                 if (json.isString()) {{
                     auto json_str = json.asCString();
                     if (strcmp(json_str, "") == 0) {{
@@ -529,22 +745,20 @@ class JsonParseGenerator(BaseGenerator):
         if flags.bitmaskName:
             self.genBitmaskMethod(self.vk.bitmasks[flags.bitmaskName])
             self.parse_Flags_methods.append(f'''
-                {flags.name} parse_{flags.name}(const Json::Value& json, const LocationScope& l) {{
+                template <typename Value>
+                {flags.name} parse_{flags.name}(const Value& json, const LocationScope& l) {{
                     {flags.name} result = 0;
                     if (json.isUInt() && json.asUInt() == 0) {{
                         return result;
                     }}
                     else if (json.isString()) {{
-                        auto json_str = json.asCString();
-                        if (strcmp(json_str, "NULL") == 0 || strcmp(json_str, "0") == 0) {{
+                        const std::string_view json_str = json.asCString();
+                        if (json_str == "NULL" || json_str == "0") {{
                             return result;
                         }}
-                        std::stringstream strm(json_str);
-                        std::string str;
-                        while (std::getline(strm, str, '|')) {{
-                            str.erase(std::remove_if(str.begin(), str.end(), isspace), str.end());
-                            result |= parse_{flags.bitmaskName}_c_str(str.c_str());
-                        }}
+                        ForEachFlagName(json_str, [&](std::string_view name) {{
+                            result |= parse_{flags.bitmaskName}_c_str(name);
+                        }});
                     }} else {{
                         Error() << "Invalid format";
                     }}
@@ -553,7 +767,8 @@ class JsonParseGenerator(BaseGenerator):
             ''')
         else:
             self.parse_Flags_methods.append(f'''
-                {flags.name} parse_{flags.name}(const Json::Value& json, const LocationScope& l) {{
+                template <typename Value>
+                {flags.name} parse_{flags.name}(const Value& json, const LocationScope& l) {{
                     if (!((json.isUInt() && json.asUInt() == 0) || (json.isString() && strcmp(json.asCString(), "0") == 0))) {{
                         Error() << "Invalid format";
                     }}
@@ -569,18 +784,13 @@ class JsonParseGenerator(BaseGenerator):
             enum_fields.append(field.name)
             for alias in field.aliases:
                 enum_fields.append(alias)
-        enum_fields = [f'std::make_pair("{f}", {f})' for f in enum_fields]
         if enum.name == 'VkStructureType':
             # VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO does not exist in Vulkan SC, but the CTS has to [de]serialize it
-            enum_fields.append('std::make_pair("VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO", VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO)')
+            enum_fields.append('VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO')
         self.parse_Enum_c_str_methods.append(f'''
-            {enum.name} parse_{enum.name}_c_str(const char* v) {{
-                static std::unordered_map<std::string_view, {enum.name}> map = {{
-                    {','.join(enum_fields)}
-                }};
-                auto it = map.find(v);
-                if (it != map.end()) {{
-                    return it->second;
+            {enum.name} parse_{enum.name}_c_str(std::string_view v) {{
+                if (auto entry = {self.genNameTable(enum.name, [(f, f) for f in enum_fields])}.Find(v)) {{
+                    return entry->value;
                 }} else {{
                     if (ignore_invalid_enum_values_) {{
                         Warn() << "Invalid {enum.name} constant: " << v << " (ignored instead of being treated as an error as relaxed behavior was requested)";
@@ -592,7 +802,8 @@ class JsonParseGenerator(BaseGenerator):
             }}
         ''')
         self.parse_Enum_methods.append(f'''
-            {enum.name} parse_{enum.name}(const Json::Value& json, const LocationScope& l) {{
+            template <typename Value>
+            {enum.name} parse_{enum.name}(const Value& json, const LocationScope& l) {{
                 if (json.isString()) {{
                     return parse_{enum.name}_c_str(json.asCString());
                 }} else if (json.isInt()) {{
@@ -606,6 +817,20 @@ class JsonParseGenerator(BaseGenerator):
         self.generatedMethods[enum.name] = f'parse_{enum.name}'
         return self.generatedMethods[enum.name]
 
+    # Generates the constexpr perfect hash table k<typeName>Names mapping the <entries> (name, value expression pairs) to
+    # <typeName> values, and returns its name
+    def genNameTable(self, typeName: str, entries: list[tuple[str, str]]) -> str:
+        displacements, slots = buildNameTable(entries)
+        self.name_tables.append(f'''
+            inline constexpr NameTable<{typeName}, {len(displacements)}, {len(slots)}> k{typeName}Names = {{
+                {{{', '.join([str(d) for d in displacements])}}},
+                {{
+                    {''.join([f'{{"{name}", {value}}},' for name, value in slots])}
+                }},
+            }};
+        ''')
+        return f'k{typeName}Names'
+
     def genBitmaskMethod(self, bitmask: Bitmask) -> str:
         if bitmask.name in self.generatedMethods:
             return self.generatedMethods[bitmask.name]
@@ -615,17 +840,12 @@ class JsonParseGenerator(BaseGenerator):
             enum_flags.append(flag.name)
             for alias in flag.aliases:
                 enum_flags.append(alias)
-        enum_flags = [f'std::make_pair("{f}", {f})' for f in enum_flags]
+        enum_flags = [('0', f'static_cast<{bitmask.name}>(0)')] + [(f, f) for f in enum_flags]
 
         self.parse_Enum_c_str_methods.append(f'''
-            {bitmask.name} parse_{bitmask.name}_c_str(const char* v) {{
-                static std::unordered_map<std::string_view, {bitmask.name}> map = {{
-                    std::make_pair("0", static_cast<{bitmask.name}>(0)),
-                    {','.join(enum_flags)}
-                }};
-                auto it = map.find(v);
-                if (it != map.end()) {{
-                    return it->second;
+            {bitmask.name} parse_{bitmask.name}_c_str(std::string_view v) {{
+                if (auto entry = {self.genNameTable(bitmask.name, enum_flags)}.Find(v)) {{
+                    return entry->value;
                 }} else {{
                     if (ignore_invalid_enum_values_) {{
                         Warn() << "Invalid {bitmask.name} bit: " << v << " (ignored instead of being treated as an error as relaxed behavior was requested)";
@@ -637,7 +857,8 @@ class JsonParseGenerator(BaseGenerator):
             }}
         ''')
         self.parse_Enum_methods.append(f'''
-            {bitmask.name} parse_{bitmask.name}(const Json::Value& json, const LocationScope& l) {{
+            template <typename Value>
+            {bitmask.name} parse_{bitmask.name}(const Value& json, const LocationScope& l) {{
                 if (json.isString()) {{
                     return parse_{bitmask.name}_c_str(json.asCString());
                 }} else {{
@@ -703,9 +924,71 @@ class JsonParseGenerator(BaseGenerator):
             }}
         ''')
 
+        stream_cases = ''.join([f"""
+                        {''.join(guard_helper.add_guard(extStruct.protect))}
+                        case {extStruct.sType}: {{
+                            auto next = AllocMem<{extStruct.name}>();
+                            current_pnext_ref = "pNext<{extStruct.name}>";
+                            *next = {self.genStructContentsMethod(extStruct)}(json, CreateScope(current_pnext_ref, true), &links);
+                            next->sType = {extStruct.sType};
+                            prev->pNext = reinterpret_cast<VkBaseOutStructure*>(next);
+                            break;
+                        }}
+                        {''.join(guard_helper.add_guard(None))}
+                        """ for extStruct in extStructs]) if struct.extendedBy else ''
+        self.parse_stream_structChain_methods.append(f'''
+            {struct.name} parse_{struct.name}(JsonTokenizer& json, const LocationScope& l) {{
+                JsonStructLinks links{{}};
+                {struct.name} s = {self.genStructContentsMethod(struct)}(json, l, &links);
+
+                if (const auto json_stype = json.ReadScalarAt(links.stype); json_stype.isString()) {{
+                    if (strcmp(json_stype.asCString(), "{struct.sType}") == 0) {{
+                        s.sType = {struct.sType};
+                    }} else {{
+                        Error() << "Invalid sType value: " << json_stype.asCString();
+                    }}
+                }} else {{
+                    Error() << "Invalid sType format";
+                }}
+
+                [[maybe_unused]] auto prev = reinterpret_cast<VkBaseOutStructure*>(&s);
+                const size_t end = json.Tell();
+                size_t json_next = links.next;
+                const char* current_pnext_ref = "pNext";
+                while (json.SeekObject(json_next)) {{
+                    auto next_stype = parse_VkStructureType(json.ReadScalarAt(json.FindMember("sType")), CreateScope(current_pnext_ref));
+                    switch (next_stype) {{
+                        {stream_cases}
+                        default:
+                            Error() << "Invalid structure type extending {struct.name}: " << json.ReadScalarAt(json.FindMember("sType")).asCString();
+                            links.next = json.FindMember("pNext");
+                            break;
+                    }}
+                    json_next = links.next;
+                    if (prev->pNext != nullptr) prev = prev->pNext;
+                }}
+
+                if (const auto json_pnext = json.ReadScalarAt(json_next); !json_pnext.isString() || strcmp(json_pnext.asCString(), "NULL") != 0) {{
+                    Error() << "Invalid pNext format";
+                }}
+                json.Seek(end);
+                return s;
+            }}
+        ''')
+
         self.generatedMethods[struct.name] = f'parse_{struct.name}'
         return self.generatedMethods[struct.name]
 
+    def genStreamValue(self, typeName: str, scope: str) -> str:
+        # Returns the expression parsing the next value of the tokenizer as <typeName>
+        method = self.genTypeMethod(typeName)
+        if typeName in self.vk.structs:
+            return f'{method}(json, {scope})'
+        elif typeName in self.vk.handles:
+            # Object names are resolved by the tokenizer for the handle types the caller provided names for
+            return f'{method}(json.ReadHandle({self.vk.handles[typeName].type}), {scope})'
+        else:
+            return f'{method}(json.ReadScalar(), {scope})'
 
     def genStructContentsMethod(self, struct: Struct):
         if struct.name in self.generatedMethods:
@@ -722,14 +1005,30 @@ class JsonParseGenerator(BaseGenerator):
                 {struct.name} s{{}};
         ''')
 
-        for member in struct.members:
-            if member.name in ['sType', 'pNext']:
-                # Do not handle sType and pNext here as it is already handled in genStructChainMethod
-                continue
+        # The streaming variant parses the members in the order they come in the JSON, except for the members that
+        # depend on other members (e.g. on their length), which are only parsed after those
+        members = [member for member in struct.members if member.name not in ['sType', 'pNext']]
+        member_indices = {member.name: index for index, member in enumerate(members)}
+        member_table = []
+        stream_cases = []
+
+        for index, member in enumerate(members):
+            dependencies = [name for name in member_indices if member.length and re.search(rf'\b{name}\b', member.length)]
+            if struct.union and index > 0:
+                # Union members overwrite each other, so they have to be parsed in order
+                dependencies = [members[index - 1].name]
+            if dependencies:
+                if len(dependencies) != 1 or member_indices[dependencies[0]] >= index:
+                    raise Exception(f"Unhandled member dependency: {struct.name}.{member.name} depends on {dependencies}")
+                member_table.append(f'{{"{member.name}", {member_indices[dependencies[0]]}}},')
+            else:
+                member_table.append(f'{{"{member.name}"}},')
+            stream_cases.append(f'case {index}:')
 
             match StructMemberHelper.getMemberType(self.vk, self.basicTypes, member):
                 case TypeCategory.STRING:
                     out.append(f's.{member.name} = parse_string(json["{member.name}"], CreateScope("{member.name}"));')
+                    stream_cases.append(f's.{member.name} = parse_string(json.ReadScalar(), CreateScope("{member.name}"));')
 
                 case TypeCategory.STRING_FIXED_SIZE_ARRAY | TypeCategory.STRING_ARRAY:
                     raise Exception(f"Unhandled string array")
@@ -753,6 +1052,22 @@ class JsonParseGenerator(BaseGenerator):
                             }}
                         }}
                         ''')
+                    stream_cases.append(f'''
+                        if (s.{member.length} == 0) {{
+                            s.{member.name} = nullptr;
+                            const auto json_member = json.ReadScalar();
+                            if (!(json_member.isNull() ||
+                                 (json_member.isString() && ((json_member.asString() == "") || (json_member.asString() == "NULL"))))) {{
+                                Error() << "{member.name} is not empty or not NULL but its length is zero";
+                            }}
+                        }} else {{
+                            size_t size = 0;
+                            s.{member.name} = parse_binary(json, CreateScope("{member.name}"), size);
+                            if (size != s.{member.length}) {{
+                                Error() << "{member.name} binary size (" << size << ") does not match expected size (" << s.{member.length} << ")";
+                            }}
+                        }}
+                        ''')
 
                 case TypeCategory.POINTER:
                     out.append(f'''
@@ -767,6 +1082,16 @@ class JsonParseGenerator(BaseGenerator):
                             }}
                         }}
                     ''')
+                    stream_cases.append(f'''
+                        if (json.PeekString("NULL")) {{
+                            json.Skip();
+                            s.{member.name} = nullptr;
+                        }} else {{
+                            auto dst_buffer = AllocMem<{member.type}>();
+                            *dst_buffer = {self.genStreamValue(member.type, 'CreateScope("' + member.name + '", true)')};
+                            s.{member.name} = dst_buffer;
+                        }}
+                    ''')
 
                 case TypeCategory.FIXED_SIZE_ARRAY | TypeCategory.ARRAY:
                     if member.fixedSizeArray and (len(member.fixedSizeArray) != 1 or member.length != member.fixedSizeArray[0]):
@@ -836,8 +1161,69 @@ class JsonParseGenerator(BaseGenerator):
                         }}
                         ''')
 
+                    stream_array = []
+                    if not member.fixedSizeArray:
+                        stream_array.append(f'''
+                            if ({lengthExpr} == 0) {{
+                                s.{member.name} = nullptr;
+                                if (!json.PeekString("NULL")) {{
+                                    Warn() << "{member.name} is not NULL but its length is zero";
+                                }}
+                                json.Skip();
+                            }} else ''')
+                        stream_array.append(f'''if (json.BeginArray()) {{
+                                const uint32_t capacity = json.ArrayCapacity({lengthExpr});
+                                auto dst_buffer = AllocMem<{member.type}>(capacity);
+                                uint32_t count = 0;
+                                for (; json.NextElement(); ++count) {{
+                                    if (count < capacity) {{
+                                        dst_buffer[count] = {self.genStreamValue(member.type, 'CreateScope("' + member.name + '", count)')};
+                                    }} else {{
+                                        json.Skip();
+                                    }}
+                                }}
+                                if (count == {lengthExpr}) {{
+                                    s.{member.name} = dst_buffer;
+                                }} else {{
+                            ''')
+                    else:
+                        stream_array.append(f'''if (json.BeginArray()) {{
+                                uint32_t count = 0;
+                                for (; json.NextElement(); ++count) {{
+                                    if (count < {lengthExpr}) {{
+                                        s.{member.name}[count] = {self.genStreamValue(member.type, 'CreateScope("' + member.name + '", count)')};
+                                    }} else {{
+                                        json.Skip();
+                                    }}
+                                }}
+                                if (count != {lengthExpr}) {{
+                            ''')
+                    stream_array.append(f'''
+                                    Error() << "{member.name} array size (" << count << ") does not match expected length (" << {lengthExpr} << ")";
+                                }}
+                            }} else ''')
+
+                    if (not member.fixedSizeArray and member.noAutoValidity) or member.optional:
+                        stream_array.append(f'''if (const auto json_member = json.ReadScalar(); json_member.isString() && strcmp(json_member.asCString(), "NULL") == 0) {{
+                                s.{member.name} = nullptr;
+                            }} else {{
+                                Error() << "{member.name} is not an array and is not NULL";
+                            }}
+                            ''')
+                    else:
+                        stream_array.append(f'''{{
+                                json.Skip();
+                                Error() << "{member.name} is not an array";
+                            }}
+                            ''')
+                    stream_cases.append(''.join(stream_array))
+
                 case TypeCategory.HANDLE | TypeCategory.ENUM | TypeCategory.FLAGS | TypeCategory.BITMASK | TypeCategory.BASIC | TypeCategory.STRUCT:
                     out.append(f's.{member.name} = {self.genTypeMethod(member.type)}(json["{member.name}"], CreateScope("{member.name}"));')
+                    stream_value = self.genStreamValue(member.type, f'CreateScope("{member.name}")')
+                    stream_cases.append(f's.{member.name} = {stream_value};')
+
+            stream_cases.append('break;')
 
         out.append(f'''
                 return s;
@@ -846,6 +1232,29 @@ class JsonParseGenerator(BaseGenerator):
 
         out.extend(guard_helper.add_guard(None))
 
+        member_table = '\n'.join(member_table)
+        stream_cases = '\n'.join(case.strip() for case in stream_cases)
+        stream_out = guard_helper.add_guard(struct.protect)
+        stream_out.append(f'''
+            {struct.name} parse_{struct.name}_contents(JsonTokenizer& json, const LocationScope& l, JsonStructLinks* links = nullptr) {{
+                static constexpr JsonMember members[] = {{
+                    {member_table}
+                }};
+                {struct.name} s{{}};
+                auto parse_member = [&](uint32_t member) {{
+                    switch (member) {{
+                        {stream_cases}
+                    }}
+                }};
+                if (!json.ParseObject(members, parse_member, links)) {{
+                    Error() << "Invalid format";
+                }}
+                return s;
+            }}
+        ''')
+        stream_out.extend(guard_helper.add_guard(None))
+
         self.parse_struct_contents_methods.extend(out)
+        self.parse_stream_struct_contents_methods.extend(stream_out)
         self.generatedMethods[struct.name] = f'parse_{struct.name}_contents'
         return self.generatedMethods[struct.name]
@@ -0,0 +1,177 @@
+/*
+ * Copyright (c) 2025 The Khronos Group Inc.
+ * Copyright (c) 2025 RasterGrid Kft.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+// Micro-benchmarks for the pipeline JSON parser.
+//
+// The pipeline JSONs of the test data directory are replicated to the requested number of pipelines.
+// These are not registered as tests, run the executable manually to get the timings:
+//   pcjson_benchmark [<pipeline count> [<pipeline JSON directory>]]
+
+#include <vulkan/pcjson/vksc_pipeline_json.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+// Loads all pipeline JSONs (files with a top-level pipeline state) from <directory>, in file name order
+std::vector<std::string> LoadPipelineJsons(const std::filesystem::path& directory) {
+    std::vector<std::filesystem::path> paths;
+    for (const auto& entry : std::filesystem::directory_iterator(directory)) {
+        if (entry.is_regular_file() && entry.path().extension() == ".json") {
+            paths.push_back(entry.path());
+        }
+    }
+    std::sort(paths.begin(), paths.end());
+
+    std::vector<std::string> jsons;
+    for (const auto& path : paths) {
+        std::ifstream file(path, std::ios::binary);
+        std::stringstream contents;
+        contents << file.rdbuf();
+        std::string json = contents.str();
+        if (json.find("PipelineState") != std::string::npos) {
+            jsons.push_back(std::move(json));
+        }
+    }
+    return jsons;
+}
+
+template <typename F>
+double MeasureSeconds(F&& f) {
+    auto begin = std::chrono::steady_clock::now();
+    f();
+    auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double>(end - begin).count();
+}
+
+void Report(const char* variant, size_t pipeline_count, double seconds, size_t parsed_count) {
+    std::cout << std::left << std::setw(28) << variant << std::right << std::setw(8) << pipeline_count << " pipelines  "
+              << std::fixed << std::setprecision(3) << std::setw(12) << seconds * 1e3 << " ms  " << std::setw(10)
+              << std::setprecision(1) << seconds * 1e6 / double(pipeline_count) << " us/pipeline";
+    if (parsed_count != pipeline_count) {
+        std::cout << "  (" << pipeline_count - parsed_count << " failed)";
+    }
+    std::cout << std::endl;
+}
+
+// Number of pipelines parsed between two vpjFreeParserOutputs calls with a reused parser
+constexpr size_t kOutputBatchSize = 64;
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    const size_t pipeline_count = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 5000;
+    const std::filesystem::path directory = argc > 2 ? argv[2] : PCJSON_BENCHMARK_DATA_PATH;
+
+    const std::vector<std::string> jsons = LoadPipelineJsons(directory);
+    if (jsons.empty() || pipeline_count == 0) {
+        std::cerr << "No pipeline JSONs found in " << directory << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    size_t total_size = 0;
+    for (size_t i = 0; i < pipeline_count; i++) {
+        total_size += jsons[i % jsons.size()].size();
+    }
+    std::cout << jsons.size() << " distinct pipeline JSONs, " << total_size / 1024 << " KiB in total" << std::endl;
+
+    size_t parsed_count = 0;
+    double seconds = MeasureSeconds([&] {
+        for (size_t i = 0; i < pipeline_count; i++) {
+            VpjParser parser = vpjCreateParser();
+            vpjSetAcceptLegacyInvalidInputData(parser, true);
+            VpjData data{};
+            parsed_count += vpjParsePipelineJson(parser, jsons[i % jsons.size()].c_str(), &data, nullptr);
+            vpjDestroyParser(parser);
+        }
+    });
+    Report("parser per pipeline", pipeline_count, seconds, parsed_count);
+
+    VpjParser parser = vpjCreateParser();
+    vpjSetAcceptLegacyInvalidInputData(parser, true);
+
+    parsed_count = 0;
+    seconds = MeasureSeconds([&] {
+        for (size_t i = 0; i < pipeline_count; i++) {
+            VpjData data{};
+            parsed_count += vpjParsePipelineJson(parser, jsons[i % jsons.size()].c_str(), &data, nullptr);
+            if ((i + 1) % kOutputBatchSize == 0) {
+                vpjFreeParserOutputs(parser);
+            }
+        }
+        vpjFreeParserOutputs(parser);
+    });
+    Report("reused parser", pipeline_count, seconds, parsed_count);
+
+    parsed_count = 0;
+    seconds = MeasureSeconds([&] {
+        for (size_t i = 0; i < pipeline_count; i++) {
+            const std::string& json = jsons[i % jsons.size()];
+            VpjData data{};
+            parsed_count += vpjParsePipelineJsonWithSize(parser, json.data(), json.size(), &data, nullptr);
+            if ((i + 1) % kOutputBatchSize == 0) {
+                vpjFreeParserOutputs(parser);
+            }
+        }
+        vpjFreeParserOutputs(parser);
+    });
+    Report("reused parser, with size", pipeline_count, seconds, parsed_count);
+
+    vpjSetStreamingParsing(parser, true);
+
+    parsed_count = 0;
+    seconds = MeasureSeconds([&] {
+        for (size_t i = 0; i < pipeline_count; i++) {
+            const std::string& json = jsons[i % jsons.size()];
+            VpjData data{};
+            parsed_count += vpjParsePipelineJsonWithSize(parser, json.data(), json.size(), &data, nullptr);
+            if ((i + 1) % kOutputBatchSize == 0) {
+                vpjFreeParserOutputs(parser);
+            }
+        }
+        vpjFreeParserOutputs(parser);
+    });
+    Report("streaming parser, with size", pipeline_count, seconds, parsed_count);
+
+    // Inputs of the batch parser, each batch holds the pipelines of kOutputBatchSize sequential parses per thread
+    std::vector<const char*> batch_jsons(pipeline_count);
+    std::vector<size_t> batch_sizes(pipeline_count);
+    for (size_t i = 0; i < pipeline_count; i++) {
+        batch_jsons[i] = jsons[i % jsons.size()].data();
+        batch_sizes[i] = jsons[i % jsons.size()].size();
+    }
+    const size_t batch_size = kOutputBatchSize * std::max(std::thread::hardware_concurrency(), 1u);
+    std::vector<VpjData> batch_data(batch_size);
+    std::unique_ptr<bool[]> batch_results(new bool[batch_size]);
+
+    parsed_count = 0;
+    seconds = MeasureSeconds([&] {
+        for (size_t i = 0; i < pipeline_count; i += batch_size) {
+            const uint32_t count = static_cast<uint32_t>(std::min(batch_size, pipeline_count - i));
+            vpjParsePipelineJsonBatch(parser, count, &batch_jsons[i], &batch_sizes[i], batch_data.data(), batch_results.get(),
+                                      nullptr);
+            parsed_count += std::count(batch_results.get(), batch_results.get() + count, true);
+            vpjFreeParserOutputs(parser);
+        }
+    });
+    Report("streaming batch parser", pipeline_count, seconds, parsed_count);
+
+    vpjDestroyParser(parser);
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,95 @@
+/*
+ * Copyright (c) 2025 The Khronos Group Inc.
+ * Copyright (c) 2025 RasterGrid Kft.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+// Micro-benchmark of the enum constant name lookups of the pipeline JSON parser.
+//
+// Looks up all VkFormat and VkDynamicState names in the generated perfect hash tables, and for comparison in an
+// std::unordered_map holding the same names. This is not registered as a test, run the executable manually:
+//   pcjson_name_table_benchmark [<iteration count>]
+
+#include "vksc_pipeline_json_parse.hpp"
+
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace {
+
+template <typename F>
+double MeasureSeconds(F&& f) {
+    auto begin = std::chrono::steady_clock::now();
+    f();
+    auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double>(end - begin).count();
+}
+
+void Report(const char* type_name, const char* variant, size_t lookup_count, double seconds) {
+    std::cout << std::left << std::setw(16) << type_name << std::setw(16) << variant << std::right << std::setw(10) << lookup_count
+              << " lookups  " << std::fixed << std::setprecision(3) << std::setw(10) << seconds * 1e3 << " ms  " << std::setw(8)
+              << std::setprecision(2) << seconds * 1e9 / double(lookup_count) << " ns/lookup" << std::endl;
+}
+
+// Looks up all names of <table> <iteration_count> times with both the table and an std::unordered_map
+template <typename T, size_t BucketCount, size_t EntryCount>
+bool Benchmark(const char* type_name, const pcjson::NameTable<T, BucketCount, EntryCount>& table, size_t iteration_count) {
+    // The names are copied so that the lookups do not get the string storage of the table entries
+    std::vector<std::string> names;
+    for (const auto& entry : table.entries) {
+        names.emplace_back(entry.name);
+    }
+    const size_t lookup_count = iteration_count * names.size();
+
+    uint64_t table_sum = 0;
+    double seconds = MeasureSeconds([&] {
+        for (size_t i = 0; i < iteration_count; i++) {
+            for (const auto& name : names) {
+                const auto* entry = table.Find(name.c_str());
+                table_sum += entry != nullptr ? uint64_t(entry->value) : 0;
+            }
+        }
+    });
+    Report(type_name, "perfect hash", lookup_count, seconds);
+
+    // The map construction is measured too, the parser used to pay it at the first lookup of each type
+    uint64_t map_sum = 0;
+    seconds = MeasureSeconds([&] {
+        std::unordered_map<std::string_view, T> map;
+        for (const auto& entry : table.entries) {
+            map.emplace(entry.name, entry.value);
+        }
+        for (size_t i = 0; i < iteration_count; i++) {
+            for (const auto& name : names) {
+                auto it = map.find(name.c_str());
+                map_sum += it != map.end() ? uint64_t(it->second) : 0;
+            }
+        }
+    });
+    Report(type_name, "unordered_map", lookup_count, seconds);
+
+    return table_sum == map_sum;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    const size_t iteration_count = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 20000;
+
+    bool success = true;
+    success &= Benchmark("VkFormat", pcjson::kVkFormatNames, iteration_count);
+    success &= Benchmark("VkDynamicState", pcjson::kVkDynamicStateNames, iteration_count);
+    if (!success) {
+        std::cerr << "Lookup results of the perfect hash tables and the maps differ" << std::endl;
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
@@ -12,7 +12,10 @@
 
 #include <assert.h>
 #include <stddef.h>
+#include <filesystem>
+#include <fstream>
 #include <iostream>
+#include <sstream>
 #include <string.h>
 #include <vector>
 #include <string>
@@ -162,6 +165,60 @@ TEST_F(Parse, BasicTypesVkBool32) {
     test_eq(R"(4294967295)", 4294967295);
 }
 
+TEST_F(Parse, FlagsStrings) {
+    TEST_DESCRIPTION("Tests the accepted forms of flags strings");
+
+    // Generates JSON representing a VkDescriptorSetLayoutCreateInfo struct with the desired stageFlags value (JSON fragment)
+    auto get_json = [](const char* val) {
+        return std::string{R"({
+            "sType" : "VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO",
+            "pNext" : "NULL",
+            "flags" : 0,
+            "bindingCount" : 1,
+            "pBindings" : [
+                {
+                    "binding" : 0,
+                    "descriptorType" : "VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER",
+                    "descriptorCount" : 1,
+                    "stageFlags" : )"} +
+               val + R"(,
+                    "pImmutableSamplers" : "NULL"
+                }
+            ]
+        })";
+    };
+
+    auto test_eq = [&](const char* frag, bool expect_success, VkShaderStageFlags expect) {
+        for (bool streaming : {false, true}) {
+            vpjSetStreamingParsing(this->parser_, streaming);
+            std::string json = get_json(frag);
+            VkDescriptorSetLayoutCreateInfo data{};
+            EXPECT_EQ(vpjParseSingleStructJson(this->parser_, json.c_str(), &data, &msg_), expect_success) << frag;
+            if (expect_success) {
+                EXPECT_EQ(data.pBindings[0].stageFlags, expect) << frag;
+            }
+        }
+    };
+
+    const VkShaderStageFlags vs_fs = VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT;
+    test_eq(R"(0)", true, 0);
+    test_eq(R"("0")", true, 0);
+    test_eq(R"("NULL")", true, 0);
+    test_eq(R"("")", true, 0);
+    test_eq(R"("VK_SHADER_STAGE_VERTEX_BIT")", true, VK_SHADER_STAGE_VERTEX_BIT);
+    test_eq(R"("VK_SHADER_STAGE_VERTEX_BIT|VK_SHADER_STAGE_FRAGMENT_BIT")", true, vs_fs);
+    test_eq(R"("VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT")", true, vs_fs);
+    test_eq(R"("  VK_SHADER_STAGE_VERTEX_BIT\t|\n VK_SHADER_STAGE_FRAG MENT_BIT ")", true, vs_fs);
+    test_eq(R"("VK_SHADER_STAGE_VERTEX_BIT|")", true, VK_SHADER_STAGE_VERTEX_BIT);
+    test_eq(R"(" 0 | VK_SHADER_STAGE_VERTEX_BIT")", true, VK_SHADER_STAGE_VERTEX_BIT);
+
+    // Empty names before or between separators, and unknown names are errors
+    test_eq(R"("|VK_SHADER_STAGE_VERTEX_BIT")", false, 0);
+    test_eq(R"("VK_SHADER_STAGE_VERTEX_BIT||VK_SHADER_STAGE_FRAGMENT_BIT")", false, 0);
+    test_eq(R"("VK_SHADER_STAGE_VERTEX_BIT | ")", false, 0);
+    test_eq(R"("VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_UNKNOWN_BIT")", false, 0);
+}
+
 TEST_F(Parse, VkPhysicalDeviceFeatures2) {
     TEST_DESCRIPTION("Tests parsing of a reasonably complex physical device features 2 JSON");
 
@@ -412,6 +469,22 @@ TEST_F(Parse, ComputePipelineJSON) {
     CHECK_PARSE(vpjParsePipelineJson(this->parser_, json.c_str(), &data, &msg_));
 
     CompareData<VpjComputePipelineState>(ref_data, data);
+
+    // The parser state is reused by subsequent calls, and the input of vpjParsePipelineJsonWithSize does not need to be
+    // null-terminated
+    vpjFreeParserOutputs(this->parser_);
+    const std::string padded_json = json + "}}garbage";
+    VpjData data_with_size{};
+    CHECK_PARSE(vpjParsePipelineJsonWithSize(this->parser_, padded_json.data(), json.size(), &data_with_size, &msg_));
+
+    CompareData<VpjComputePipelineState>(ref_data, data_with_size);
+
+    // The streaming parser produces the same output
+    vpjSetStreamingParsing(this->parser_, true);
+    VpjData streamed_data{};
+    CHECK_PARSE(vpjParsePipelineJsonWithSize(this->parser_, padded_json.data(), json.size(), &streamed_data, &msg_));
+
+    CompareData<VpjComputePipelineState>(ref_data, streamed_data);
 }
 
 TEST_F(Parse, GraphicsPipelineJSON) {
@@ -530,6 +603,14 @@ TEST_F(Parse, GraphicsPipelineJSON) {
     CHECK_PARSE(true);
 
     CompareData<VpjGraphicsPipelineState>(ref_data, data);
+
+    // The streaming parser produces the same output
+    vpjSetStreamingParsing(this->parser_, true);
+    VpjData streamed_data{};
+    EXPECT_TRUE(vpjParsePipelineJson(this->parser_, json.c_str(), &streamed_data, &msg_));
+    CHECK_PARSE(true);
+
+    CompareData<VpjGraphicsPipelineState>(ref_data, streamed_data);
 }
 
 TEST_F(Parse, ObjectNameRemapping) {
@@ -855,6 +936,61 @@ TEST_F(Parse, ObjectNameRemapping) {
     EXPECT_EQ(uint64_t(descriptorSetLayouts[2].pBindings[0].pImmutableSamplers[1]), 1);
 }
 
+TEST_F(Parse, ObjectNameRemappingStreaming) {
+    TEST_DESCRIPTION("Tests that the streaming parser remaps object names the same way as the DOM parser");
+
+    std::ifstream file(PCJSON_TEST_DATA_PATH "compute_w_arbitrary_names.json", std::ios::binary);
+    std::stringstream contents;
+    contents << file.rdbuf();
+    const std::string json = contents.str();
+    ASSERT_FALSE(json.empty());
+
+    vpjSetStreamingParsing(this->parser_, true);
+
+    VpjData data{};
+    EXPECT_TRUE(vpjParsePipelineJson(this->parser_, json.c_str(), &data, &msg_));
+    CHECK_PARSE(true);
+
+    EXPECT_STREQ(data.computePipelineState.ppYcbcrSamplerNames[0], "ycbcr_conversion_1");
+    EXPECT_STREQ(data.computePipelineState.ppYcbcrSamplerNames[1], "ycbcr_conversion_2");
+    EXPECT_STREQ(data.computePipelineState.ppYcbcrSamplerNames[2], "ycbcr_conversion_3");
+
+    EXPECT_STREQ(data.computePipelineState.ppImmutableSamplerNames[0], "immutable_sampler_1");
+    EXPECT_STREQ(data.computePipelineState.ppImmutableSamplerNames[1], "immutable_sampler_2");
+    EXPECT_STREQ(data.computePipelineState.ppImmutableSamplerNames[2], "immutable_sampler_3");
+
+    EXPECT_STREQ(data.computePipelineState.ppDescriptorSetLayoutNames[0], "descriptor_layout_1");
+    EXPECT_STREQ(data.computePipelineState.ppDescriptorSetLayoutNames[1], "descriptor_layout_2");
+    EXPECT_STREQ(data.computePipelineState.ppDescriptorSetLayoutNames[2], "descriptor_layout_3");
+
+    const auto pipelineLayout = reinterpret_cast<const VkPipelineLayoutCreateInfo*>(data.computePipelineState.pPipelineLayout);
+    EXPECT_EQ(uint64_t(pipelineLayout->pSetLayouts[0]), 2);
+    EXPECT_EQ(uint64_t(pipelineLayout->pSetLayouts[1]), 0);
+    EXPECT_EQ(uint64_t(pipelineLayout->pSetLayouts[2]), 1);
+
+    EXPECT_EQ(data.computePipelineState.immutableSamplerCount, 3);
+
+    const auto immutableSamplers = reinterpret_cast<const VkSamplerCreateInfo*>(data.computePipelineState.pImmutableSamplers);
+
+    const auto ycbcrConversionInfo_0 = reinterpret_cast<const VkSamplerYcbcrConversionInfo*>(immutableSamplers[2].pNext);
+    EXPECT_EQ(uint64_t(ycbcrConversionInfo_0->conversion), 0);
+
+    const auto ycbcrConversionInfo_1 = reinterpret_cast<const VkSamplerYcbcrConversionInfo*>(immutableSamplers[0].pNext);
+    EXPECT_EQ(uint64_t(ycbcrConversionInfo_1->conversion), 2);
+
+    const auto descriptorSetLayouts =
+        reinterpret_cast<const VkDescriptorSetLayoutCreateInfo*>(data.computePipelineState.pDescriptorSetLayouts);
+    EXPECT_EQ(descriptorSetLayouts[0].pBindings[0].descriptorCount, 2);
+
+    EXPECT_EQ(uint64_t(descriptorSetLayouts[0].pBindings[0].pImmutableSamplers[0]), 2);
+    EXPECT_EQ(uint64_t(descriptorSetLayouts[0].pBindings[0].pImmutableSamplers[1]), 0);
+
+    EXPECT_EQ(descriptorSetLayouts[2].pBindings[0].descriptorCount, 2);
+
+    EXPECT_EQ(uint64_t(descriptorSetLayouts[2].pBindings[0].pImmutableSamplers[0]), 0);
+    EXPECT_EQ(uint64_t(descriptorSetLayouts[2].pBindings[0].pImmutableSamplers[1]), 1);
+}
+
 TEST_F(Parse, ComputePipelineJSONAbove32Bit) {
     TEST_DESCRIPTION(
         "Tests parsing of a reasonably simple compute pipeline JSON with handles values not representable as 32-bit values");
@@ -1724,3 +1860,132 @@ TEST_F(Parse, AcceptLegacyInvalidInputData) {
     EXPECT_EQ(po_ci->sType, VK_STRUCTURE_TYPE_PIPELINE_OFFLINE_CREATE_INFO);
     EXPECT_EQ(po_ci->poolEntrySize, 42);
 }
+
+TEST_F(Parse, StreamingParsingInvalidSyntax) {
+    TEST_DESCRIPTION("Tests that the streaming parser reports malformed pipeline JSON input");
+
+    vpjSetStreamingParsing(this->parser_, true);
+
+    const std::string json{R"({
+        "ComputePipelineState" : {
+            "ShaderFileNames" : [ { "stage" : "VK_SHADER_STAGE_COMPUTE_BIT", "filename" : "shader.spv" ]
+        }
+    })"};
+
+    VpjData data{};
+    EXPECT_FALSE(vpjParsePipelineJson(this->parser_, json.c_str(), &data, &msg_));
+    ASSERT_NE(msg_, nullptr);
+    EXPECT_NE(std::string(msg_).find("Failed to parse pipeline JSON"), std::string::npos) << msg_;
+
+    // A truncated input is reported the same way
+    EXPECT_FALSE(vpjParsePipelineJsonWithSize(this->parser_, json.data(), json.size() / 2, &data, &msg_));
+    ASSERT_NE(msg_, nullptr);
+    EXPECT_NE(std::string(msg_).find("Failed to parse pipeline JSON"), std::string::npos) << msg_;
+}
+
+TEST_F(Parse, StreamingParsingTestData) {
+    TEST_DESCRIPTION("Tests that the streaming parser produces the same pipeline data as the DOM parser for all test data files");
+
+    VpjParser streaming_parser = vpjCreateParser();
+    vpjSetStreamingParsing(streaming_parser, true);
+
+    VpjGenerator generator = vpjCreateGenerator();
+    auto generate = [&](const VpjData& data) {
+        const char* json = nullptr;
+        EXPECT_TRUE(vpjGeneratePipelineJson(generator, &data, &json, nullptr));
+        return std::string(json != nullptr ? json : "");
+    };
+
+    size_t file_count = 0;
+    for (const auto& entry : std::filesystem::directory_iterator(PCJSON_TEST_DATA_PATH)) {
+        std::ifstream file(entry.path(), std::ios::binary);
+        std::stringstream contents;
+        contents << file.rdbuf();
+        const std::string json = contents.str();
+        ++file_count;
+
+        for (bool legacy : {false, true}) {
+            vpjSetAcceptLegacyInvalidInputData(this->parser_, legacy);
+            vpjSetAcceptLegacyInvalidInputData(streaming_parser, legacy);
+
+            VpjData data{};
+            VpjData streamed_data{};
+            const bool result = vpjParsePipelineJson(this->parser_, json.c_str(), &data, nullptr);
+            const bool streamed_result = vpjParsePipelineJson(streaming_parser, json.c_str(), &streamed_data, nullptr);
+            EXPECT_EQ(result, streamed_result) << entry.path() << " legacy: " << legacy;
+            if (result && streamed_result) {
+                EXPECT_EQ(generate(data), generate(streamed_data)) << entry.path() << " legacy: " << legacy;
+            }
+        }
+    }
+    EXPECT_GT(file_count, 0u);
+
+    vpjDestroyGenerator(generator);
+    vpjDestroyParser(streaming_parser);
+}
+
+TEST_F(Parse, ParsePipelineJsonBatch) {
+    TEST_DESCRIPTION("Tests that parsing pipeline JSONs in parallel gives the same results as parsing them one by one");
+
+    std::vector<std::string> jsons;
+    for (const auto& entry : std::filesystem::directory_iterator(PCJSON_TEST_DATA_PATH)) {
+        std::ifstream file(entry.path(), std::ios::binary);
+        std::stringstream contents;
+        contents << file.rdbuf();
+        if (entry.path().extension() == ".json" && contents.str().find("PipelineState") != std::string::npos) {
+            jsons.push_back(contents.str());
+        }
+    }
+    ASSERT_FALSE(jsons.empty());
+    jsons.push_back(R"({ "ComputePipelineState" : { )");
+
+    // Replicate the inputs so that each thread gets several of them
+    constexpr uint32_t kCount = 64;
+    std::vector<const char*> batch_jsons(kCount);
+    std::vector<size_t> batch_sizes(kCount);
+    for (uint32_t i = 0; i < kCount; ++i) {
+        batch_jsons[i] = jsons[i % jsons.size()].data();
+        batch_sizes[i] = jsons[i % jsons.size()].size();
+    }
+
+    VpjGenerator generator = vpjCreateGenerator();
+    auto generate = [&](const VpjData& data) {
+        const char* json = nullptr;
+        EXPECT_TRUE(vpjGeneratePipelineJson(generator, &data, &json, nullptr));
+        return std::string(json != nullptr ? json : "");
+    };
+
+    for (bool streaming : {false, true}) {
+        vpjSetAcceptLegacyInvalidInputData(this->parser_, true);
+        vpjSetStreamingParsing(this->parser_, streaming);
+
+        VpjParser batch_parser = vpjCreateParser();
+        vpjSetAcceptLegacyInvalidInputData(batch_parser, true);
+        vpjSetStreamingParsing(batch_parser, streaming);
+        vpjSetParserThreadCount(batch_parser, 4);
+
+        std::vector<VpjData> batch_data(kCount);
+        std::unique_ptr<bool[]> batch_results(new bool[kCount]);
+        std::vector<const char*> batch_messages(kCount);
+        EXPECT_FALSE(vpjParsePipelineJsonBatch(batch_parser, kCount, batch_jsons.data(), batch_sizes.data(), batch_data.data(),
+                                               batch_results.get(), batch_messages.data()));
+
+        for (uint32_t i = 0; i < kCount; ++i) {
+            VpjData data{};
+            const char* messages = nullptr;
+            const bool result = vpjParsePipelineJsonWithSize(this->parser_, batch_jsons[i], batch_sizes[i], &data, &messages);
+            EXPECT_EQ(batch_results[i], result) << i;
+            EXPECT_STREQ(batch_messages[i], messages) << i;
+            if (result && batch_results[i]) {
+                EXPECT_EQ(generate(batch_data[i]), generate(data)) << i;
+            }
+        }
+
+        // Without sizes, the inputs are null-terminated strings
+        EXPECT_TRUE(vpjParsePipelineJsonBatch(batch_parser, 1, batch_jsons.data(), nullptr, batch_data.data(), nullptr, nullptr));
+
+        vpjDestroyParser(batch_parser);
+    }
+
+    vpjDestroyGenerator(generator);
+}
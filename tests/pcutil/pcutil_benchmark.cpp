@@ -0,0 +1,330 @@
+/*
+ * Copyright (c) 2025 The Khronos Group Inc.
+ * Copyright (c) 2025 RasterGrid Kft.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+// Micro-benchmarks for the pipeline cache reader and writer utilities.
+//
+// These are not registered as tests, run the executable manually to get the timings:
+//   pcutil_benchmark [<benchmark name>...]
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <vulkan/pcutil/pceditor.hpp>
+#include <vulkan/pcutil/pcreader.hpp>
+#include <vulkan/pcutil/pcwriter.hpp>
+
+#include <vulkan/vulkan_sc.h>
+
+namespace {
+
+// Deterministic pseudo-random pipeline identifiers, similar in distribution to MD5-based ones
+void GenIdentifier(uint32_t index, uint8_t identifier[VK_UUID_SIZE]) {
+    uint64_t state = 0x9E3779B97F4A7C15ULL * (uint64_t{index} + 1);
+    for (uint32_t i = 0; i < VK_UUID_SIZE; i++) {
+        state ^= state >> 29;
+        state *= 0xBF58476D1CE4E5B9ULL;
+        state ^= state >> 32;
+        identifier[i] = static_cast<uint8_t>(state);
+    }
+}
+
+struct BenchmarkCache {
+    std::vector<uint8_t> identifiers;
+    std::vector<uint8_t> data;
+};
+
+// Builds a cache of <pipeline_count> pipelines with <stage_count> stages of <code_size> bytes each
+BenchmarkCache BuildCache(uint32_t pipeline_count, uint32_t stage_count = 0, uint32_t code_size = 0) {
+    BenchmarkCache cache;
+    cache.identifiers.resize(size_t(pipeline_count) * VK_UUID_SIZE);
+
+    std::vector<uint8_t> code(code_size);
+    for (uint32_t i = 0; i < code_size; i++) {
+        code[i] = static_cast<uint8_t>(i * 7);
+    }
+
+    uint8_t const pipeline_cache_uuid[VK_UUID_SIZE] = {};
+    VKSCPipelineCacheHeaderWriter pcw(0x10de, 0xabcd, pipeline_cache_uuid);
+    pcw.allocatePipelineIndex(pipeline_count);
+
+    std::vector<std::unique_ptr<VKSCPipelineEntry>> entries(pipeline_count);
+    for (uint32_t i = 0; i < pipeline_count; i++) {
+        uint8_t *identifier = cache.identifiers.data() + size_t(i) * VK_UUID_SIZE;
+        GenIdentifier(i, identifier);
+        entries[i] = std::make_unique<VKSCPipelineEntry>(identifier, 1024 + i);
+        entries[i]->allocateStages(stage_count);
+        for (uint32_t j = 0; j < stage_count; j++) {
+            entries[i]->setShaderStageCode(j, code.size(), code.data());
+        }
+        pcw.setPipelineEntry(i, entries[i].get());
+    }
+
+    cache.data.resize(static_cast<size_t>(sizeof(VkPipelineCacheHeaderVersionSafetyCriticalOne) + pcw.getPipelineIndexSize() + 1));
+    pcw.writeHeaderSafetyCriticalOne(cache.data.size(), cache.data.data());
+    pcw.writePipelineIndex(cache.data.size(), cache.data.data());
+    return cache;
+}
+
+template <typename F>
+double MeasureSeconds(F &&f) {
+    auto begin = std::chrono::steady_clock::now();
+    f();
+    auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double>(end - begin).count();
+}
+
+void Report(const char *name, uint32_t pipeline_count, const char *variant, double seconds, uint64_t operations) {
+    std::cout << std::left << std::setw(24) << name << std::right << std::setw(8) << pipeline_count << " pipelines  " << std::left
+              << std::setw(12) << variant << std::right << std::fixed << std::setprecision(3) << std::setw(12) << seconds * 1e3
+              << " ms  " << std::setw(10) << std::setprecision(1) << seconds * 1e9 / double(operations) << " ns/op" << std::endl;
+}
+
+void BenchmarkPipelineLookup() {
+    for (uint32_t pipeline_count : {1000U, 10000U, 100000U}) {
+        BenchmarkCache cache = BuildCache(pipeline_count);
+        VKSCPipelineCacheHeaderReader pcr(cache.data.size(), cache.data.data());
+
+        // resolving every pipeline with the linear scan is quadratic, so sample the identifiers to keep the run time sane
+        uint32_t const lookup_count = std::min(pipeline_count, 2000U);
+        uint32_t const lookup_step = pipeline_count / lookup_count;
+        uint32_t found = 0;
+
+        double linear = MeasureSeconds([&] {
+            for (uint32_t i = 0; i < lookup_count; i++) {
+                found += pcr.getPipelineIndexEntry(cache.identifiers.data() + size_t(i) * lookup_step * VK_UUID_SIZE) != nullptr;
+            }
+        });
+        Report("pipeline lookup", pipeline_count, "linear", linear, lookup_count);
+
+        VKSCPipelineCacheIndex index(pcr);
+        double build = MeasureSeconds([&] { index.build(); });
+        Report("pipeline lookup", pipeline_count, "index build", build, pipeline_count);
+
+        double hashed = MeasureSeconds([&] {
+            for (uint32_t i = 0; i < lookup_count; i++) {
+                found += index.getPipelineIndexEntry(cache.identifiers.data() + size_t(i) * lookup_step * VK_UUID_SIZE) != nullptr;
+            }
+        });
+        Report("pipeline lookup", pipeline_count, "hashed", hashed, lookup_count);
+
+        std::vector<VkPipelineCacheSafetyCriticalIndexEntry const *> entries(pipeline_count);
+        double batched = MeasureSeconds([&] {
+            found += index.getPipelineIndexEntries(
+                pipeline_count, reinterpret_cast<uint8_t const(*)[VK_UUID_SIZE]>(cache.identifiers.data()), entries.data());
+        });
+        Report("pipeline lookup", pipeline_count, "batched all", batched, pipeline_count);
+
+        if (found != 2 * lookup_count + pipeline_count) {
+            std::cerr << "pipeline lookup: unexpected number of pipelines found" << std::endl;
+        }
+    }
+}
+
+void BenchmarkParallelWrite() {
+    uint32_t const stage_count = 3;
+    uint32_t const code_size = 8 * 1024;
+    std::vector<uint8_t> code(code_size);
+    for (uint32_t i = 0; i < code_size; i++) {
+        code[i] = static_cast<uint8_t>(i * 13);
+    }
+
+    for (uint32_t pipeline_count : {1000U, 5000U}) {
+        uint8_t const pipeline_cache_uuid[VK_UUID_SIZE] = {};
+        VKSCPipelineCacheHeaderWriter pcw(0x10de, 0xabcd, pipeline_cache_uuid);
+        pcw.allocatePipelineIndex(pipeline_count);
+
+        std::vector<std::unique_ptr<VKSCPipelineEntry>> entries(pipeline_count);
+        for (uint32_t i = 0; i < pipeline_count; i++) {
+            uint8_t identifier[VK_UUID_SIZE];
+            GenIdentifier(i, identifier);
+            entries[i] = std::make_unique<VKSCPipelineEntry>(identifier, 1024 + i);
+            entries[i]->allocateStages(stage_count);
+            for (uint32_t j = 0; j < stage_count; j++) {
+                entries[i]->setShaderStageCode(j, code.size(), code.data());
+            }
+            pcw.setPipelineEntry(i, entries[i].get());
+        }
+
+        // fault the output pages in upfront so that only the copying is measured
+        std::vector<uint8_t> data(static_cast<size_t>(pcw.getPipelineCacheSize() + 1), 0xcd);
+        std::cout << std::left << std::setw(24) << "parallel write" << std::right << std::setw(8) << pipeline_count
+                  << " pipelines  " << pcw.getPipelineCacheSize() / (1024 * 1024) << " MiB" << std::endl;
+
+        double serial = MeasureSeconds([&] { pcw.writePipelineIndex(data.size(), data.data()); });
+        Report("parallel write", pipeline_count, "serial", serial, pipeline_count);
+
+        uint32_t const max_thread_count = std::max(8U, std::thread::hardware_concurrency());
+        for (uint32_t thread_count = 1; thread_count <= max_thread_count; thread_count *= 2) {
+            double parallel = MeasureSeconds([&] { pcw.writePipelineIndexParallel(data.size(), data.data(), thread_count); });
+            std::string const variant = std::to_string(thread_count) + " threads";
+            Report("parallel write", pipeline_count, variant.c_str(), parallel, pipeline_count);
+        }
+    }
+}
+
+void BenchmarkIndexBuild() {
+    uint32_t const stage_count = 3;
+    std::vector<uint8_t> code(64, 0x5a);
+
+    for (uint32_t pipeline_count : {10000U, 100000U}) {
+        std::vector<uint8_t> identifiers(size_t(pipeline_count) * VK_UUID_SIZE);
+        for (uint32_t i = 0; i < pipeline_count; i++) {
+            GenIdentifier(i, identifiers.data() + size_t(i) * VK_UUID_SIZE);
+        }
+        uint8_t const pipeline_cache_uuid[VK_UUID_SIZE] = {};
+        uint64_t sizes[2] = {};
+
+        double pinned = MeasureSeconds([&] {
+            VKSCPipelineCacheHeaderWriter pcw(0x10de, 0xabcd, pipeline_cache_uuid);
+            pcw.allocatePipelineIndex(pipeline_count);
+            std::vector<std::unique_ptr<VKSCPipelineEntry>> entries(pipeline_count);
+            for (uint32_t i = 0; i < pipeline_count; i++) {
+                entries[i] = std::make_unique<VKSCPipelineEntry>(identifiers.data() + size_t(i) * VK_UUID_SIZE, 1024 + i);
+                entries[i]->allocateStages(stage_count);
+                for (uint32_t j = 0; j < stage_count; j++) {
+                    entries[i]->setShaderStageCode(j, code.size(), code.data());
+                }
+                pcw.setPipelineEntry(i, entries[i].get());
+            }
+            sizes[0] = pcw.getPipelineCacheSize();
+        });
+        Report("index build", pipeline_count, "pinned", pinned, pipeline_count);
+
+        double emplaced = MeasureSeconds([&] {
+            VKSCPipelineCacheHeaderWriter pcw(0x10de, 0xabcd, pipeline_cache_uuid);
+            pcw.reservePipelineEntries(pipeline_count, uint64_t{pipeline_count} * stage_count);
+            for (uint32_t i = 0; i < pipeline_count; i++) {
+                VKSCPipelineEntry *entry =
+                    pcw.emplacePipelineEntry(identifiers.data() + size_t(i) * VK_UUID_SIZE, 1024 + i, stage_count);
+                for (uint32_t j = 0; j < stage_count; j++) {
+                    entry->setShaderStageCode(j, code.size(), code.data());
+                }
+            }
+            sizes[1] = pcw.getPipelineCacheSize();
+        });
+        Report("index build", pipeline_count, "emplaced", emplaced, pipeline_count);
+
+        if (sizes[0] != sizes[1]) {
+            std::cerr << "index build: pipeline cache size mismatch" << std::endl;
+        }
+    }
+}
+
+void BenchmarkEdit() {
+    uint32_t const pipeline_count = 10000;
+    uint32_t const changed_count = 5;
+    BenchmarkCache cache = BuildCache(pipeline_count, 2, 4 * 1024);
+    cache.data.pop_back();
+
+    std::vector<uint8_t> code(4 * 1024, 0x3c);
+    std::vector<std::unique_ptr<VKSCPipelineEntry>> changed(changed_count);
+    for (uint32_t i = 0; i < changed_count; i++) {
+        changed[i] = std::make_unique<VKSCPipelineEntry>(cache.identifiers.data() + size_t(i) * 997 * VK_UUID_SIZE, 2048);
+        changed[i]->allocateStages(2);
+        changed[i]->setShaderStageCode(0, code.size(), code.data());
+        changed[i]->setShaderStageCode(1, code.size(), code.data());
+    }
+
+    std::cout << std::left << std::setw(24) << "edit" << std::right << std::setw(8) << pipeline_count << " pipelines  "
+              << cache.data.size() / (1024 * 1024) << " MiB, " << changed_count << " replaced" << std::endl;
+
+    // full rebuild: re-collect all pipelines from the existing cache and rewrite it
+    std::vector<uint8_t> rebuilt;
+    double rebuild = MeasureSeconds([&] {
+        VKSCPipelineCacheHeaderReader pcr(cache.data.size(), cache.data.data());
+        VKSCPipelineCacheIndex index(pcr);
+        index.build();
+        std::vector<VkPipelineCacheSafetyCriticalIndexEntry const *> replaced(changed_count);
+        for (uint32_t i = 0; i < changed_count; i++) {
+            replaced[i] = index.getPipelineIndexEntry(changed[i]->getIdentifier());
+        }
+
+        VKSCPipelineCacheHeaderWriter pcw(0x10de, 0xabcd, pcr.getHeaderVersionOne()->pipelineCacheUUID);
+        pcw.reservePipelineEntries(pipeline_count, uint64_t{pipeline_count} * 2);
+        for (VkPipelineCacheSafetyCriticalIndexEntry const &pie : pcr.pipelines()) {
+            auto const it = std::find(replaced.begin(), replaced.end(), &pie);
+            if (it != replaced.end()) {
+                VKSCPipelineEntry const &entry = *changed[size_t(it - replaced.begin())];
+                VKSCPipelineEntry *copy = pcw.emplacePipelineEntry(entry.getIdentifier(), entry.getMemorySize(), 2);
+                copy->setShaderStageCode(0, code.size(), code.data());
+                copy->setShaderStageCode(1, code.size(), code.data());
+            } else {
+                VKSCPipelineEntry *copy =
+                    pcw.emplacePipelineEntry(pie.pipelineIdentifier, pie.pipelineMemorySize, pie.stageIndexCount);
+                uint32_t j = 0;
+                for (VkPipelineCacheStageValidationIndexEntry const &sie : pcr.stages(pie)) {
+                    copy->setShaderStageCode(j++, sie.codeSize, pcr.getSPIRV(sie));
+                }
+            }
+        }
+        rebuilt.resize(static_cast<size_t>(pcw.getPipelineCacheSize() + 1));
+        pcw.writeHeaderSafetyCriticalOne(rebuilt.size(), rebuilt.data());
+        pcw.writePipelineIndex(rebuilt.size(), rebuilt.data());
+    });
+    Report("edit", pipeline_count, "rebuild", rebuild, changed_count);
+
+    // patch: append the replaced pipelines and a new pipeline index
+    std::vector<uint8_t> patch;
+    double append = MeasureSeconds([&] {
+        VKSCPipelineCacheHeaderReader pcr(cache.data.size(), cache.data.data());
+        pcr.verify();
+        VKSCPipelineCacheEditor editor(pcr);
+        editor.open();
+        for (uint32_t i = 0; i < changed_count; i++) {
+            editor.setPipelineEntry(changed[i].get());
+        }
+        VKSCPipelineCacheCallbackSink sink(
+            [](void *user_data, uint8_t const *data, uint64_t size) {
+                auto output = static_cast<std::vector<uint8_t> *>(user_data);
+                output->insert(output->end(), data, data + size);
+                return true;
+            },
+            &patch);
+        editor.writeAppendedData(sink);
+    });
+    Report("edit", pipeline_count, "append", append, changed_count);
+
+    if (patch.empty() || rebuilt.empty()) {
+        std::cerr << "edit: no output" << std::endl;
+    }
+}
+
+struct Benchmark {
+    const char *name;
+    void (*run)();
+};
+
+const Benchmark kBenchmarks[] = {
+    {"lookup", BenchmarkPipelineLookup},
+    {"write", BenchmarkParallelWrite},
+    {"build", BenchmarkIndexBuild},
+    {"edit", BenchmarkEdit},
+};
+
+}  // namespace
+
+int main(int argc, char **argv) {
+    for (const Benchmark &benchmark : kBenchmarks) {
+        bool selected = argc < 2;
+        for (int i = 1; i < argc; i++) {
+            selected |= strcmp(argv[i], benchmark.name) == 0;
+        }
+        if (selected) {
+            benchmark.run();
+        }
+    }
+    return EXIT_SUCCESS;
+}
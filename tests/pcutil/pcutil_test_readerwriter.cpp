@@ -7,8 +7,15 @@
 
 #include <gtest/gtest.h>
 
+#include <vulkan/pcutil/pceditor.hpp>
+#include <vulkan/pcutil/pcfile.hpp>
 #include <vulkan/pcutil/pcreader.hpp>
 
+#include <cstdio>
+#include <map>
+#include <memory>
+#include <string>
+
 #include "pcutil_test_writer_helper.h"
 
 bool ReadAndValidate(VKSCPipelineCacheHeaderReader &pcr, std::vector<uint8_t> &cache, const PCWriterTestData &td) {
@@ -315,3 +322,1287 @@ TEST(ReaderWriter, CustomJson) {
         EXPECT_TRUE(ReadAndValidate(pcr, cache, test_data));
     }
 }
+
+TEST(ReaderWriter, HashedPipelineIndex) {
+    std::vector<uint8_t> cache(PCWriterTestData::default_cache_size_);
+
+    PCWriterTestData test_data(__LINE__);
+    test_data.GenPipelineEntries(257, 2);
+    test_data.GenPipelineJsonData();
+    test_data.GenPipelineVendorData(19);
+
+    {
+        VKSCPipelineCacheHeaderWriter pcw(test_data.vendor_id_, test_data.device_id_, test_data.pipeline_cache_uuid_);
+        WriteTestDataToCache(pcw, cache, test_data);
+    }
+
+    {
+        VKSCPipelineCacheHeaderReader pcr(cache.size(), cache.data());
+        EXPECT_TRUE(pcr.isValid());
+
+        VKSCPipelineCacheIndex index(pcr);
+        EXPECT_FALSE(index.isBuilt());
+        EXPECT_FALSE(index.getPipelineIndexEntry(test_data.pipeline_test_datas_[0].uuid));
+
+        EXPECT_TRUE(index.build());
+        EXPECT_TRUE(index.isBuilt());
+        EXPECT_FALSE(index.build());
+
+        uint32_t identifier_count = uint32_t(test_data.pipeline_test_datas_.size() + 1);
+        std::vector<uint8_t> identifiers(identifier_count * VK_UUID_SIZE);
+        for (size_t i = 0; i < test_data.pipeline_test_datas_.size(); i++) {
+            const auto &uuid = test_data.pipeline_test_datas_[i].uuid;
+            EXPECT_EQ(index.getPipelineIndexEntry(uuid), pcr.getPipelineIndexEntry(uuid));
+            memcpy(identifiers.data() + i * VK_UUID_SIZE, uuid, VK_UUID_SIZE);
+        }
+
+        // query non existent pipeline entry by id
+        uint8_t missing_uuid[VK_UUID_SIZE] = {0xff, 0xff, 0xff, 0xff};
+        EXPECT_FALSE(index.getPipelineIndexEntry(missing_uuid));
+        memcpy(identifiers.data() + (identifier_count - 1) * VK_UUID_SIZE, missing_uuid, VK_UUID_SIZE);
+
+        std::vector<VkPipelineCacheSafetyCriticalIndexEntry const *> entries(identifier_count);
+        EXPECT_EQ(index.getPipelineIndexEntries(
+                      identifier_count, reinterpret_cast<uint8_t const(*)[VK_UUID_SIZE]>(identifiers.data()), entries.data()),
+                  uint32_t(test_data.pipeline_test_datas_.size()));
+        for (size_t i = 0; i < test_data.pipeline_test_datas_.size(); i++) {
+            EXPECT_EQ(entries[i], pcr.getPipelineIndexEntry(uint32_t(i)));
+        }
+        EXPECT_FALSE(entries.back());
+    }
+}
+
+TEST(ReaderWriter, HashedPipelineIndexDuplicateIdentifiers) {
+    std::vector<uint8_t> cache(PCWriterTestData::default_cache_size_);
+
+    PCWriterTestData test_data(__LINE__);
+    test_data.GenPipelineEntries(5, 1);
+    memcpy(test_data.pipeline_test_datas_[3].uuid, test_data.pipeline_test_datas_[1].uuid, VK_UUID_SIZE);
+
+    {
+        VKSCPipelineCacheHeaderWriter pcw(test_data.vendor_id_, test_data.device_id_, test_data.pipeline_cache_uuid_);
+        WriteTestDataToCache(pcw, cache, test_data);
+    }
+
+    {
+        VKSCPipelineCacheHeaderReader pcr(cache.size(), cache.data());
+        VKSCPipelineCacheIndex index(pcr);
+        EXPECT_TRUE(index.build());
+
+        // duplicates resolve to the first entry just like the linear lookup does
+        EXPECT_EQ(index.getPipelineIndexEntry(test_data.pipeline_test_datas_[1].uuid), pcr.getPipelineIndexEntry(1));
+        EXPECT_EQ(index.getPipelineIndexEntry(test_data.pipeline_test_datas_[1].uuid),
+                  pcr.getPipelineIndexEntry(test_data.pipeline_test_datas_[1].uuid));
+    }
+}
+
+TEST(ReaderWriter, HashedPipelineIndexMalformed) {
+    std::vector<uint8_t> cache(PCWriterTestData::default_cache_size_);
+
+    PCWriterTestData test_data(__LINE__);
+    test_data.GenPipelineEntries(3, 1);
+
+    {
+        VKSCPipelineCacheHeaderWriter pcw(test_data.vendor_id_, test_data.device_id_, test_data.pipeline_cache_uuid_);
+        WriteTestDataToCache(pcw, cache, test_data);
+    }
+
+    {
+        // truncate the cache in the middle of the pipeline index
+        uint64_t truncated_size =
+            sizeof(VkPipelineCacheHeaderVersionSafetyCriticalOne) + sizeof(VkPipelineCacheSafetyCriticalIndexEntry);
+        VKSCPipelineCacheHeaderReader pcr(truncated_size, cache.data());
+        VKSCPipelineCacheIndex index(pcr);
+        EXPECT_FALSE(index.build());
+        EXPECT_FALSE(index.isBuilt());
+        EXPECT_FALSE(index.getPipelineIndexEntry(test_data.pipeline_test_datas_[0].uuid));
+    }
+}
+
+TEST(ReaderWriter, CacheFile) {
+    std::vector<uint8_t> cache(PCWriterTestData::default_cache_size_);
+
+    PCWriterTestData test_data(__LINE__);
+    test_data.GenPipelineEntries(7, 3);
+    test_data.GenPipelineJsonData();
+    test_data.GenShaderStageVendorData(17);
+
+    {
+        VKSCPipelineCacheHeaderWriter pcw(test_data.vendor_id_, test_data.device_id_, test_data.pipeline_cache_uuid_);
+        WriteTestDataToCache(pcw, cache, test_data);
+    }
+
+    std::string path = testing::TempDir() + "pcutil_test_cache_file.bin";
+    {
+        FILE *file = fopen(path.c_str(), "wb");
+        ASSERT_TRUE(file);
+        EXPECT_EQ(fwrite(cache.data(), 1, cache.size(), file), cache.size());
+        fclose(file);
+    }
+
+    for (bool allow_mapping : {true, false}) {
+        VKSCPipelineCacheFile cache_file;
+        EXPECT_FALSE(cache_file.isOpen());
+        EXPECT_TRUE(cache_file.open(path.c_str(), allow_mapping));
+        EXPECT_TRUE(cache_file.isOpen());
+        EXPECT_EQ(cache_file.isMapped(), allow_mapping);
+        EXPECT_FALSE(cache_file.open(path.c_str(), allow_mapping));
+
+        ASSERT_EQ(cache_file.getSize(), cache.size());
+        EXPECT_TRUE(memcmp(cache_file.getData(), cache.data(), cache.size()) == 0);
+
+        VKSCPipelineCacheHeaderReader pcr(cache_file.getSize(), cache_file.getData());
+        EXPECT_TRUE(pcr.isValid());
+        std::vector<uint8_t> file_contents(cache_file.getData(), cache_file.getData() + cache_file.getSize());
+        EXPECT_TRUE(ReadAndValidate(pcr, file_contents, test_data));
+
+        cache_file.close();
+        EXPECT_FALSE(cache_file.isOpen());
+        EXPECT_EQ(cache_file.getSize(), 0u);
+    }
+
+    {
+        VKSCPipelineCacheFile cache_file;
+        EXPECT_FALSE(cache_file.open((path + ".missing").c_str()));
+        EXPECT_FALSE(cache_file.isOpen());
+    }
+
+    remove(path.c_str());
+}
+
+TEST(ReaderWriter, VerifyAndUncheckedView) {
+    std::vector<uint8_t> cache(PCWriterTestData::default_cache_size_);
+
+    PCWriterTestData test_data(__LINE__);
+    test_data.GenPipelineEntries(9, 3);
+    test_data.GenPipelineJsonData();
+    test_data.GenPipelineVendorData(13);
+    test_data.GenShaderStageVendorData(7);
+    test_data.GenGlobalVendorData(33);
+
+    {
+        VKSCPipelineCacheHeaderWriter pcw(test_data.vendor_id_, test_data.device_id_, test_data.pipeline_cache_uuid_);
+        WriteTestDataToCache(pcw, cache, test_data);
+    }
+
+    {
+        VKSCPipelineCacheHeaderReader pcr(cache.size(), cache.data());
+        EXPECT_FALSE(pcr.isVerified());
+        EXPECT_TRUE(pcr.verify());
+        EXPECT_TRUE(pcr.isVerified());
+
+        VKSCPipelineCacheUncheckedView view = pcr.getUncheckedView();
+        ASSERT_EQ(view.getPipelineIndexCount(), pcr.getPipelineIndexCount());
+        for (uint32_t pipe_index = 0; pipe_index < view.getPipelineIndexCount(); pipe_index++) {
+            VkPipelineCacheSafetyCriticalIndexEntry const *pie = view.getPipelineIndexEntry(pipe_index);
+            EXPECT_EQ(pie, pcr.getPipelineIndexEntry(pipe_index));
+            EXPECT_EQ(view.getJson(*pie), pcr.getJson(*pie));
+
+            for (uint32_t stage_id = 0; stage_id < pie->stageIndexCount; stage_id++) {
+                VkPipelineCacheStageValidationIndexEntry const *sie = view.getStageIndexEntry(*pie, stage_id);
+                EXPECT_EQ(sie, pcr.getStageIndexEntry(*pie, stage_id));
+                EXPECT_EQ(view.getSPIRV(*sie), pcr.getSPIRV(*sie));
+            }
+        }
+    }
+
+    {
+        // a cache truncated below the size of the header is not valid
+        VKSCPipelineCacheHeaderReader pcr(sizeof(VkPipelineCacheHeaderVersionSafetyCriticalOne) - 1, cache.data());
+        EXPECT_FALSE(pcr.isValid());
+        EXPECT_FALSE(pcr.verify());
+    }
+}
+
+TEST(ReaderWriter, VerifyCorrupted) {
+    std::vector<uint8_t> cache(PCWriterTestData::default_cache_size_);
+
+    PCWriterTestData test_data(__LINE__);
+    test_data.GenPipelineEntries(4);
+    test_data.GenShaderStages(2, 2);
+    test_data.GenPipelineJsonData();
+
+    {
+        VKSCPipelineCacheHeaderWriter pcw(test_data.vendor_id_, test_data.device_id_, test_data.pipeline_cache_uuid_);
+        WriteTestDataToCache(pcw, cache, test_data);
+    }
+
+    // applies <corrupt> to a copy of the cache and returns the result of verify on it
+    auto verify_corrupted = [&cache](auto corrupt) {
+        std::vector<uint8_t> corrupted(cache);
+        VKSCPipelineCacheHeaderReader pcr(corrupted.size(), corrupted.data());
+        auto pie = const_cast<VkPipelineCacheSafetyCriticalIndexEntry *>(pcr.getPipelineIndexEntry(2));
+        auto sie = const_cast<VkPipelineCacheStageValidationIndexEntry *>(pcr.getStageIndexEntry(*pie, 1));
+        auto sc1 = reinterpret_cast<VkPipelineCacheHeaderVersionSafetyCriticalOne *>(corrupted.data());
+        corrupt(*sc1, *pie, *sie);
+        bool verified = pcr.verify();
+        EXPECT_EQ(verified, pcr.isVerified());
+        return verified;
+    };
+
+    using SC1 = VkPipelineCacheHeaderVersionSafetyCriticalOne;
+    using PIE = VkPipelineCacheSafetyCriticalIndexEntry;
+    using SIE = VkPipelineCacheStageValidationIndexEntry;
+
+    EXPECT_TRUE(verify_corrupted([](SC1 &, PIE &, SIE &) {}));
+
+    // pipeline index
+    EXPECT_FALSE(verify_corrupted([](SC1 &sc1, PIE &, SIE &) { sc1.pipelineIndexOffset = 4; }));
+    EXPECT_FALSE(verify_corrupted([](SC1 &sc1, PIE &, SIE &) { sc1.pipelineIndexStride = sizeof(PIE) - 8; }));
+    EXPECT_FALSE(verify_corrupted([](SC1 &sc1, PIE &, SIE &) { sc1.pipelineIndexCount = 0xffffffff; }));
+
+    // stage index
+    EXPECT_FALSE(verify_corrupted([](SC1 &, PIE &pie, SIE &) { pie.stageIndexStride = sizeof(SIE) - 4; }));
+    EXPECT_FALSE(
+        verify_corrupted([](SC1 &, PIE &pie, SIE &) { pie.stageIndexOffset = PCWriterTestData::default_cache_size_ - 8; }));
+    EXPECT_FALSE(verify_corrupted([](SC1 &, PIE &pie, SIE &) { pie.stageIndexOffset = 8; }));
+    EXPECT_FALSE(verify_corrupted([](SC1 &sc1, PIE &pie, SIE &) { pie.stageIndexOffset = sc1.pipelineIndexOffset; }));
+
+    // json
+    EXPECT_FALSE(verify_corrupted([](SC1 &, PIE &pie, SIE &) { pie.jsonOffset = 0xffffffffffffff00ULL; }));
+    EXPECT_FALSE(verify_corrupted([](SC1 &, PIE &pie, SIE &) { pie.jsonSize = 0xffffffffffffff00ULL; }));
+    EXPECT_FALSE(verify_corrupted([](SC1 &sc1, PIE &pie, SIE &) { pie.jsonOffset = sc1.pipelineIndexOffset + 4; }));
+    EXPECT_FALSE(verify_corrupted([](SC1 &, PIE &pie, SIE &) { pie.jsonOffset = pie.stageIndexOffset; }));
+    EXPECT_FALSE(verify_corrupted([](SC1 &, PIE &pie, SIE &) { pie.jsonOffset = 0; }));
+
+    // SPIR-V
+    EXPECT_FALSE(verify_corrupted([](SC1 &, PIE &, SIE &sie) { sie.codeSize -= 1; }));
+    EXPECT_FALSE(verify_corrupted([](SC1 &, PIE &, SIE &sie) { sie.codeOffset = PCWriterTestData::default_cache_size_ - 4; }));
+    EXPECT_FALSE(verify_corrupted([](SC1 &, PIE &, SIE &sie) { sie.codeOffset = 16; }));
+    EXPECT_FALSE(verify_corrupted([](SC1 &, PIE &, SIE &sie) { sie.codeOffset = 0; }));
+
+    // payloads may legitimately be shared between pipelines and stages
+    EXPECT_TRUE(verify_corrupted([](SC1 &, PIE &pie, SIE &) {
+        pie.jsonOffset = 0;
+        pie.jsonSize = 0;
+    }));
+    EXPECT_TRUE(verify_corrupted([&cache](SC1 &, PIE &, SIE &sie) {
+        VKSCPipelineCacheHeaderReader pcr(cache.size(), cache.data());
+        sie.codeOffset = pcr.getStageIndexEntry(*pcr.getPipelineIndexEntry(2U), 0)->codeOffset;
+    }));
+}
+
+TEST(ReaderWriter, PipelineAndStageRanges) {
+    std::vector<uint8_t> cache(PCWriterTestData::default_cache_size_);
+
+    PCWriterTestData test_data(__LINE__);
+    test_data.GenPipelineEntries(6);
+    for (uint32_t i = 0; i < 6; i++) {
+        test_data.GenShaderStages(i, i % 4);
+    }
+    test_data.GenPipelineVendorData(11);
+    test_data.GenShaderStageVendorData(5);
+
+    {
+        VKSCPipelineCacheHeaderWriter pcw(test_data.vendor_id_, test_data.device_id_, test_data.pipeline_cache_uuid_);
+        WriteTestDataToCache(pcw, cache, test_data);
+    }
+
+    {
+        VKSCPipelineCacheHeaderReader pcr(cache.size(), cache.data());
+        VKSCPipelineIndexRange pipelines = pcr.pipelines();
+        ASSERT_EQ(pipelines.size(), pcr.getPipelineIndexCount());
+
+        uint32_t pipe_index = 0;
+        for (VkPipelineCacheSafetyCriticalIndexEntry const &pie : pipelines) {
+            EXPECT_EQ(&pie, pcr.getPipelineIndexEntry(pipe_index));
+            EXPECT_EQ(&pie, &pipelines[pipe_index]);
+
+            VKSCStageIndexRange stages = pcr.stages(pie);
+            EXPECT_EQ(stages.size(), pie.stageIndexCount);
+            EXPECT_EQ(stages.empty(), pie.stageIndexCount == 0);
+
+            uint32_t stage_id = 0;
+            for (VkPipelineCacheStageValidationIndexEntry const &sie : stages) {
+                EXPECT_EQ(&sie, pcr.getStageIndexEntry(pie, stage_id));
+                stage_id++;
+            }
+            EXPECT_EQ(stage_id, pie.stageIndexCount);
+            pipe_index++;
+        }
+        EXPECT_EQ(pipe_index, pcr.getPipelineIndexCount());
+
+        EXPECT_TRUE(pcr.verify());
+        VKSCPipelineCacheUncheckedView view = pcr.getUncheckedView();
+        EXPECT_EQ(view.pipelines().size(), pipelines.size());
+        EXPECT_TRUE(view.pipelines().begin() == pipelines.begin());
+        EXPECT_TRUE(view.pipelines().end() == pipelines.end());
+        EXPECT_TRUE(view.stages(pipelines[3]).begin() == pcr.stages(pipelines[3]).begin());
+        EXPECT_TRUE(view.stages(pipelines[3]).end() == pcr.stages(pipelines[3]).end());
+    }
+
+    {
+        // a truncated cache only yields the entries that lie within it
+        uint64_t truncated_size = sizeof(VkPipelineCacheHeaderVersionSafetyCriticalOne) +
+                                  2 * (sizeof(VkPipelineCacheSafetyCriticalIndexEntry) + test_data.per_pipeline_vendor_data_size_) +
+                                  sizeof(VkPipelineCacheSafetyCriticalIndexEntry);
+        VKSCPipelineCacheHeaderReader pcr(truncated_size, cache.data());
+        EXPECT_EQ(pcr.pipelines().size(), 3u);
+
+        uint32_t pipe_count = 0;
+        for (VkPipelineCacheSafetyCriticalIndexEntry const &pie : pcr.pipelines()) {
+            EXPECT_TRUE(pcr.stages(pie).empty());
+            pipe_count++;
+        }
+        EXPECT_EQ(pipe_count, 3u);
+    }
+}
+
+TEST(ReaderWriter, StreamingWriter) {
+    PCWriterTestData test_data(__LINE__);
+    test_data.GenPipelineEntries(12);
+    for (uint32_t i = 0; i < 12; i++) {
+        test_data.GenShaderStages(i, i % 3);
+    }
+    test_data.GenPipelineJsonData();
+    test_data.SetJson(5, "");
+
+    std::vector<std::unique_ptr<VKSCPipelineEntry>> entries;
+    VKSCPipelineCacheHeaderWriter pcw(test_data.vendor_id_, test_data.device_id_, test_data.pipeline_cache_uuid_);
+    pcw.allocatePipelineIndex(uint32_t(test_data.pipeline_test_datas_.size()));
+    pcw.setImplementationData(test_data.implementation_data_);
+    pcw.setPipelineIndexOffset(sizeof(VkPipelineCacheHeaderVersionSafetyCriticalOne) + 24);
+    pcw.setPipelineIndexStride(sizeof(VkPipelineCacheSafetyCriticalIndexEntry) + 8);
+    pcw.setStageIndexStride(sizeof(VkPipelineCacheStageValidationIndexEntry) + 12);
+    for (uint32_t i = 0; i < test_data.pipeline_test_datas_.size(); i++) {
+        const auto &pipeline_data = test_data.pipeline_test_datas_[i];
+        entries.push_back(std::make_unique<VKSCPipelineEntry>(pipeline_data.uuid, 32 + i));
+        entries.back()->setJsonCode(pipeline_data.json.size(), reinterpret_cast<uint8_t const *>(pipeline_data.json.data()));
+        entries.back()->allocateStages(uint32_t(pipeline_data.stages.size()));
+        for (uint32_t stage_id = 0; stage_id < pipeline_data.stages.size(); stage_id++) {
+            entries.back()->setShaderStageCode(stage_id, pipeline_data.stages[stage_id].code.size(),
+                                               pipeline_data.stages[stage_id].code.data());
+        }
+        pcw.setPipelineEntry(i, entries.back().get());
+    }
+
+    // reference output of the in-memory path
+    std::vector<uint8_t> cache(static_cast<size_t>(pcw.getPipelineCacheSize() + 1));
+    pcw.writeHeaderSafetyCriticalOne(cache.size(), cache.data());
+    EXPECT_EQ(pcw.writePipelineIndex(cache.size(), cache.data()), pcw.getPipelineCacheSize());
+    cache.pop_back();
+
+    {
+        std::vector<uint8_t> streamed;
+        VKSCPipelineCacheCallbackSink sink(
+            [](void *user_data, uint8_t const *data, uint64_t size) {
+                auto output = static_cast<std::vector<uint8_t> *>(user_data);
+                output->insert(output->end(), data, data + size);
+                return true;
+            },
+            &streamed);
+        EXPECT_TRUE(pcw.writePipelineCache(sink));
+        EXPECT_EQ(sink.getBytesWritten(), pcw.getPipelineCacheSize());
+        EXPECT_EQ(streamed, cache);
+
+        VKSCPipelineCacheHeaderReader pcr(streamed.size(), streamed.data());
+        EXPECT_TRUE(pcr.verify());
+    }
+
+    {
+        // a failing sink aborts the write
+        uint64_t budget = 1000;
+        VKSCPipelineCacheCallbackSink sink(
+            [](void *user_data, uint8_t const *, uint64_t size) {
+                uint64_t &remaining = *static_cast<uint64_t *>(user_data);
+                if (size > remaining) return false;
+                remaining -= size;
+                return true;
+            },
+            &budget);
+        EXPECT_FALSE(pcw.writePipelineCache(sink));
+        EXPECT_LE(sink.getBytesWritten(), 1000u);
+    }
+
+    {
+        std::string path = testing::TempDir() + "pcutil_test_streaming_writer.bin";
+        VKSCPipelineCacheFileSink sink;
+        EXPECT_FALSE(sink.isOpen());
+        ASSERT_TRUE(sink.open(path.c_str()));
+        EXPECT_TRUE(pcw.writePipelineCache(sink));
+        EXPECT_TRUE(sink.close());
+
+        VKSCPipelineCacheFile cache_file;
+        ASSERT_TRUE(cache_file.open(path.c_str()));
+        ASSERT_EQ(cache_file.getSize(), cache.size());
+        EXPECT_TRUE(memcmp(cache_file.getData(), cache.data(), cache.size()) == 0);
+        cache_file.close();
+
+        remove(path.c_str());
+    }
+}
+
+TEST(ReaderWriter, ParallelWriter) {
+    PCWriterTestData test_data(__LINE__);
+    test_data.GenPipelineEntries(101);
+    for (uint32_t i = 0; i < 101; i++) {
+        test_data.GenShaderStages(i, (i * 7) % 5);
+    }
+    test_data.GenPipelineJsonData();
+
+    std::vector<std::unique_ptr<VKSCPipelineEntry>> entries;
+    VKSCPipelineCacheHeaderWriter pcw(test_data.vendor_id_, test_data.device_id_, test_data.pipeline_cache_uuid_);
+    pcw.allocatePipelineIndex(uint32_t(test_data.pipeline_test_datas_.size()));
+    pcw.setPipelineIndexStride(sizeof(VkPipelineCacheSafetyCriticalIndexEntry) + 3);
+    pcw.setStageIndexStride(sizeof(VkPipelineCacheStageValidationIndexEntry) + 9);
+    for (uint32_t i = 0; i < test_data.pipeline_test_datas_.size(); i++) {
+        const auto &pipeline_data = test_data.pipeline_test_datas_[i];
+        entries.push_back(std::make_unique<VKSCPipelineEntry>(pipeline_data.uuid, 32 + i));
+        entries.back()->setJsonCode(pipeline_data.json.size(), reinterpret_cast<uint8_t const *>(pipeline_data.json.data()));
+        entries.back()->allocateStages(uint32_t(pipeline_data.stages.size()));
+        for (uint32_t stage_id = 0; stage_id < pipeline_data.stages.size(); stage_id++) {
+            entries.back()->setShaderStageCode(stage_id, pipeline_data.stages[stage_id].code.size(),
+                                               pipeline_data.stages[stage_id].code.data());
+        }
+        pcw.setPipelineEntry(i, entries.back().get());
+    }
+
+    std::vector<uint8_t> reference(static_cast<size_t>(pcw.getPipelineCacheSize() + 1));
+    EXPECT_EQ(pcw.writePipelineIndex(reference.size(), reference.data()), pcw.getPipelineCacheSize());
+
+    for (uint32_t thread_count : {1u, 2u, 7u, 1000u}) {
+        std::vector<uint8_t> cache(reference.size());
+        EXPECT_EQ(pcw.writePipelineIndexParallel(cache.size(), cache.data(), thread_count), pcw.getPipelineCacheSize());
+        EXPECT_EQ(cache, reference);
+    }
+
+    {
+        // executor running the tasks in reverse order on the calling thread
+        std::vector<uint8_t> cache(reference.size());
+        uint32_t executed_task_count = 0;
+        EXPECT_EQ(pcw.writePipelineIndexParallel(cache.size(), cache.data(), 13,
+                                                 [&](uint32_t task_count, auto const &task) {
+                                                     for (uint32_t i = task_count; i > 0; i--) {
+                                                         task(i - 1);
+                                                         executed_task_count++;
+                                                     }
+                                                 }),
+                  pcw.getPipelineCacheSize());
+        EXPECT_EQ(executed_task_count, 13u);
+        EXPECT_EQ(cache, reference);
+    }
+}
+
+TEST(ReaderWriter, DeduplicatedPayloads) {
+    PCWriterTestData test_data(__LINE__);
+    test_data.GenPipelineEntries(40);
+    for (uint32_t i = 0; i < 40; i++) {
+        test_data.GenShaderStages(i, 1 + i % 3);
+        // only a handful of distinct shader modules and json documents shared between the pipelines
+        for (uint32_t stage_id = 0; stage_id < test_data.pipeline_test_datas_[i].stages.size(); stage_id++) {
+            test_data.SetShaderStageCode(i, stage_id, std::vector<uint32_t>{0x07230203, 0x10000, i % 4, stage_id});
+        }
+        test_data.SetJson(i, "{ \"variant\" : " + std::to_string(i % 5) + " }");
+    }
+    test_data.SetJson(7, "");
+
+    std::vector<std::unique_ptr<VKSCPipelineEntry>> entries;
+    VKSCPipelineCacheHeaderWriter pcw(test_data.vendor_id_, test_data.device_id_, test_data.pipeline_cache_uuid_);
+    pcw.allocatePipelineIndex(uint32_t(test_data.pipeline_test_datas_.size()));
+    for (uint32_t i = 0; i < test_data.pipeline_test_datas_.size(); i++) {
+        const auto &pipeline_data = test_data.pipeline_test_datas_[i];
+        entries.push_back(std::make_unique<VKSCPipelineEntry>(pipeline_data.uuid, 32 + i));
+        entries.back()->setJsonCode(pipeline_data.json.size(), reinterpret_cast<uint8_t const *>(pipeline_data.json.data()));
+        entries.back()->allocateStages(uint32_t(pipeline_data.stages.size()));
+        for (uint32_t stage_id = 0; stage_id < pipeline_data.stages.size(); stage_id++) {
+            entries.back()->setShaderStageCode(stage_id, pipeline_data.stages[stage_id].code.size(),
+                                               pipeline_data.stages[stage_id].code.data());
+        }
+        pcw.setPipelineEntry(i, entries.back().get());
+    }
+
+    uint64_t const full_size = pcw.getPipelineCacheSize();
+    EXPECT_EQ(pcw.getDeduplicationSavings(), 0u);
+
+    pcw.setDeduplicatePayloads(true);
+    uint64_t const dedup_size = pcw.getPipelineCacheSize();
+    EXPECT_LT(dedup_size, full_size);
+    EXPECT_EQ(pcw.getDeduplicationSavings(), full_size - dedup_size);
+
+    std::vector<uint8_t> cache(static_cast<size_t>(dedup_size + 1));
+    pcw.writeHeaderSafetyCriticalOne(cache.size(), cache.data());
+    EXPECT_EQ(pcw.writePipelineIndex(cache.size(), cache.data()), dedup_size);
+    cache.pop_back();
+
+    {
+        VKSCPipelineCacheHeaderReader pcr(cache.size(), cache.data());
+        EXPECT_TRUE(pcr.verify());
+
+        // every distinct payload is stored exactly once
+        std::map<std::string, uint64_t> json_offsets;
+        std::map<std::vector<uint8_t>, uint64_t> code_offsets;
+        for (uint32_t i = 0; i < test_data.pipeline_test_datas_.size(); i++) {
+            const auto &pipeline_data = test_data.pipeline_test_datas_[i];
+            VkPipelineCacheSafetyCriticalIndexEntry const *pie = pcr.getPipelineIndexEntry(i);
+            ASSERT_TRUE(pie);
+
+            ASSERT_EQ(pie->jsonSize, pipeline_data.json.size());
+            if (pie->jsonSize > 0) {
+                EXPECT_TRUE(memcmp(pcr.getJson(*pie), pipeline_data.json.data(), pipeline_data.json.size()) == 0);
+                EXPECT_EQ(json_offsets.emplace(pipeline_data.json, pie->jsonOffset).first->second, pie->jsonOffset);
+            }
+
+            ASSERT_EQ(pie->stageIndexCount, pipeline_data.stages.size());
+            for (uint32_t stage_id = 0; stage_id < pie->stageIndexCount; stage_id++) {
+                VkPipelineCacheStageValidationIndexEntry const *sie = pcr.getStageIndexEntry(*pie, stage_id);
+                const auto &code = pipeline_data.stages[stage_id].code;
+                ASSERT_EQ(sie->codeSize, code.size());
+                EXPECT_TRUE(memcmp(pcr.getSPIRV(*sie), code.data(), code.size()) == 0);
+                EXPECT_EQ(code_offsets.emplace(code, sie->codeOffset).first->second, sie->codeOffset);
+            }
+        }
+        EXPECT_EQ(json_offsets.size(), 5u);
+        EXPECT_EQ(code_offsets.size(), 12u);
+    }
+
+    // the parallel and streaming paths produce the same deduplicated output
+    {
+        std::vector<uint8_t> parallel_cache(cache.size() + 1);
+        pcw.writeHeaderSafetyCriticalOne(parallel_cache.size(), parallel_cache.data());
+        EXPECT_EQ(pcw.writePipelineIndexParallel(parallel_cache.size(), parallel_cache.data(), 4), dedup_size);
+        parallel_cache.pop_back();
+        EXPECT_EQ(parallel_cache, cache);
+    }
+    {
+        std::vector<uint8_t> streamed;
+        VKSCPipelineCacheCallbackSink sink(
+            [](void *user_data, uint8_t const *data, uint64_t size) {
+                auto output = static_cast<std::vector<uint8_t> *>(user_data);
+                output->insert(output->end(), data, data + size);
+                return true;
+            },
+            &streamed);
+        EXPECT_TRUE(pcw.writePipelineCache(sink));
+        EXPECT_EQ(streamed, cache);
+    }
+}
+
+TEST(ReaderWriter, AlignedLayout) {
+    PCWriterTestData test_data(__LINE__);
+    test_data.GenPipelineEntries(23);
+    for (uint32_t i = 0; i < 23; i++) {
+        test_data.GenShaderStages(i, i % 4);
+    }
+    test_data.GenPipelineJsonData();
+    test_data.SetJson(5, "");
+
+    std::vector<std::unique_ptr<VKSCPipelineEntry>> entries;
+    VKSCPipelineCacheHeaderWriter pcw(test_data.vendor_id_, test_data.device_id_, test_data.pipeline_cache_uuid_);
+    pcw.allocatePipelineIndex(uint32_t(test_data.pipeline_test_datas_.size()));
+    pcw.setPipelineIndexOffset(sizeof(VkPipelineCacheHeaderVersionSafetyCriticalOne) + 5);
+    for (uint32_t i = 0; i < test_data.pipeline_test_datas_.size(); i++) {
+        const auto &pipeline_data = test_data.pipeline_test_datas_[i];
+        entries.push_back(std::make_unique<VKSCPipelineEntry>(pipeline_data.uuid, 32 + i));
+        entries.back()->setJsonCode(pipeline_data.json.size(), reinterpret_cast<uint8_t const *>(pipeline_data.json.data()));
+        entries.back()->allocateStages(uint32_t(pipeline_data.stages.size()));
+        for (uint32_t stage_id = 0; stage_id < pipeline_data.stages.size(); stage_id++) {
+            entries.back()->setShaderStageCode(stage_id, pipeline_data.stages[stage_id].code.size(),
+                                               pipeline_data.stages[stage_id].code.data());
+        }
+        pcw.setPipelineEntry(i, entries.back().get());
+    }
+
+    uint64_t const packed_size = pcw.getPipelineCacheSize();
+
+    VKSCPipelineCacheAlignment alignment;
+    alignment.pipelineIndex = 64;
+    alignment.json = 16;
+    alignment.stageIndex = 8;
+    alignment.code = 256;
+    pcw.setLayoutAlignment(alignment);
+    EXPECT_EQ(pcw.getAlignedPipelineIndexOffset(), 64u);
+
+    for (bool deduplicate : {false, true}) {
+        pcw.setDeduplicatePayloads(deduplicate);
+        uint64_t const size = pcw.getPipelineCacheSize();
+        if (!deduplicate) {
+            EXPECT_GT(size, packed_size);
+        }
+
+        // padding is zero-filled, whatever the memory contained before
+        std::vector<uint8_t> cache(static_cast<size_t>(size + 1), 0xcd);
+        pcw.writeHeaderSafetyCriticalOne(cache.size(), cache.data());
+        EXPECT_EQ(pcw.writePipelineIndex(cache.size(), cache.data()), size);
+        cache.pop_back();
+
+        {
+            VKSCPipelineCacheHeaderReader pcr(cache.size(), cache.data());
+            EXPECT_TRUE(pcr.verify());
+            EXPECT_EQ(pcr.getPipelineIndexOffset(), 64u);
+
+            for (uint32_t i = 0; i < test_data.pipeline_test_datas_.size(); i++) {
+                const auto &pipeline_data = test_data.pipeline_test_datas_[i];
+                VkPipelineCacheSafetyCriticalIndexEntry const *pie = pcr.getPipelineIndexEntry(i);
+                ASSERT_TRUE(pie);
+
+                ASSERT_EQ(pie->jsonSize, pipeline_data.json.size());
+                if (pie->jsonSize > 0) {
+                    EXPECT_EQ(pie->jsonOffset % alignment.json, 0u);
+                    EXPECT_TRUE(memcmp(pcr.getJson(*pie), pipeline_data.json.data(), pipeline_data.json.size()) == 0);
+                }
+
+                ASSERT_EQ(pie->stageIndexCount, pipeline_data.stages.size());
+                if (pie->stageIndexCount > 0) {
+                    EXPECT_EQ(pie->stageIndexOffset % alignment.stageIndex, 0u);
+                }
+                for (uint32_t stage_id = 0; stage_id < pie->stageIndexCount; stage_id++) {
+                    VkPipelineCacheStageValidationIndexEntry const *sie = pcr.getStageIndexEntry(*pie, stage_id);
+                    const auto &code = pipeline_data.stages[stage_id].code;
+                    ASSERT_EQ(sie->codeSize, code.size());
+                    EXPECT_EQ(sie->codeOffset % alignment.code, 0u);
+                    EXPECT_TRUE(memcmp(pcr.getSPIRV(*sie), code.data(), code.size()) == 0);
+                }
+            }
+        }
+
+        // the parallel and streaming paths produce the same aligned output
+        {
+            std::vector<uint8_t> parallel_cache(cache.size() + 1, 0xcd);
+            pcw.writeHeaderSafetyCriticalOne(parallel_cache.size(), parallel_cache.data());
+            EXPECT_EQ(pcw.writePipelineIndexParallel(parallel_cache.size(), parallel_cache.data(), 5), size);
+            parallel_cache.pop_back();
+            EXPECT_EQ(parallel_cache, cache);
+        }
+        {
+            std::vector<uint8_t> streamed;
+            VKSCPipelineCacheCallbackSink sink(
+                [](void *user_data, uint8_t const *data, uint64_t size) {
+                    auto output = static_cast<std::vector<uint8_t> *>(user_data);
+                    output->insert(output->end(), data, data + size);
+                    return true;
+                },
+                &streamed);
+            EXPECT_TRUE(pcw.writePipelineCache(sink));
+            // the region reserved for implementation-specific data before the pipeline index is not written by writePipelineIndex
+            std::fill(cache.begin() + sizeof(VkPipelineCacheHeaderVersionSafetyCriticalOne),
+                      cache.begin() + sizeof(VkPipelineCacheHeaderVersionSafetyCriticalOne) + 5, 0);
+            EXPECT_EQ(streamed, cache);
+        }
+    }
+}
+
+TEST(ReaderWriter, OwnedPipelineEntries) {
+    PCWriterTestData test_data(__LINE__);
+    test_data.GenPipelineEntries(37);
+    for (uint32_t i = 0; i < 37; i++) {
+        test_data.GenShaderStages(i, i % 5);
+    }
+    test_data.GenPipelineJsonData();
+
+    // reference written from application-owned entries
+    std::vector<uint8_t> reference;
+    {
+        std::vector<std::unique_ptr<VKSCPipelineEntry>> entries;
+        VKSCPipelineCacheHeaderWriter pcw(test_data.vendor_id_, test_data.device_id_, test_data.pipeline_cache_uuid_);
+        pcw.allocatePipelineIndex(uint32_t(test_data.pipeline_test_datas_.size()));
+        EXPECT_FALSE(pcw.reservePipelineEntries(1));
+        EXPECT_FALSE(pcw.emplacePipelineEntry(test_data.pipeline_test_datas_[0].uuid, 0));
+        for (uint32_t i = 0; i < test_data.pipeline_test_datas_.size(); i++) {
+            const auto &pipeline_data = test_data.pipeline_test_datas_[i];
+            entries.push_back(std::make_unique<VKSCPipelineEntry>(pipeline_data.uuid, 32 + i));
+            entries.back()->setJsonCode(pipeline_data.json.size(), reinterpret_cast<uint8_t const *>(pipeline_data.json.data()));
+            entries.back()->allocateStages(uint32_t(pipeline_data.stages.size()));
+            for (uint32_t stage_id = 0; stage_id < pipeline_data.stages.size(); stage_id++) {
+                entries.back()->setShaderStageCode(stage_id, pipeline_data.stages[stage_id].code.size(),
+                                                   pipeline_data.stages[stage_id].code.data());
+            }
+            pcw.setPipelineEntry(i, entries.back().get());
+        }
+        reference.resize(static_cast<size_t>(pcw.getPipelineCacheSize() + 1));
+        pcw.writeHeaderSafetyCriticalOne(reference.size(), reference.data());
+        pcw.writePipelineIndex(reference.size(), reference.data());
+    }
+
+    // writer-owned entries, growing past the reserved capacity
+    {
+        VKSCPipelineCacheHeaderWriter pcw(test_data.vendor_id_, test_data.device_id_, test_data.pipeline_cache_uuid_);
+        EXPECT_TRUE(pcw.reservePipelineEntries(4, 8));
+        for (uint32_t i = 0; i < test_data.pipeline_test_datas_.size(); i++) {
+            const auto &pipeline_data = test_data.pipeline_test_datas_[i];
+            VKSCPipelineEntry *entry = pcw.emplacePipelineEntry(pipeline_data.uuid, 32 + i, uint32_t(pipeline_data.stages.size()));
+            ASSERT_TRUE(entry);
+            entry->setJsonCode(pipeline_data.json.size(), reinterpret_cast<uint8_t const *>(pipeline_data.json.data()));
+            for (uint32_t stage_id = 0; stage_id < pipeline_data.stages.size(); stage_id++) {
+                entry->setShaderStageCode(stage_id, pipeline_data.stages[stage_id].code.size(),
+                                          pipeline_data.stages[stage_id].code.data());
+            }
+        }
+        EXPECT_FALSE(pcw.allocatePipelineIndex(1));
+        EXPECT_EQ(pcw.getPipelineEntryCount(), test_data.pipeline_test_datas_.size());
+
+        std::vector<uint8_t> cache(static_cast<size_t>(pcw.getPipelineCacheSize() + 1));
+        pcw.writeHeaderSafetyCriticalOne(cache.size(), cache.data());
+        pcw.writePipelineIndex(cache.size(), cache.data());
+        EXPECT_EQ(cache, reference);
+    }
+
+    // application-owned entries in a contiguous container, stages allocated from an arena
+    // (the entries are moved rather than copied when the container grows)
+    static_assert(std::is_nothrow_move_constructible<VKSCPipelineEntry>::value, "entries must be nothrow movable");
+    static_assert(std::is_nothrow_move_assignable<VKSCPipelineEntry>::value, "entries must be nothrow movable");
+    {
+        VKSCStageEntryArena arena;
+        std::vector<VKSCPipelineEntry> entries;
+        for (uint32_t i = 0; i < test_data.pipeline_test_datas_.size(); i++) {
+            const auto &pipeline_data = test_data.pipeline_test_datas_[i];
+            VKSCPipelineEntry entry(pipeline_data.uuid, 32 + i);
+            entry.setJsonCode(pipeline_data.json.size(), reinterpret_cast<uint8_t const *>(pipeline_data.json.data()));
+            EXPECT_TRUE(entry.allocateStages(uint32_t(pipeline_data.stages.size()), &arena));
+            for (uint32_t stage_id = 0; stage_id < pipeline_data.stages.size(); stage_id++) {
+                entry.setShaderStageCode(stage_id, pipeline_data.stages[stage_id].code.size(),
+                                         pipeline_data.stages[stage_id].code.data());
+            }
+            entries.push_back(std::move(entry));
+        }
+
+        VKSCPipelineCacheHeaderWriter pcw(test_data.vendor_id_, test_data.device_id_, test_data.pipeline_cache_uuid_);
+        pcw.allocatePipelineIndex(uint32_t(entries.size()));
+        for (uint32_t i = 0; i < entries.size(); i++) {
+            pcw.setPipelineEntry(i, &entries[i]);
+        }
+
+        std::vector<uint8_t> cache(static_cast<size_t>(pcw.getPipelineCacheSize() + 1));
+        pcw.writeHeaderSafetyCriticalOne(cache.size(), cache.data());
+        pcw.writePipelineIndex(cache.size(), cache.data());
+        EXPECT_EQ(cache, reference);
+    }
+}
+
+TEST(ReaderWriter, EditedCache) {
+    // pipelines 12 and 13 are not part of the original cache but added by the edit
+    PCWriterTestData all_data(__LINE__);
+    all_data.GenPipelineEntries(14);
+    for (uint32_t i = 0; i < 14; i++) {
+        all_data.GenShaderStages(i, i % 3);
+    }
+    all_data.GenPipelineJsonData();
+    all_data.GenGlobalVendorData(13);
+    all_data.GenPipelineVendorData(5);
+    all_data.GenShaderStageVendorData(7);
+
+    PCWriterTestData test_data = all_data;
+    test_data.pipeline_test_datas_.resize(12);
+
+    std::vector<uint8_t> cache(PCWriterTestData::default_cache_size_);
+    {
+        VKSCPipelineCacheHeaderWriter pcw(test_data.vendor_id_, test_data.device_id_, test_data.pipeline_cache_uuid_);
+        WriteTestDataToCache(pcw, cache, test_data);
+    }
+
+    // replace pipeline 4, remove pipeline 5, add pipelines 12 and 13
+    all_data.SetJson(4, "{ \"replaced\" : true }");
+    all_data.SetShaderStageCode(4, 0, std::vector<uint32_t>{0x07230203, 0x10000, 4, 4});
+    std::vector<uint32_t> const expected_order = {0, 1, 2, 3, 4, 6, 7, 8, 9, 10, 11, 12, 13};
+
+    std::vector<std::unique_ptr<VKSCPipelineEntry>> entries;
+    for (uint32_t i : {4u, 12u, 13u, 5u}) {
+        const auto &pipeline_data = all_data.pipeline_test_datas_[i];
+        entries.push_back(std::make_unique<VKSCPipelineEntry>(pipeline_data.uuid, 32 + i * 11));
+        entries.back()->setJsonCode(pipeline_data.json.size(), reinterpret_cast<uint8_t const *>(pipeline_data.json.data()));
+        entries.back()->allocateStages(uint32_t(pipeline_data.stages.size()));
+        for (uint32_t stage_id = 0; stage_id < pipeline_data.stages.size(); stage_id++) {
+            entries.back()->setShaderStageCode(stage_id, pipeline_data.stages[stage_id].code.size(),
+                                               pipeline_data.stages[stage_id].code.data());
+        }
+    }
+
+    auto validate = [&](std::vector<uint8_t> &edited_cache) {
+        VKSCPipelineCacheHeaderReader pcr(edited_cache.size(), edited_cache.data());
+        ASSERT_TRUE(pcr.verify());
+        ASSERT_EQ(pcr.getPipelineIndexCount(), expected_order.size());
+        EXPECT_EQ(pcr.getImplementationData(), test_data.implementation_data_);
+        EXPECT_TRUE(memcmp(edited_cache.data() + sizeof(VkPipelineCacheHeaderVersionSafetyCriticalOne),
+                           test_data.global_vendor_data_.data(), test_data.global_vendor_data_.size()) == 0);
+
+        for (uint32_t i = 0; i < expected_order.size(); i++) {
+            uint32_t const pipe_id = expected_order[i];
+            const auto &pipeline_data = all_data.pipeline_test_datas_[pipe_id];
+            bool const edited = pipe_id == 4 || pipe_id >= 12;
+
+            VkPipelineCacheSafetyCriticalIndexEntry const *pie = pcr.getPipelineIndexEntry(i);
+            EXPECT_TRUE(memcmp(pie->pipelineIdentifier, pipeline_data.uuid, VK_UUID_SIZE) == 0);
+            EXPECT_EQ(pie->pipelineMemorySize, 32 + pipe_id * 11);
+            ASSERT_EQ(pie->jsonSize, pipeline_data.json.size());
+            EXPECT_TRUE(memcmp(pcr.getJson(*pie), pipeline_data.json.data(), pipeline_data.json.size()) == 0);
+            if (!edited) {
+                EXPECT_TRUE(memcmp(pie + 1, pipeline_data.vendor_data.data(), pipeline_data.vendor_data.size()) == 0);
+            }
+
+            ASSERT_EQ(pie->stageIndexCount, pipeline_data.stages.size());
+            for (uint32_t stage_id = 0; stage_id < pie->stageIndexCount; stage_id++) {
+                VkPipelineCacheStageValidationIndexEntry const *sie = pcr.getStageIndexEntry(*pie, stage_id);
+                const auto &stage_data = pipeline_data.stages[stage_id];
+                ASSERT_EQ(sie->codeSize, stage_data.code.size());
+                EXPECT_TRUE(memcmp(pcr.getSPIRV(*sie), stage_data.code.data(), stage_data.code.size()) == 0);
+                if (!edited) {
+                    EXPECT_TRUE(memcmp(sie + 1, stage_data.vendor_data.data(), stage_data.vendor_data.size()) == 0);
+                }
+            }
+        }
+    };
+
+    VKSCPipelineCacheHeaderReader pcr(cache.size(), cache.data());
+    VKSCPipelineCacheEditor editor(pcr);
+    EXPECT_FALSE(editor.open());
+    ASSERT_TRUE(pcr.verify());
+    ASSERT_TRUE(editor.open());
+
+    EXPECT_TRUE(editor.setPipelineEntry(entries[0].get()));
+    EXPECT_TRUE(editor.setPipelineEntry(entries[1].get()));
+    EXPECT_TRUE(editor.setPipelineEntry(entries[2].get()));
+    EXPECT_TRUE(editor.removePipelineEntry(all_data.pipeline_test_datas_[5].uuid));
+    EXPECT_FALSE(editor.removePipelineEntry(all_data.pipeline_test_datas_[5].uuid));
+    // adding and removing again leaves no trace
+    EXPECT_TRUE(editor.setPipelineEntry(entries[3].get()));
+    EXPECT_TRUE(editor.removePipelineEntry(all_data.pipeline_test_datas_[5].uuid));
+    EXPECT_EQ(editor.getPipelineCount(), expected_order.size());
+
+    // append in place, the existing contents except for the header are not touched
+    std::vector<uint8_t> appended = cache;
+    appended.resize(static_cast<size_t>(editor.getAppendedCacheSize()));
+    EXPECT_FALSE(editor.writeAppendedCache(appended.size() - 1, appended.data()));
+    EXPECT_TRUE(editor.writeAppendedCache(appended.size(), appended.data()));
+    EXPECT_TRUE(std::equal(cache.begin() + sizeof(VkPipelineCacheHeaderVersionSafetyCriticalOne), cache.end(),
+                           appended.begin() + sizeof(VkPipelineCacheHeaderVersionSafetyCriticalOne)));
+    validate(appended);
+
+    // compact into a new pipeline cache
+    std::vector<uint8_t> compacted;
+    VKSCPipelineCacheCallbackSink sink(
+        [](void *user_data, uint8_t const *data, uint64_t size) {
+            auto output = static_cast<std::vector<uint8_t> *>(user_data);
+            output->insert(output->end(), data, data + size);
+            return true;
+        },
+        &compacted);
+    EXPECT_TRUE(editor.writeCompactedCache(sink));
+    EXPECT_EQ(compacted.size(), editor.getCompactedCacheSize());
+    EXPECT_LT(compacted.size(), appended.size());
+    validate(compacted);
+}
+
+TEST(ReaderWriter, CompressedPayloads) {
+    // payloads: a large compressible module spanning several decoder windows, a small module that does not compress,
+    // and json documents, one of them shared
+    std::vector<uint32_t> large_code{0x07230203, 0x10000, 0, 100};
+    uint32_t state = 1;
+    while (large_code.size() < 100000) {
+        state = state * 1664525u + 1013904223u;
+        uint32_t const opcode = 0x40000 | (state >> 28);
+        large_code.insert(large_code.end(), {opcode, (state >> 20) & 0xFF, 17, uint32_t(large_code.size() % 64)});
+    }
+    std::vector<uint32_t> const small_code{0x07230203, 0x10000, 0, 8};
+    std::string json = "{ \"stages\" : [";
+    for (uint32_t i = 0; i < 200; i++) {
+        json += " { \"stage\" : \"VK_SHADER_STAGE_VERTEX_BIT\", \"module\" : " + std::to_string(i) + " },";
+    }
+    json += " ] }";
+    std::string const short_json = "{}";
+
+    VKSCPipelineCacheHeaderWriter pcw(0x1234, 0x5678, std::vector<uint8_t>(VK_UUID_SIZE, 0x42).data());
+    for (uint32_t i = 0; i < 6; i++) {
+        uint8_t identifier[VK_UUID_SIZE]{uint8_t(i)};
+        VKSCPipelineEntry *entry = pcw.emplacePipelineEntry(identifier, 64 + i, 2);
+        entry->setJsonCode(i % 3 == 2 ? short_json.size() : json.size(),
+                           reinterpret_cast<uint8_t const *>(i % 3 == 2 ? short_json.data() : json.data()));
+        entry->setShaderStageCode(0, large_code.size() * sizeof(uint32_t), reinterpret_cast<uint8_t const *>(large_code.data()));
+        entry->setShaderStageCode(1, small_code.size() * sizeof(uint32_t), reinterpret_cast<uint8_t const *>(small_code.data()));
+    }
+
+    for (bool deduplicate : {false, true}) {
+        pcw.setDeduplicatePayloads(deduplicate);
+        pcw.setCompressPayloads(false);
+        uint64_t const plain_size = pcw.getPipelineCacheSize();
+        EXPECT_EQ(pcw.getCompressionSavings(), 0u);
+
+        pcw.setCompressPayloads(true);
+        uint64_t const size = pcw.getPipelineCacheSize();
+        EXPECT_LT(size * 4, plain_size * 3);
+        EXPECT_EQ(pcw.getCompressionSavings(), plain_size - size);
+
+        std::vector<uint8_t> cache(static_cast<size_t>(size + 1));
+        pcw.writeHeaderSafetyCriticalOne(cache.size(), cache.data());
+        EXPECT_EQ(pcw.writePipelineIndex(cache.size(), cache.data()), size);
+        cache.pop_back();
+
+        VKSCPipelineCacheHeaderReader pcr(cache.size(), cache.data());
+        ASSERT_TRUE(pcr.verify());
+        ASSERT_EQ(pcr.getPipelineIndexCount(), 6u);
+        for (uint32_t i = 0; i < 6; i++) {
+            VkPipelineCacheSafetyCriticalIndexEntry const *pie = pcr.getPipelineIndexEntry(i);
+            ASSERT_TRUE(pie);
+
+            std::string const &expected_json = i % 3 == 2 ? short_json : json;
+            EXPECT_EQ(pcr.isJsonCompressed(*pie), i % 3 != 2);
+            ASSERT_EQ(pcr.getJsonSize(*pie), expected_json.size());
+            std::string read_json(expected_json.size(), '\0');
+            EXPECT_TRUE(pcr.readJson(*pie, read_json.size(), reinterpret_cast<uint8_t *>(&read_json[0])));
+            EXPECT_EQ(read_json, expected_json);
+            EXPECT_FALSE(pcr.readJson(*pie, read_json.size() - 1, reinterpret_cast<uint8_t *>(&read_json[0])));
+
+            VkPipelineCacheStageValidationIndexEntry const *large = pcr.getStageIndexEntry(*pie, 0);
+            VkPipelineCacheStageValidationIndexEntry const *small = pcr.getStageIndexEntry(*pie, 1);
+            ASSERT_TRUE(large && small);
+            EXPECT_TRUE(pcr.isSPIRVCompressed(*large));
+            EXPECT_LT(large->codeSize, large_code.size() * sizeof(uint32_t));
+            EXPECT_FALSE(pcr.isSPIRVCompressed(*small));
+            EXPECT_EQ(small->codeSize, small_code.size() * sizeof(uint32_t));
+
+            // decompression into a buffer
+            std::vector<uint32_t> read_code(static_cast<size_t>(pcr.getSPIRVSize(*large) / sizeof(uint32_t)));
+            EXPECT_TRUE(pcr.readSPIRV(*large, read_code.size() * sizeof(uint32_t), reinterpret_cast<uint8_t *>(read_code.data())));
+            EXPECT_EQ(read_code, large_code);
+
+            // streaming decompression
+            std::vector<uint8_t> streamed;
+            uint32_t pieces = 0;
+            EXPECT_TRUE(pcr.readSPIRV(*large, [&](uint8_t const *data, uint64_t piece_size) {
+                streamed.insert(streamed.end(), data, data + piece_size);
+                ++pieces;
+                return true;
+            }));
+            EXPECT_GT(pieces, 1u);
+            ASSERT_EQ(streamed.size(), large_code.size() * sizeof(uint32_t));
+            EXPECT_TRUE(memcmp(streamed.data(), large_code.data(), streamed.size()) == 0);
+            EXPECT_FALSE(pcr.readSPIRV(*large, [](uint8_t const *, uint64_t) { return false; }));
+
+            streamed.clear();
+            EXPECT_TRUE(pcr.readSPIRV(*small, [&](uint8_t const *data, uint64_t piece_size) {
+                streamed.insert(streamed.end(), data, data + piece_size);
+                return true;
+            }));
+            ASSERT_EQ(streamed.size(), small_code.size() * sizeof(uint32_t));
+            EXPECT_TRUE(memcmp(streamed.data(), small_code.data(), streamed.size()) == 0);
+
+            // truncated or corrupted frames are rejected
+            uint8_t const *frame = pcr.getSPIRV(*large);
+            EXPECT_FALSE(VKSCPayloadFrame::decompress(large->codeSize - 1, frame, read_code.size() * sizeof(uint32_t),
+                                                      reinterpret_cast<uint8_t *>(read_code.data())));
+            std::vector<uint8_t> corrupted(frame, frame + large->codeSize);
+            for (size_t offset = VKSCPayloadFrame::kHeaderSize; offset < corrupted.size(); offset += 97) {
+                corrupted[offset] ^= 0x5A;
+            }
+            VKSCPayloadFrame::decompress(corrupted.size(), corrupted.data(), read_code.size() * sizeof(uint32_t),
+                                         reinterpret_cast<uint8_t *>(read_code.data()));
+            VKSCPayloadFrame::decompress(corrupted.size(), corrupted.data(), [](uint8_t const *, uint64_t) { return true; });
+        }
+
+        // the parallel and streaming paths produce the same compressed output
+        {
+            std::vector<uint8_t> parallel_cache(cache.size() + 1);
+            pcw.writeHeaderSafetyCriticalOne(parallel_cache.size(), parallel_cache.data());
+            EXPECT_EQ(pcw.writePipelineIndexParallel(parallel_cache.size(), parallel_cache.data(), 4), size);
+            parallel_cache.pop_back();
+            EXPECT_EQ(parallel_cache, cache);
+        }
+        {
+            std::vector<uint8_t> streamed;
+            VKSCPipelineCacheCallbackSink sink(
+                [](void *user_data, uint8_t const *data, uint64_t size) {
+                    auto output = static_cast<std::vector<uint8_t> *>(user_data);
+                    output->insert(output->end(), data, data + size);
+                    return true;
+                },
+                &streamed);
+            EXPECT_TRUE(pcw.writePipelineCache(sink));
+            EXPECT_EQ(streamed, cache);
+        }
+    }
+}
+
+TEST(ReaderWriter, PipelineChecksums) {
+    std::vector<std::vector<uint32_t>> codes;
+    std::vector<std::string> jsons;
+    for (uint32_t i = 0; i < 8; i++) {
+        codes.push_back(std::vector<uint32_t>{0x07230203, 0x10000, i, 5000 + i});
+        codes.back().resize(codes.back().size() + 4000 * i, i);
+        jsons.push_back(i == 3 ? std::string() : "{ \"pipeline\" : " + std::to_string(i) + " }");
+    }
+
+    uint32_t const vendor_size = 8;
+    VKSCPipelineCacheHeaderWriter pcw(0x1234, 0x5678, std::vector<uint8_t>(VK_UUID_SIZE, 0x42).data());
+    pcw.setPipelineIndexStride(sizeof(VkPipelineCacheSafetyCriticalIndexEntry) + vendor_size);
+    for (uint32_t i = 0; i < 8; i++) {
+        uint8_t identifier[VK_UUID_SIZE]{uint8_t(i), 1};
+        uint32_t const stage_count = i % 3;
+        VKSCPipelineEntry *entry = pcw.emplacePipelineEntry(identifier, 64 + i, stage_count);
+        entry->setJsonCode(jsons[i].size(), reinterpret_cast<uint8_t const *>(jsons[i].data()));
+        for (uint32_t stage_id = 0; stage_id < stage_count; stage_id++) {
+            auto const &code = codes[(i + stage_id) % codes.size()];
+            entry->setShaderStageCode(stage_id, code.size() * sizeof(uint32_t), reinterpret_cast<uint8_t const *>(code.data()));
+        }
+    }
+
+    auto write_cache = [&pcw]() {
+        std::vector<uint8_t> cache(static_cast<size_t>(pcw.getPipelineCacheSize() + 1));
+        pcw.writeHeaderSafetyCriticalOne(cache.size(), cache.data());
+        EXPECT_EQ(pcw.writePipelineIndex(cache.size(), cache.data()), cache.size() - 1);
+        cache.pop_back();
+        return cache;
+    };
+
+    // without checksums there are no records to verify
+    {
+        std::vector<uint8_t> cache = write_cache();
+        VKSCPipelineCacheHeaderReader pcr(cache.size(), cache.data());
+        EXPECT_TRUE(pcr.verify());
+        VKSCPipelineChecksums checksums{};
+        EXPECT_FALSE(pcr.getPipelineChecksums(*pcr.getPipelineIndexEntry(0U), checksums));
+        EXPECT_FALSE(pcr.verifyChecksums());
+    }
+
+    pcw.setPipelineChecksums(true);
+    EXPECT_EQ(pcw.getPipelineIndexStride(),
+              sizeof(VkPipelineCacheSafetyCriticalIndexEntry) + vendor_size + sizeof(VKSCPipelineChecksums));
+    for (bool compress : {false, true}) {
+        pcw.setCompressPayloads(compress);
+        std::vector<uint8_t> cache = write_cache();
+
+        // the parallel and streaming paths store the same checksums
+        {
+            std::vector<uint8_t> parallel_cache(cache.size() + 1);
+            pcw.writeHeaderSafetyCriticalOne(parallel_cache.size(), parallel_cache.data());
+            EXPECT_EQ(pcw.writePipelineIndexParallel(parallel_cache.size(), parallel_cache.data(), 3), cache.size());
+            parallel_cache.pop_back();
+            EXPECT_EQ(parallel_cache, cache);
+
+            std::vector<uint8_t> streamed;
+            VKSCPipelineCacheCallbackSink sink(
+                [](void *user_data, uint8_t const *data, uint64_t size) {
+                    auto output = static_cast<std::vector<uint8_t> *>(user_data);
+                    output->insert(output->end(), data, data + size);
+                    return true;
+                },
+                &streamed);
+            EXPECT_TRUE(pcw.writePipelineCache(sink));
+            EXPECT_EQ(streamed, cache);
+        }
+
+        VKSCPipelineCacheHeaderReader pcr(cache.size(), cache.data());
+        ASSERT_TRUE(pcr.verify());
+        EXPECT_TRUE(pcr.verifyChecksums());
+        for (uint32_t i = 0; i < 8; i++) {
+            VkPipelineCacheSafetyCriticalIndexEntry const *pie = pcr.getPipelineIndexEntry(i);
+            VKSCPipelineChecksums checksums{};
+            ASSERT_TRUE(pcr.getPipelineChecksums(*pie, checksums));
+            EXPECT_EQ(checksums.json, VKSCCrc32c::update(0, pcr.getJson(*pie), pie->jsonSize));
+            EXPECT_TRUE(pcr.verifyPipelineChecksums(*pie));
+        }
+
+        // implementation-specific metadata is not covered
+        std::vector<uint8_t> corrupted = cache;
+        corrupted[pcr.getPipelineIndexOffset() + sizeof(VkPipelineCacheSafetyCriticalIndexEntry)] ^= 1;
+        EXPECT_TRUE(VKSCPipelineCacheHeaderReader(corrupted.size(), corrupted.data()).verifyChecksums());
+
+        // a flipped bit in the code of pipeline 4 stage 0 is detected by all pipelines sharing that code
+        corrupted = cache;
+        VkPipelineCacheStageValidationIndexEntry const *sie = pcr.getStageIndexEntry(*pcr.getPipelineIndexEntry(4), 0);
+        corrupted[static_cast<size_t>(sie->codeOffset + sie->codeSize / 2)] ^= 0x10;
+        {
+            VKSCPipelineCacheHeaderReader corrupted_pcr(corrupted.size(), corrupted.data());
+            EXPECT_FALSE(corrupted_pcr.verifyChecksums());
+            VKSCPipelineChecksumVerifier verifier(corrupted_pcr);
+            for (uint32_t i = 0; i < 8; i++) {
+                EXPECT_EQ(verifier.isPipelineValid(i), i != 4) << i;
+                EXPECT_EQ(verifier.isPipelineValid(*corrupted_pcr.getPipelineIndexEntry(i)), i != 4) << i;
+            }
+            EXPECT_FALSE(verifier.isPipelineValid(8));
+        }
+
+        // a flipped bit in an offset is detected as well
+        corrupted = cache;
+        size_t const json_offset_offset =
+            pcr.getPipelineIndexOffset() + offsetof(VkPipelineCacheSafetyCriticalIndexEntry, jsonOffset);
+        corrupted[json_offset_offset] ^= 0x01;
+        EXPECT_FALSE(VKSCPipelineCacheHeaderReader(corrupted.size(), corrupted.data())
+                         .verifyPipelineChecksums(*reinterpret_cast<VkPipelineCacheSafetyCriticalIndexEntry const *>(
+                             corrupted.data() + pcr.getPipelineIndexOffset())));
+    }
+
+    // checksums cover contents rather than placement, so they stay valid when the editor compacts the pipeline cache,
+    // and added pipelines are given checksums as well
+    pcw.setCompressPayloads(false);
+    std::vector<uint8_t> cache = write_cache();
+    VKSCPipelineCacheHeaderReader pcr(cache.size(), cache.data());
+    ASSERT_TRUE(pcr.verify());
+    VKSCPipelineCacheEditor editor(pcr);
+    ASSERT_TRUE(editor.open());
+    EXPECT_TRUE(editor.removePipelineEntry(pcr.getPipelineIndexEntry(1)->pipelineIdentifier));
+    uint8_t identifier[VK_UUID_SIZE]{0xAA};
+    VKSCPipelineEntry added(identifier, 128);
+    added.allocateStages(1);
+    added.setShaderStageCode(0, codes[2].size() * sizeof(uint32_t), reinterpret_cast<uint8_t const *>(codes[2].data()));
+    EXPECT_TRUE(editor.setPipelineEntry(&added));
+
+    std::vector<uint8_t> compacted;
+    VKSCPipelineCacheCallbackSink sink(
+        [](void *user_data, uint8_t const *data, uint64_t size) {
+            auto output = static_cast<std::vector<uint8_t> *>(user_data);
+            output->insert(output->end(), data, data + size);
+            return true;
+        },
+        &compacted);
+    EXPECT_TRUE(editor.writeCompactedCache(sink));
+    VKSCPipelineCacheHeaderReader compacted_pcr(compacted.size(), compacted.data());
+    ASSERT_TRUE(compacted_pcr.verify());
+    EXPECT_EQ(compacted_pcr.getPipelineIndexCount(), 8u);
+    EXPECT_TRUE(compacted_pcr.verifyChecksums());
+}
+
+TEST(ReaderWriter, EntryMetadata) {
+    struct PipelineKey {
+        uint64_t hash;
+        uint32_t pool;
+        uint32_t compileTime;
+    };
+    struct StageKey {
+        uint64_t hash;
+        uint32_t module;
+    };
+
+    std::vector<uint32_t> code{0x07230203, 0x10000, 0, 5000};
+    code.resize(1000, 7);
+    std::string const json = "{ \"pipeline\" : 0 }";
+    std::vector<PipelineKey> pipeline_keys;
+    std::vector<StageKey> stage_keys;
+    for (uint32_t i = 0; i < 6; i++) {
+        pipeline_keys.push_back(PipelineKey{0x1000000000ULL * i + 1, i % 2, 100 * i});
+        stage_keys.push_back(StageKey{0x2000000000ULL * i + 2, i});
+        stage_keys.push_back(StageKey{0x2000000000ULL * i + 3, i + 100});
+    }
+
+    VKSCPipelineCacheHeaderWriter pcw(0x1234, 0x5678, std::vector<uint8_t>(VK_UUID_SIZE, 0x42).data());
+    pcw.setPipelineMetadataSize(sizeof(PipelineKey));
+    pcw.setStageMetadataSize(sizeof(StageKey) - 4);
+    VKSCPipelineCacheAlignment alignment;
+    alignment.stageIndex = alignof(StageKey);
+    pcw.setLayoutAlignment(alignment);
+    EXPECT_EQ(pcw.getPipelineIndexStride(), sizeof(VkPipelineCacheSafetyCriticalIndexEntry) + sizeof(PipelineKey));
+    for (uint32_t i = 0; i < 6; i++) {
+        uint8_t identifier[VK_UUID_SIZE]{uint8_t(i), 2};
+        VKSCPipelineEntry *entry = pcw.emplacePipelineEntry(identifier, 64, 2);
+        entry->setJsonCode(json.size(), reinterpret_cast<uint8_t const *>(json.data()));
+        for (uint32_t stage_id = 0; stage_id < 2; stage_id++) {
+            entry->setShaderStageCode(stage_id, code.size() * sizeof(uint32_t), reinterpret_cast<uint8_t const *>(code.data()));
+        }
+        // pipeline 5 has no metadata at all, pipeline 4 only per-stage metadata and only for its second stage
+        if (i < 4) {
+            entry->setPipelineMetadata(&pipeline_keys[i]);
+            entry->setStageMetadata(0, &stage_keys[2 * i]);
+        }
+        if (i < 5) {
+            entry->setStageMetadata(1, sizeof(StageKey), &stage_keys[2 * i + 1]);
+        }
+    }
+
+    auto check_metadata = [&](VKSCPipelineCacheHeaderReader const &pcr) {
+        for (uint32_t i = 0; i < 6; i++) {
+            VkPipelineCacheSafetyCriticalIndexEntry const *pie = pcr.getPipelineIndexEntry(i);
+            ASSERT_NE(pie, nullptr);
+            uint32_t size = 0;
+            uint8_t const *metadata = pcr.getPipelineMetadata(*pie, size);
+            ASSERT_NE(metadata, nullptr);
+            EXPECT_EQ(size, sizeof(PipelineKey));
+            PipelineKey const *pipeline_key = pcr.getPipelineMetadata<PipelineKey>(*pie);
+            ASSERT_EQ(static_cast<void const *>(pipeline_key), static_cast<void const *>(metadata));
+            if (i < 4) {
+                EXPECT_EQ(pipeline_key->hash, pipeline_keys[i].hash);
+                EXPECT_EQ(pipeline_key->pool, pipeline_keys[i].pool);
+                EXPECT_EQ(pipeline_key->compileTime, pipeline_keys[i].compileTime);
+            } else {
+                EXPECT_EQ(std::vector<uint8_t>(metadata, metadata + size), std::vector<uint8_t>(size, 0));
+            }
+
+            for (uint32_t stage_id = 0; stage_id < 2; stage_id++) {
+                StageKey const *stage_key = pcr.getStageMetadata<StageKey>(*pie, stage_id);
+                ASSERT_NE(stage_key, nullptr);
+                if ((stage_id == 0 && i < 4) || (stage_id == 1 && i < 5)) {
+                    EXPECT_EQ(stage_key->hash, stage_keys[2 * i + stage_id].hash);
+                    EXPECT_EQ(stage_key->module, stage_keys[2 * i + stage_id].module);
+                } else {
+                    EXPECT_EQ(stage_key->hash, 0u);
+                    EXPECT_EQ(stage_key->module, 0u);
+                }
+            }
+            EXPECT_EQ(pcr.getStageMetadata<StageKey>(*pie, 2), nullptr);
+        }
+    };
+
+    for (bool checksums : {false, true}) {
+        pcw.setPipelineChecksums(checksums);
+        pcw.setCompressPayloads(checksums);
+
+        std::vector<uint8_t> cache(static_cast<size_t>(pcw.getPipelineCacheSize() + 1));
+        pcw.writeHeaderSafetyCriticalOne(cache.size(), cache.data());
+        EXPECT_EQ(pcw.writePipelineIndex(cache.size(), cache.data()), cache.size() - 1);
+
+        std::vector<uint8_t> parallel_cache(cache.size());
+        pcw.writeHeaderSafetyCriticalOne(parallel_cache.size(), parallel_cache.data());
+        EXPECT_EQ(pcw.writePipelineIndexParallel(parallel_cache.size(), parallel_cache.data(), 4), cache.size() - 1);
+        EXPECT_EQ(parallel_cache, cache);
+        cache.pop_back();
+
+        std::vector<uint8_t> streamed;
+        VKSCPipelineCacheCallbackSink sink(
+            [](void *user_data, uint8_t const *data, uint64_t size) {
+                auto output = static_cast<std::vector<uint8_t> *>(user_data);
+                output->insert(output->end(), data, data + size);
+                return true;
+            },
+            &streamed);
+        EXPECT_TRUE(pcw.writePipelineCache(sink));
+        EXPECT_EQ(streamed, cache);
+
+        VKSCPipelineCacheHeaderReader pcr(cache.size(), cache.data());
+        ASSERT_TRUE(pcr.verify());
+        EXPECT_EQ(pcr.verifyChecksums(), checksums);
+        check_metadata(pcr);
+    }
+
+    // the pipeline metadata is smaller than this record
+    std::vector<uint8_t> cache(static_cast<size_t>(pcw.getPipelineCacheSize() + 1));
+    pcw.writeHeaderSafetyCriticalOne(cache.size(), cache.data());
+    pcw.writePipelineIndex(cache.size(), cache.data());
+    cache.pop_back();
+    VKSCPipelineCacheHeaderReader pcr(cache.size(), cache.data());
+    ASSERT_TRUE(pcr.verify());
+    struct LargeKey {
+        uint64_t words[3];
+    };
+    EXPECT_EQ(pcr.getPipelineMetadata<LargeKey>(*pcr.getPipelineIndexEntry(0U)), nullptr);
+
+    // the editor carries the metadata of retained pipelines over, and stores the pipeline metadata of added ones
+    VKSCPipelineCacheEditor editor(pcr);
+    ASSERT_TRUE(editor.open());
+    uint8_t identifier[VK_UUID_SIZE]{3, 2};
+    VKSCPipelineEntry replaced(identifier, 64);
+    replaced.setJsonCode(json.size(), reinterpret_cast<uint8_t const *>(json.data()));
+    replaced.setPipelineMetadata(&pipeline_keys[5]);
+    EXPECT_TRUE(editor.setPipelineEntry(&replaced));
+
+    std::vector<uint8_t> compacted;
+    VKSCPipelineCacheCallbackSink sink(
+        [](void *user_data, uint8_t const *data, uint64_t size) {
+            auto output = static_cast<std::vector<uint8_t> *>(user_data);
+            output->insert(output->end(), data, data + size);
+            return true;
+        },
+        &compacted);
+    EXPECT_TRUE(editor.writeCompactedCache(sink));
+    VKSCPipelineCacheHeaderReader compacted_pcr(compacted.size(), compacted.data());
+    ASSERT_TRUE(compacted_pcr.verify());
+    EXPECT_TRUE(compacted_pcr.verifyChecksums());
+    for (uint32_t i = 0; i < 6; i++) {
+        PipelineKey const *pipeline_key = compacted_pcr.getPipelineMetadata<PipelineKey>(*compacted_pcr.getPipelineIndexEntry(i));
+        ASSERT_NE(pipeline_key, nullptr);
+        EXPECT_EQ(pipeline_key->hash, i == 3 ? pipeline_keys[5].hash : (i < 4 ? pipeline_keys[i].hash : 0u));
+    }
+    // the editor does not align the stage indices, so read the stage metadata as bytes
+    uint32_t size = 0;
+    uint8_t const *stage_metadata = compacted_pcr.getStageMetadata(*compacted_pcr.getPipelineIndexEntry(1U), 1, size);
+    ASSERT_NE(stage_metadata, nullptr);
+    ASSERT_EQ(size, sizeof(StageKey));
+    StageKey stage_key{};
+    memcpy(&stage_key, stage_metadata, sizeof(stage_key));
+    EXPECT_EQ(stage_key.hash, stage_keys[3].hash);
+}
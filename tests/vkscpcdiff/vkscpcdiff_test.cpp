@@ -0,0 +1,144 @@
+/*
+ * Copyright (c) 2025 The Khronos Group Inc.
+ * Copyright (c) 2025 RasterGrid Kft.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <gtest/gtest.h>
+
+#include <vulkan/pcutil/pcfile.hpp>
+#include <vulkan/pcutil/pcreader.hpp>
+#include <vulkan/pcutil/pcwriter.hpp>
+
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#ifndef _WIN32
+#include <sys/wait.h>
+#endif
+
+// Runs vkscpcdiff on pipeline cache files written with VKSCPipelineCacheHeaderWriter.
+
+namespace {
+
+// pipeline <number> of the test caches, its contents are derived from <number> and <variant>
+struct TestPipeline {
+    uint8_t number;
+    uint8_t variant;
+};
+
+std::string GetJson(TestPipeline const &pipeline) {
+    std::string json = "{\n";
+    for (uint32_t i = 0; i < 32; ++i) {
+        json += "    \"field" + std::to_string(i) + "\" : \"VK_FORMAT_R8G8B8A8_UNORM\",\n";
+    }
+    return json + "    \"pipeline\" : " + std::to_string(pipeline.number) +
+           ",\n    \"variant\" : " + std::to_string(pipeline.variant) + "\n}\n";
+}
+
+std::vector<uint32_t> GetCode(TestPipeline const &pipeline) {
+    std::vector<uint32_t> code(1024);
+    for (uint32_t i = 0; i < code.size(); ++i) {
+        code[i] = 0x07230203 + i % 7 + pipeline.number * 0x100 + pipeline.variant;
+    }
+    return code;
+}
+
+std::string GetPath(char const *name) { return testing::TempDir() + "vkscpcdiff_test_" + name; }
+
+bool WriteCache(std::string const &path, std::vector<TestPipeline> const &pipelines, bool compress) {
+    uint8_t const uuid[VK_UUID_SIZE]{0xAB};
+    VKSCPipelineCacheHeaderWriter pcw(0x1234, 0x5678, uuid);
+    pcw.setCompressPayloads(compress);
+
+    std::vector<std::string> jsons;
+    std::vector<std::vector<uint32_t>> codes;
+    for (TestPipeline const &pipeline : pipelines) {
+        jsons.push_back(GetJson(pipeline));
+        codes.push_back(GetCode(pipeline));
+    }
+
+    pcw.reservePipelineEntries(static_cast<uint32_t>(pipelines.size()), pipelines.size());
+    for (size_t i = 0; i < pipelines.size(); ++i) {
+        uint8_t identifier[VK_UUID_SIZE]{pipelines[i].number};
+        VKSCPipelineEntry *entry = pcw.emplacePipelineEntry(identifier, 1024u * pipelines[i].number, 1);
+        entry->setJsonCode(jsons[i].size(), reinterpret_cast<uint8_t const *>(jsons[i].data()));
+        entry->setShaderStageCode(0, codes[i].size() * sizeof(uint32_t), reinterpret_cast<uint8_t const *>(codes[i].data()));
+    }
+
+    VKSCPipelineCacheFileSink sink;
+    if (!sink.open(path.c_str())) return false;
+    bool const written = pcw.writePipelineCache(sink);
+    return sink.close() && written && (!compress || pcw.getCompressionSavings() > 0);
+}
+
+// return: the exit status of vkscpcdiff run on <before> and <after>, its standard output is returned in <output>
+int RunDiff(std::string const &before, std::string const &after, std::string &output) {
+    std::string const outputPath = GetPath("output.txt");
+    std::string command = "\"" VKSCPCDIFF_EXECUTABLE "\" \"" + before + "\" \"" + after + "\" > \"" + outputPath + "\"";
+#ifdef _WIN32
+    // cmd.exe strips the outermost quotes
+    command = "\"" + command + "\"";
+    int const status = std::system(command.c_str());
+#else
+    int const result = std::system(command.c_str());
+    int const status = WIFEXITED(result) ? WEXITSTATUS(result) : -1;
+#endif
+
+    std::ifstream file(outputPath);
+    std::stringstream contents;
+    contents << file.rdbuf();
+    output = contents.str();
+    file.close();
+    remove(outputPath.c_str());
+    return status;
+}
+
+}  // namespace
+
+TEST(Diff, CompressedSameAsUncompressed) {
+    std::string const compressed = GetPath("compressed.bin");
+    std::string const uncompressed = GetPath("uncompressed.bin");
+    std::vector<TestPipeline> const pipelines{{1, 0}, {2, 0}, {3, 0}};
+    ASSERT_TRUE(WriteCache(compressed, pipelines, true));
+    ASSERT_TRUE(WriteCache(uncompressed, pipelines, false));
+
+    std::string output;
+    EXPECT_EQ(RunDiff(compressed, uncompressed, output), 0) << output;
+    EXPECT_NE(output.find("summary: 0 added, 0 removed, 0 changed, 3 unchanged"), std::string::npos) << output;
+    EXPECT_EQ(output.find("changed pipelines:"), std::string::npos) << output;
+
+    EXPECT_EQ(RunDiff(uncompressed, compressed, output), 0) << output;
+    EXPECT_NE(output.find("summary: 0 added, 0 removed, 0 changed, 3 unchanged"), std::string::npos) << output;
+
+    // sizes are reported decompressed
+    std::string const jsonTotal = std::to_string(GetJson({1, 0}).size() + GetJson({2, 0}).size() + GetJson({3, 0}).size());
+    EXPECT_NE(output.find("json total: " + jsonTotal + ","), std::string::npos) << output;
+
+    remove(compressed.c_str());
+    remove(uncompressed.c_str());
+}
+
+TEST(Diff, CompressedChanged) {
+    std::string const compressed = GetPath("changed_compressed.bin");
+    std::string const uncompressed = GetPath("changed_uncompressed.bin");
+    ASSERT_TRUE(WriteCache(compressed, {{1, 0}, {2, 0}, {3, 0}}, true));
+    ASSERT_TRUE(WriteCache(uncompressed, {{1, 0}, {2, 1}, {4, 0}}, false));
+
+    std::string output;
+    EXPECT_EQ(RunDiff(uncompressed, compressed, output), 1) << output;
+    EXPECT_NE(output.find("summary: 1 added, 1 removed, 1 changed, 1 unchanged"), std::string::npos) << output;
+
+    // the json of the changed pipeline has the same size, only its contents differ
+    std::string const jsonSize = std::to_string(GetJson({2, 0}).size());
+    EXPECT_NE(output.find("json: " + jsonSize + " (changed)"), std::string::npos) << output;
+    EXPECT_NE(output.find("(1 stages changed)"), std::string::npos) << output;
+
+    remove(compressed.c_str());
+    remove(uncompressed.c_str());
+}
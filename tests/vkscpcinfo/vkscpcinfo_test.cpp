@@ -0,0 +1,248 @@
+/*
+ * Copyright (c) 2025 The Khronos Group Inc.
+ * Copyright (c) 2025 RasterGrid Kft.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <gtest/gtest.h>
+
+#include <vulkan/pcutil/pcfile.hpp>
+#include <vulkan/pcutil/pcwriter.hpp>
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#ifndef _WIN32
+#include <sys/wait.h>
+#endif
+
+// Runs vkscpcinfo -solve on pipeline cache files written with VKSCPipelineCacheHeaderWriter and checks the solved
+// pool sizes against a brute force solution of the same pool sizing problem.
+
+namespace {
+
+std::string GetPath(char const *name) { return testing::TempDir() + "vkscpcinfo_test_" + name; }
+
+// writes a pipeline cache with one pipeline of each of the given pipelineMemorySize values
+bool WriteCache(std::string const &path, std::vector<uint64_t> const &memorySizes) {
+    uint8_t const uuid[VK_UUID_SIZE]{0xAB};
+    VKSCPipelineCacheHeaderWriter pcw(0x1234, 0x5678, uuid);
+
+    std::string const json = "{\n    \"pipeline\" : 0\n}\n";
+    std::vector<uint32_t> const code(16, 0x07230203);
+
+    pcw.reservePipelineEntries(static_cast<uint32_t>(memorySizes.size()), memorySizes.size());
+    for (size_t i = 0; i < memorySizes.size(); ++i) {
+        uint8_t identifier[VK_UUID_SIZE]{static_cast<uint8_t>(i), static_cast<uint8_t>(i >> 8)};
+        VKSCPipelineEntry *entry = pcw.emplacePipelineEntry(identifier, memorySizes[i], 1);
+        entry->setJsonCode(json.size(), reinterpret_cast<uint8_t const *>(json.data()));
+        entry->setShaderStageCode(0, code.size() * sizeof(uint32_t), reinterpret_cast<uint8_t const *>(code.data()));
+    }
+
+    VKSCPipelineCacheFileSink sink;
+    if (!sink.open(path.c_str())) return false;
+    bool const written = pcw.writePipelineCache(sink);
+    return sink.close() && written;
+}
+
+// return: the exit status of vkscpcinfo run with <args> on <path>, its standard output is returned in <output>
+int RunInfo(std::string const &args, std::string const &path, std::string &output) {
+    std::string const outputPath = GetPath("output.txt");
+    std::string command = "\"" VKSCPCINFO_EXECUTABLE "\" " + args + " \"" + path + "\" > \"" + outputPath + "\"";
+#ifdef _WIN32
+    // cmd.exe strips the outermost quotes
+    command = "\"" + command + "\"";
+    int const status = std::system(command.c_str());
+#else
+    int const result = std::system(command.c_str());
+    int const status = WIFEXITED(result) ? WEXITSTATUS(result) : -1;
+#endif
+
+    std::ifstream file(outputPath);
+    std::stringstream contents;
+    contents << file.rdbuf();
+    output = contents.str();
+    file.close();
+    remove(outputPath.c_str());
+    return status;
+}
+
+struct PoolSize {
+    uint64_t entrySize;
+    uint64_t entryCount;
+};
+
+// return: the number following "<key>": in <output> from <pos>, <pos> is moved past it, or false if not found
+bool FindNumber(std::string const &output, char const *key, size_t &pos, uint64_t &value) {
+    pos = output.find(std::string("\"") + key + "\": ", pos);
+    if (pos == std::string::npos) return false;
+    pos += strlen(key) + 4;
+    value = std::stoull(output.substr(pos, output.find_first_not_of("0123456789", pos) - pos));
+    return true;
+}
+
+// return: the solvedPools array of the json output, or false if it is missing
+bool ParseSolvedPools(std::string const &output, std::vector<PoolSize> &pools, uint64_t &reservedSpace) {
+    pools.clear();
+    size_t const begin = output.find("\"solvedPools\": [");
+    size_t const end = output.find(']', begin);
+    if (begin == std::string::npos || end == std::string::npos) return false;
+
+    size_t pos = begin;
+    PoolSize pool{};
+    while (FindNumber(output, "poolEntrySize", pos, pool.entrySize) && pos < end) {
+        if (!FindNumber(output, "poolEntryCount", pos, pool.entryCount)) return false;
+        pools.push_back(pool);
+    }
+    pos = end;
+    return FindNumber(output, "solvedReservedSpace", pos, reservedSpace);
+}
+
+// return: the smallest reserved space covering <memorySizes> with at most <maxPoolCount> pools of at most
+// <maxEntryCount> entries (0 means no limit), or UINT64_MAX if there is no such solution
+uint64_t GetOptimalReservedSpace(std::vector<uint64_t> memorySizes, uint32_t maxPoolCount, uint64_t maxEntryCount) {
+    constexpr uint64_t kNone = std::numeric_limits<uint64_t>::max();
+    std::sort(memorySizes.begin(), memorySizes.end());
+    size_t const count = memorySizes.size();
+
+    // cost[i]: smallest reserved space covering the first i pipelines with the pools considered so far
+    std::vector<uint64_t> cost(count + 1, kNone);
+    cost[0] = 0;
+    for (uint32_t p = 0; p < maxPoolCount; ++p) {
+        std::vector<uint64_t> next = cost;
+        for (size_t i = 1; i <= count; ++i) {
+            for (size_t first = 0; first < i; ++first) {
+                if (cost[first] == kNone || (maxEntryCount > 0 && i - first > maxEntryCount)) continue;
+                next[i] = std::min(next[i], cost[first] + memorySizes[i - 1] * (i - first));
+            }
+        }
+        cost = next;
+    }
+    return cost[count];
+}
+
+// checks that the solved pools serve every pipeline within the limits with the optimal reserved space
+void CheckSolution(std::vector<uint64_t> memorySizes, uint32_t maxPoolCount, uint64_t maxEntryCount) {
+    std::string const path = GetPath("solve.bin");
+    ASSERT_TRUE(WriteCache(path, memorySizes));
+
+    std::string args = "-format json -solve " + std::to_string(maxPoolCount);
+    if (maxEntryCount > 0) {
+        args += " -maxentries " + std::to_string(maxEntryCount);
+    }
+    SCOPED_TRACE(args);
+
+    std::string output;
+    ASSERT_EQ(RunInfo(args, path, output), 0) << output;
+    remove(path.c_str());
+
+    std::vector<PoolSize> pools;
+    uint64_t reservedSpace = 0;
+    ASSERT_TRUE(ParseSolvedPools(output, pools, reservedSpace)) << output;
+    EXPECT_LE(pools.size(), maxPoolCount) << output;
+    EXPECT_EQ(reservedSpace, GetOptimalReservedSpace(memorySizes, maxPoolCount, maxEntryCount)) << output;
+
+    // assign the pipelines in increasing size to the pools in increasing entry size
+    std::sort(memorySizes.begin(), memorySizes.end());
+    std::sort(pools.begin(), pools.end(), [](PoolSize const &a, PoolSize const &b) { return a.entrySize < b.entrySize; });
+    size_t pipeline = 0;
+    for (PoolSize const &pool : pools) {
+        if (maxEntryCount > 0) {
+            EXPECT_LE(pool.entryCount, maxEntryCount) << output;
+        }
+        for (uint64_t i = 0; i < pool.entryCount && pipeline < memorySizes.size(); ++i, ++pipeline) {
+            EXPECT_LE(memorySizes[pipeline], pool.entrySize) << output;
+        }
+    }
+    EXPECT_EQ(pipeline, memorySizes.size()) << output;
+}
+
+// pipeline memory sizes with long runs of equal sizes, the way pipelines created from the same state are sized
+std::vector<uint64_t> GetMemorySizes(uint32_t count, uint32_t seed) {
+    std::mt19937 random(seed);
+    std::vector<uint64_t> const distinctSizes{1024, 1536, 4096, 4160, 8192, 20000, 65536};
+    std::vector<uint64_t> memorySizes;
+    while (memorySizes.size() < count) {
+        uint64_t const memorySize = distinctSizes[random() % distinctSizes.size()];
+        for (uint32_t run = random() % 6 + 1; run > 0 && memorySizes.size() < count; --run) {
+            memorySizes.push_back(memorySize);
+        }
+    }
+    return memorySizes;
+}
+
+}  // namespace
+
+TEST(Solve, Unlimited) {
+    for (uint32_t seed = 1; seed <= 3; ++seed) {
+        std::vector<uint64_t> const memorySizes = GetMemorySizes(40, seed);
+        for (uint32_t maxPoolCount : {1, 2, 3, 5, 8}) {
+            CheckSolution(memorySizes, maxPoolCount, 0);
+        }
+    }
+}
+
+TEST(Solve, MaxEntries) {
+    for (uint32_t seed = 4; seed <= 6; ++seed) {
+        std::vector<uint64_t> const memorySizes = GetMemorySizes(30, seed);
+        CheckSolution(memorySizes, 10, 3);
+        CheckSolution(memorySizes, 8, 4);
+        CheckSolution(memorySizes, 4, 8);
+        CheckSolution(memorySizes, 3, 29);
+    }
+}
+
+TEST(Solve, EqualSizes) {
+    std::vector<uint64_t> const memorySizes(12, 4096);
+    CheckSolution(memorySizes, 1, 0);
+    CheckSolution(memorySizes, 3, 0);
+    CheckSolution(memorySizes, 3, 4);
+    CheckSolution(memorySizes, 5, 5);
+}
+
+TEST(Solve, Infeasible) {
+    std::string const path = GetPath("infeasible.bin");
+    ASSERT_TRUE(WriteCache(path, GetMemorySizes(20, 7)));
+
+    std::string output;
+    EXPECT_NE(RunInfo("-format json -solve 3 -maxentries 6", path, output), 0) << output;
+    EXPECT_EQ(RunInfo("-format json -solve 4 -maxentries 5", path, output), 0) << output;
+
+    remove(path.c_str());
+}
+
+TEST(Format, JsonUnfitCount) {
+    std::string const path = GetPath("unfit.bin");
+    ASSERT_TRUE(WriteCache(path, {1024, 2048, 4096, 8192, 8192}));
+
+    std::string output;
+    EXPECT_EQ(RunInfo("-format json -pool 4096", path, output), 0) << output;
+    EXPECT_NE(output.find("\"unfitCount\": 2"), std::string::npos) << output;
+
+    // without -pool there are no pool statistics
+    EXPECT_EQ(RunInfo("-format json", path, output), 0) << output;
+    EXPECT_EQ(output.find("\"unfitCount\""), std::string::npos) << output;
+    EXPECT_EQ(output.find("\"poolSize\""), std::string::npos) << output;
+
+    remove(path.c_str());
+}
+
+TEST(Format, CsvSolveRejected) {
+    std::string const path = GetPath("csv.bin");
+    ASSERT_TRUE(WriteCache(path, {1024, 2048}));
+
+    std::string output;
+    EXPECT_NE(RunInfo("-format csv -solve 1", path, output), 0) << output;
+    EXPECT_EQ(RunInfo("-format csv", path, output), 0) << output;
+
+    remove(path.c_str());
+}
@@ -0,0 +1,297 @@
+/*
+ * Copyright (c) 2025 The Khronos Group Inc.
+ * Copyright (c) 2025 RasterGrid Kft.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <gtest/gtest.h>
+
+#include <vulkan/pcutil/pcfile.hpp>
+#include <vulkan/pcutil/pcreader.hpp>
+#include <vulkan/pcutil/pcwriter.hpp>
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#ifndef _WIN32
+#include <sys/wait.h>
+#endif
+
+// Runs vkscpcmerge on pipeline cache files written with VKSCPipelineCacheHeaderWriter and checks the output
+// with VKSCPipelineCacheHeaderReader.
+
+namespace {
+
+constexpr uint32_t kVendorID = 0x1234;
+constexpr uint32_t kDeviceID = 0x5678;
+
+// pipeline <number> of the test caches, its contents are derived from <number> and <variant>
+struct TestPipeline {
+    uint8_t number;
+    uint8_t variant;
+};
+
+struct TestDevice {
+    uint32_t vendorID{kVendorID};
+    uint32_t deviceID{kDeviceID};
+    uint8_t uuid{0xAB};
+};
+
+void GetIdentifier(uint8_t number, uint8_t identifier[VK_UUID_SIZE]) {
+    for (uint32_t i = 0; i < VK_UUID_SIZE; ++i) {
+        identifier[i] = static_cast<uint8_t>(0x10 * i + number);
+    }
+}
+
+std::string GetIdentifierText(uint8_t number) {
+    uint8_t identifier[VK_UUID_SIZE];
+    GetIdentifier(number, identifier);
+    std::ostringstream text;
+    text << "0x" << std::uppercase << std::hex;
+    for (uint32_t i = 0; i < VK_UUID_SIZE; ++i) {
+        text.width(2);
+        text.fill('0');
+        text << static_cast<unsigned int>(identifier[i]);
+    }
+    return text.str();
+}
+
+std::string GetJson(TestPipeline const &pipeline) {
+    return "{ \"pipeline\" : " + std::to_string(pipeline.number) + ", \"variant\" : " + std::to_string(pipeline.variant) + " }";
+}
+
+// all pipelines share the code of the first stage, the second stage is specific to the pipeline
+std::vector<uint32_t> GetCode(TestPipeline const &pipeline, uint32_t stage) {
+    std::vector<uint32_t> code(64, 0x07230203);
+    if (stage > 0) {
+        for (uint32_t i = 1; i < code.size(); ++i) {
+            code[i] = i * 0x01000193 + pipeline.number * 0x100 + pipeline.variant;
+        }
+    }
+    return code;
+}
+
+uint64_t GetMemorySize(TestPipeline const &pipeline) { return 1024u * pipeline.number; }
+
+std::string GetPath(char const *name) { return testing::TempDir() + "vkscpcmerge_test_" + name; }
+
+bool WriteCache(std::string const &path, std::vector<TestPipeline> const &pipelines, TestDevice const &device = {}) {
+    uint8_t uuid[VK_UUID_SIZE];
+    std::fill(uuid, uuid + VK_UUID_SIZE, device.uuid);
+    VKSCPipelineCacheHeaderWriter pcw(device.vendorID, device.deviceID, uuid);
+
+    std::vector<std::string> jsons;
+    std::vector<std::vector<uint32_t>> codes;
+    for (TestPipeline const &pipeline : pipelines) {
+        jsons.push_back(GetJson(pipeline));
+        codes.push_back(GetCode(pipeline, 0));
+        codes.push_back(GetCode(pipeline, 1));
+    }
+
+    pcw.reservePipelineEntries(static_cast<uint32_t>(pipelines.size()), 2 * pipelines.size());
+    for (size_t i = 0; i < pipelines.size(); ++i) {
+        uint8_t identifier[VK_UUID_SIZE];
+        GetIdentifier(pipelines[i].number, identifier);
+        VKSCPipelineEntry *entry = pcw.emplacePipelineEntry(identifier, GetMemorySize(pipelines[i]), 2);
+        entry->setJsonCode(jsons[i].size(), reinterpret_cast<uint8_t const *>(jsons[i].data()));
+        for (uint32_t stage = 0; stage < 2; ++stage) {
+            std::vector<uint32_t> const &code = codes[2 * i + stage];
+            entry->setShaderStageCode(stage, code.size() * sizeof(uint32_t), reinterpret_cast<uint8_t const *>(code.data()));
+        }
+    }
+
+    VKSCPipelineCacheFileSink sink;
+    if (!sink.open(path.c_str())) return false;
+    bool const written = pcw.writePipelineCache(sink);
+    return sink.close() && written;
+}
+
+void WriteIdentifierList(std::string const &path, std::vector<uint8_t> const &numbers) {
+    std::ofstream file(path);
+    file << "# pipelines of the test" << std::endl;
+    for (uint8_t number : numbers) {
+        file << GetIdentifierText(number) << std::endl;
+    }
+}
+
+// return: the exit status of vkscpcmerge run with <arguments>
+int RunMerge(std::string const &arguments) {
+    std::string command = "\"" VKSCPCMERGE_EXECUTABLE "\" " + arguments;
+#ifdef _WIN32
+    // cmd.exe strips the outermost quotes
+    command = "\"" + command + "\"";
+    return std::system(command.c_str());
+#else
+    int const status = std::system(command.c_str());
+    return WIFEXITED(status) ? WEXITSTATUS(status) : -1;
+#endif
+}
+
+std::string Quote(std::string const &path) { return "\"" + path + "\""; }
+
+uint64_t GetFileSize(std::string const &path) {
+    std::ifstream file(path, std::ios::binary | std::ios::ate);
+    return file ? static_cast<uint64_t>(file.tellg()) : 0;
+}
+
+// check that the cache at <path> contains exactly <expected>, in order
+void ExpectCache(std::string const &path, std::vector<TestPipeline> const &expected) {
+    VKSCPipelineCacheFile file;
+    ASSERT_TRUE(file.open(path.c_str()));
+    VKSCPipelineCacheHeaderReader pcr(file.getSize(), file.getData());
+    ASSERT_TRUE(pcr.isValid());
+    ASSERT_TRUE(pcr.verify());
+
+    VkPipelineCacheHeaderVersionOne const *hv1 = pcr.getHeaderVersionOne();
+    EXPECT_EQ(hv1->vendorID, kVendorID);
+    EXPECT_EQ(hv1->deviceID, kDeviceID);
+
+    ASSERT_EQ(pcr.getPipelineIndexCount(), expected.size());
+    for (uint32_t i = 0; i < pcr.getPipelineIndexCount(); ++i) {
+        VkPipelineCacheSafetyCriticalIndexEntry const *pie = pcr.getPipelineIndexEntry(i);
+        ASSERT_TRUE(pie);
+
+        uint8_t identifier[VK_UUID_SIZE];
+        GetIdentifier(expected[i].number, identifier);
+        EXPECT_EQ(memcmp(pie->pipelineIdentifier, identifier, VK_UUID_SIZE), 0) << "pipeline " << i;
+        EXPECT_EQ(pie->pipelineMemorySize, GetMemorySize(expected[i]));
+
+        std::string const json = GetJson(expected[i]);
+        ASSERT_EQ(pie->jsonSize, json.size());
+        EXPECT_EQ(memcmp(pcr.getJson(*pie), json.data(), json.size()), 0) << "pipeline " << i;
+
+        ASSERT_EQ(pie->stageIndexCount, 2u);
+        for (uint32_t stage = 0; stage < 2; ++stage) {
+            VkPipelineCacheStageValidationIndexEntry const *sie = pcr.getStageIndexEntry(*pie, stage);
+            ASSERT_TRUE(sie);
+            std::vector<uint32_t> const code = GetCode(expected[i], stage);
+            ASSERT_EQ(sie->codeSize, code.size() * sizeof(uint32_t));
+            EXPECT_EQ(memcmp(pcr.getSPIRV(*sie), code.data(), code.size() * sizeof(uint32_t)), 0) << "pipeline " << i;
+        }
+    }
+}
+
+}  // namespace
+
+TEST(Merge, TwoCaches) {
+    std::string const a = GetPath("two_a.bin");
+    std::string const b = GetPath("two_b.bin");
+    std::string const output = GetPath("two_output.bin");
+    ASSERT_TRUE(WriteCache(a, {{1, 0}, {2, 0}, {3, 0}}));
+    ASSERT_TRUE(WriteCache(b, {{3, 0}, {4, 0}, {2, 1}}));
+
+    // identical and differing duplicates both keep the pipeline of the first input
+    EXPECT_EQ(RunMerge("-o " + Quote(output) + " " + Quote(a) + " " + Quote(b)), 0);
+    ExpectCache(output, {{1, 0}, {2, 0}, {3, 0}, {4, 0}});
+
+    EXPECT_EQ(RunMerge("-o " + Quote(output) + " " + Quote(b) + " " + Quote(a)), 0);
+    ExpectCache(output, {{3, 0}, {4, 0}, {2, 1}, {1, 0}});
+
+    remove(a.c_str());
+    remove(b.c_str());
+    remove(output.c_str());
+}
+
+TEST(Merge, Deduplicate) {
+    std::string const a = GetPath("dedup_a.bin");
+    std::string const b = GetPath("dedup_b.bin");
+    std::string const output = GetPath("dedup_output.bin");
+    std::string const dedupOutput = GetPath("dedup_output_dedup.bin");
+    ASSERT_TRUE(WriteCache(a, {{1, 0}, {2, 0}}));
+    ASSERT_TRUE(WriteCache(b, {{3, 0}, {4, 0}}));
+
+    EXPECT_EQ(RunMerge("-o " + Quote(output) + " " + Quote(a) + " " + Quote(b)), 0);
+    EXPECT_EQ(RunMerge("-dedup -o " + Quote(dedupOutput) + " " + Quote(a) + " " + Quote(b)), 0);
+    ExpectCache(output, {{1, 0}, {2, 0}, {3, 0}, {4, 0}});
+    ExpectCache(dedupOutput, {{1, 0}, {2, 0}, {3, 0}, {4, 0}});
+
+    // the first stage of the 4 pipelines is stored once
+    EXPECT_EQ(GetFileSize(output) - GetFileSize(dedupOutput), 3 * GetCode({1, 0}, 0).size() * sizeof(uint32_t));
+
+    remove(a.c_str());
+    remove(b.c_str());
+    remove(output.c_str());
+    remove(dedupOutput.c_str());
+}
+
+TEST(Merge, IncludeExclude) {
+    std::string const a = GetPath("split_a.bin");
+    std::string const b = GetPath("split_b.bin");
+    std::string const list = GetPath("split_list.txt");
+    std::string const included = GetPath("split_included.bin");
+    std::string const excluded = GetPath("split_excluded.bin");
+    ASSERT_TRUE(WriteCache(a, {{1, 0}, {2, 0}, {3, 0}}));
+    ASSERT_TRUE(WriteCache(b, {{4, 0}, {5, 0}}));
+    WriteIdentifierList(list, {5, 1, 6});
+
+    EXPECT_EQ(RunMerge("-include " + Quote(list) + " -o " + Quote(included) + " " + Quote(a) + " " + Quote(b)), 0);
+    ExpectCache(included, {{1, 0}, {5, 0}});
+
+    EXPECT_EQ(RunMerge("-exclude " + Quote(list) + " -o " + Quote(excluded) + " " + Quote(a) + " " + Quote(b)), 0);
+    ExpectCache(excluded, {{2, 0}, {3, 0}, {4, 0}});
+
+    // malformed identifier lists are rejected
+    {
+        std::ofstream file(list);
+        file << "0x1234" << std::endl;
+    }
+    EXPECT_NE(RunMerge("-include " + Quote(list) + " -o " + Quote(included) + " " + Quote(a)), 0);
+
+    remove(a.c_str());
+    remove(b.c_str());
+    remove(list.c_str());
+    remove(included.c_str());
+    remove(excluded.c_str());
+}
+
+TEST(Merge, DifferentDevice) {
+    std::string const a = GetPath("device_a.bin");
+    std::string const b = GetPath("device_b.bin");
+    std::string const output = GetPath("device_output.bin");
+    ASSERT_TRUE(WriteCache(a, {{1, 0}}));
+
+    TestDevice vendor;
+    vendor.vendorID = kVendorID + 1;
+    TestDevice device;
+    device.deviceID = kDeviceID + 1;
+    TestDevice uuid;
+    uuid.uuid = 0xCD;
+    for (TestDevice const &other : {vendor, device, uuid}) {
+        ASSERT_TRUE(WriteCache(b, {{2, 0}}, other));
+        remove(output.c_str());
+        EXPECT_NE(RunMerge("-o " + Quote(output) + " " + Quote(a) + " " + Quote(b)), 0);
+        EXPECT_NE(RunMerge("-o " + Quote(output) + " " + Quote(b) + " " + Quote(a)), 0);
+
+        // nothing is written if the inputs are rejected
+        FILE *file = fopen(output.c_str(), "rb");
+        EXPECT_FALSE(file);
+        if (file) fclose(file);
+    }
+
+    remove(a.c_str());
+    remove(b.c_str());
+}
+
+TEST(Merge, OutputIsInput) {
+    std::string const a = GetPath("inplace_a.bin");
+    std::string const b = GetPath("inplace_b.bin");
+    ASSERT_TRUE(WriteCache(a, {{1, 0}, {2, 0}}));
+    ASSERT_TRUE(WriteCache(b, {{3, 0}}));
+
+    EXPECT_NE(RunMerge("-o " + Quote(a) + " " + Quote(a)), 0);
+    EXPECT_NE(RunMerge("-o " + Quote(b) + " " + Quote(a) + " " + Quote(b)), 0);
+
+    // the inputs are left intact
+    ExpectCache(a, {{1, 0}, {2, 0}});
+    ExpectCache(b, {{3, 0}});
+
+    remove(a.c_str());
+    remove(b.c_str());
+}
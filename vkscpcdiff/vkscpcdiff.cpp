@@ -0,0 +1,402 @@
+/*
+ * Copyright (c) 2025 The Khronos Group Inc.
+ * Copyright (c) 2025 RasterGrid Kft.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <algorithm>
+#include <cctype>
+#include <cstddef>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <vulkan/pcutil/pcfile.hpp>
+#include <vulkan/pcutil/pcreader.hpp>
+#include <vulkan/pcutil/pcwriter.hpp>
+#include <vulkan/vulkan_sc.h>
+
+// Compares two pipeline cache files pipeline by pipeline.
+//
+// The pipelines of the two caches are aligned by pipelineIdentifier, then added, removed and changed
+// pipelines are reported along with their pipelineMemorySize, json and SPIR-V size changes, so that
+// growth of the pipeline pools can be traced back to individual pipelines.
+// Payloads are compared by their decompressed contents, so a cache written with payload compression
+// matches the same cache written without. Payloads of equal size are compared by their hashes, which
+// are computed at most once per payload of each cache, so payloads shared by multiple pipelines are
+// only read once.
+
+namespace {
+
+// exit codes follow the convention of diff
+constexpr int kExitSame = 0;
+constexpr int kExitDifferent = 1;
+constexpr int kExitError = 2;
+
+std::ostream &operator<<(std::ostream &out, uint8_t const uuid[VK_UUID_SIZE]) {
+    out << "0x" << std::uppercase << std::hex;
+    for (uint32_t i = 0; i < VK_UUID_SIZE; ++i) {
+        out << std::setfill('0') << std::setw(2) << static_cast<unsigned int>(uuid[i]);
+    }
+    out << std::dec << std::setfill(' ');
+    return out;
+}
+
+// signed difference between two sizes, e.g. "+17" or "-3"
+std::string delta(uint64_t before, uint64_t after) {
+    return after >= before ? "+" + std::to_string(after - before) : "-" + std::to_string(before - after);
+}
+
+// "<before> -> <after> (<delta>)", or just "<before>" if unchanged
+std::string change(uint64_t before, uint64_t after) {
+    if (before == after) return std::to_string(before);
+    return std::to_string(before) + " -> " + std::to_string(after) + " (" + delta(before, after) + ")";
+}
+
+// hashes of the decompressed payloads of a pipeline cache, memoized by payload offset
+class PayloadHashes {
+  public:
+    PayloadHashes(VKSCPipelineCacheHeaderReader const &reader, char const *filename) : m_Reader(reader), m_Filename(filename) {}
+
+    uint64_t getJsonHash(VkPipelineCacheSafetyCriticalIndexEntry const &pie) {
+        return get(pie.jsonOffset, pie.jsonSize, m_Reader.getJson(pie),
+                   [&](auto &&output) { return m_Reader.readJson(pie, output); });
+    }
+
+    uint64_t getSPIRVHash(VkPipelineCacheStageValidationIndexEntry const &sie) {
+        return get(sie.codeOffset, sie.codeSize, m_Reader.getSPIRV(sie),
+                   [&](auto &&output) { return m_Reader.readSPIRV(sie, output); });
+    }
+
+    VKSCPipelineCacheHeaderReader const &reader() const { return m_Reader; }
+
+  private:
+    // <read> passes the decompressed payload to a callback, it is only used for compressed payloads
+    template <typename Read>
+    uint64_t get(uint64_t offset, uint64_t size, uint8_t const *data, Read &&read) {
+        auto const it = m_Hashes.find(offset);
+        if (it != m_Hashes.end() && it->second.size == size) {
+            return it->second.hash;
+        }
+
+        uint64_t hash = 0;
+        if (VKSCPayloadFrame::isFrame(size, data)) {
+            m_Buffer.clear();
+            bool const decompressed = read([this](uint8_t const *piece, uint64_t pieceSize) {
+                m_Buffer.insert(m_Buffer.end(), piece, piece + pieceSize);
+                return true;
+            });
+            if (!decompressed) {
+                std::cerr << "error: " << m_Filename << " contains a compressed payload at offset " << offset
+                          << " that cannot be decompressed" << std::endl;
+                exit(kExitError);
+            }
+            hash = VKSCPipelineCachePayloadTable::hashPayload(m_Buffer.size(), m_Buffer.data());
+        } else {
+            hash = VKSCPipelineCachePayloadTable::hashPayload(size, data);
+        }
+        m_Hashes[offset] = Entry{size, hash};
+        return hash;
+    }
+
+    struct Entry {
+        uint64_t size;
+        uint64_t hash;
+    };
+
+    VKSCPipelineCacheHeaderReader const &m_Reader;
+    char const *m_Filename;
+    std::unordered_map<uint64_t, Entry> m_Hashes;
+    std::vector<uint8_t> m_Buffer;  // decompressed payload being hashed
+};
+
+struct PipelineChange {
+    VkPipelineCacheSafetyCriticalIndexEntry const *before;
+    VkPipelineCacheSafetyCriticalIndexEntry const *after;
+    bool jsonChanged;
+    uint64_t jsonSizeBefore;
+    uint64_t jsonSizeAfter;
+    uint64_t codeSizeBefore;
+    uint64_t codeSizeAfter;
+    uint32_t changedStageCount;
+};
+
+// sizes of a pipeline cache relevant for pool budgets, json and SPIR-V sizes are counted decompressed
+struct CacheTotals {
+    uint64_t memorySize{};
+    uint64_t maxMemorySize{};
+    uint64_t jsonSize{};
+    uint64_t codeSize{};
+};
+
+uint64_t getCodeSize(VKSCPipelineCacheHeaderReader const &pcr, VkPipelineCacheSafetyCriticalIndexEntry const &pie) {
+    uint64_t codeSize = 0;
+    for (VkPipelineCacheStageValidationIndexEntry const &sie : pcr.stages(pie)) {
+        codeSize += pcr.getSPIRVSize(sie);
+    }
+    return codeSize;
+}
+
+CacheTotals getTotals(VKSCPipelineCacheHeaderReader const &pcr) {
+    CacheTotals totals;
+    for (VkPipelineCacheSafetyCriticalIndexEntry const &pie : pcr.pipelines()) {
+        totals.memorySize += pie.pipelineMemorySize;
+        totals.maxMemorySize = std::max(totals.maxMemorySize, pie.pipelineMemorySize);
+        totals.jsonSize += pcr.getJsonSize(pie);
+        totals.codeSize += getCodeSize(pcr, pie);
+    }
+    return totals;
+}
+
+// compare the contents of the same pipeline in the two caches
+PipelineChange comparePipeline(PayloadHashes &before, VkPipelineCacheSafetyCriticalIndexEntry const &pieBefore,
+                               PayloadHashes &after, VkPipelineCacheSafetyCriticalIndexEntry const &pieAfter) {
+    VKSCPipelineCacheHeaderReader const &pcrBefore = before.reader();
+    VKSCPipelineCacheHeaderReader const &pcrAfter = after.reader();
+
+    PipelineChange result{&pieBefore, &pieAfter, false, 0, 0, 0, 0, 0};
+    result.jsonSizeBefore = pcrBefore.getJsonSize(pieBefore);
+    result.jsonSizeAfter = pcrAfter.getJsonSize(pieAfter);
+    result.jsonChanged = result.jsonSizeBefore != result.jsonSizeAfter ||
+                         (result.jsonSizeBefore > 0 && before.getJsonHash(pieBefore) != after.getJsonHash(pieAfter));
+
+    VKSCStageIndexRange const stagesBefore = pcrBefore.stages(pieBefore);
+    VKSCStageIndexRange const stagesAfter = pcrAfter.stages(pieAfter);
+    uint32_t const stageCount = std::max(stagesBefore.size(), stagesAfter.size());
+    for (uint32_t i = 0; i < stageCount; ++i) {
+        if (i >= stagesBefore.size() || i >= stagesAfter.size()) {
+            ++result.changedStageCount;
+            continue;
+        }
+        VkPipelineCacheStageValidationIndexEntry const &sieBefore = stagesBefore[i];
+        VkPipelineCacheStageValidationIndexEntry const &sieAfter = stagesAfter[i];
+        uint64_t const codeSizeBefore = pcrBefore.getSPIRVSize(sieBefore);
+        if (codeSizeBefore != pcrAfter.getSPIRVSize(sieAfter) ||
+            (codeSizeBefore > 0 && before.getSPIRVHash(sieBefore) != after.getSPIRVHash(sieAfter))) {
+            ++result.changedStageCount;
+        }
+    }
+    result.codeSizeBefore = getCodeSize(pcrBefore, pieBefore);
+    result.codeSizeAfter = getCodeSize(pcrAfter, pieAfter);
+    return result;
+}
+
+bool isChanged(PipelineChange const &change) {
+    return change.before->pipelineMemorySize != change.after->pipelineMemorySize || change.jsonChanged ||
+           change.changedStageCount > 0;
+}
+
+// number of pipelines whose pipelineMemorySize fits in each of <poolSizes> but not in the smaller ones, the last
+// element counts the pipelines that do not fit in any pool
+std::vector<uint64_t> bucketPipelines(VKSCPipelineCacheHeaderReader const &pcr, std::vector<uint64_t> const &poolSizes) {
+    std::vector<uint64_t> counts(poolSizes.size() + 1, 0);
+    for (VkPipelineCacheSafetyCriticalIndexEntry const &pie : pcr.pipelines()) {
+        size_t const pool = std::lower_bound(poolSizes.begin(), poolSizes.end(), pie.pipelineMemorySize) - poolSizes.begin();
+        ++counts[pool];
+    }
+    return counts;
+}
+
+bool openCache(char const *path, VKSCPipelineCacheFile &file) {
+    if (!file.open(path)) {
+        std::cerr << "error: failed to open " << path << std::endl;
+        return false;
+    }
+    return true;
+}
+
+void printUsageAndExit(char *executable, int exitCode) {
+    std::cerr << "usage: " << executable << " [-h|--help] [-pool <poolsize>]... <old_pipeline_cache_file> <new_pipeline_cache_file>"
+              << std::endl
+              << std::endl;
+    std::cerr << "  -h | --help: print this usage message" << std::endl << std::endl;
+    std::cerr << "  -pool <poolsize>: compare the number of pipelines fitting in a pool of size <poolsize>" << std::endl
+              << std::endl;
+    std::cerr << "Pipelines are matched by pipelineIdentifier, changed pipelines are listed in decreasing order of their"
+              << std::endl
+              << "pipelineMemorySize growth. The exit status is 0 if the caches contain the same pipelines, 1 if they" << std::endl
+              << "differ and 2 on errors." << std::endl;
+
+    exit(exitCode);
+}
+
+}  // namespace
+
+int main(int argc, char **argv) {
+    char const *filenames[2]{nullptr, nullptr};
+    uint32_t filenameCount{0};
+    std::vector<uint64_t> poolSizes;
+
+    if (argc < 2) {
+        printUsageAndExit(argv[0], kExitError);
+    }
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-pool") == 0) {
+            if (++i >= argc) {
+                std::cerr << "missing parameter <poolsize>" << std::endl << std::endl;
+                printUsageAndExit(argv[0], kExitError);
+            }
+            char *end = nullptr;
+            unsigned long long const size = strtoull(argv[i], &end, 10);
+            if (!std::isdigit(static_cast<unsigned char>(argv[i][0])) || *end != '\0') {
+                std::cerr << "parameter <poolsize> must be numeric, found " << argv[i] << std::endl << std::endl;
+                printUsageAndExit(argv[0], kExitError);
+            }
+            poolSizes.push_back(size);
+        } else if (strcmp(argv[i], "-h") == 0 || strcmp(argv[i], "--help") == 0) {
+            printUsageAndExit(argv[0], kExitSame);
+        } else if (argv[i][0] != '-' && filenameCount < 2) {
+            filenames[filenameCount++] = argv[i];
+        } else {
+            std::cerr << "unrecognized argument: " << argv[i] << std::endl << std::endl;
+            printUsageAndExit(argv[0], kExitError);
+        }
+    }
+
+    if (filenameCount != 2) {
+        std::cerr << "missing parameter <" << (filenameCount == 0 ? "old" : "new") << "_pipeline_cache_file>" << std::endl
+                  << std::endl;
+        printUsageAndExit(argv[0], kExitError);
+    }
+    std::sort(poolSizes.begin(), poolSizes.end());
+
+    VKSCPipelineCacheFile fileBefore;
+    VKSCPipelineCacheFile fileAfter;
+    if (!openCache(filenames[0], fileBefore) || !openCache(filenames[1], fileAfter)) {
+        return kExitError;
+    }
+
+    VKSCPipelineCacheHeaderReader pcrBefore(fileBefore.getSize(), fileBefore.getData());
+    VKSCPipelineCacheHeaderReader pcrAfter(fileAfter.getSize(), fileAfter.getData());
+    VKSCPipelineCacheIndex indexBefore(pcrBefore);
+    VKSCPipelineCacheIndex indexAfter(pcrAfter);
+    for (uint32_t i = 0; i < 2; ++i) {
+        VKSCPipelineCacheHeaderReader &pcr = (i == 0) ? pcrBefore : pcrAfter;
+        VKSCPipelineCacheIndex &index = (i == 0) ? indexBefore : indexAfter;
+        if (!pcr.isValid() || !pcr.verify() || !index.build()) {
+            std::cerr << "error: " << filenames[i] << " is not a valid VK_PIPELINE_CACHE_HEADER_VERSION_SAFETY_CRITICAL_ONE cache"
+                      << std::endl;
+            return kExitError;
+        }
+    }
+
+    std::cout << "old: " << filenames[0] << " (" << pcrBefore.getPipelineIndexCount() << " pipelines)" << std::endl;
+    std::cout << "new: " << filenames[1] << " (" << pcrAfter.getPipelineIndexCount() << " pipelines)" << std::endl;
+
+    VkPipelineCacheHeaderVersionOne const *hv1Before = pcrBefore.getHeaderVersionOne();
+    VkPipelineCacheHeaderVersionOne const *hv1After = pcrAfter.getHeaderVersionOne();
+    bool const deviceChanged = hv1Before->vendorID != hv1After->vendorID || hv1Before->deviceID != hv1After->deviceID ||
+                               memcmp(hv1Before->pipelineCacheUUID, hv1After->pipelineCacheUUID, VK_UUID_SIZE) != 0;
+    if (deviceChanged) {
+        std::cout << "device: vendorID 0x" << std::hex << hv1Before->vendorID << " -> 0x" << hv1After->vendorID << ", deviceID 0x"
+                  << hv1Before->deviceID << " -> 0x" << hv1After->deviceID << std::dec << ", pipelineCacheUUID "
+                  << hv1Before->pipelineCacheUUID << " -> " << hv1After->pipelineCacheUUID << std::endl;
+    }
+
+    PayloadHashes hashesBefore(pcrBefore, filenames[0]);
+    PayloadHashes hashesAfter(pcrAfter, filenames[1]);
+    std::vector<VkPipelineCacheSafetyCriticalIndexEntry const *> removed;
+    std::vector<VkPipelineCacheSafetyCriticalIndexEntry const *> added;
+    std::vector<PipelineChange> changed;
+    uint32_t unchangedCount = 0;
+
+    // duplicate identifiers within a cache are ignored, like the index does, only their first occurrence is compared
+    for (VkPipelineCacheSafetyCriticalIndexEntry const &pie : pcrBefore.pipelines()) {
+        if (indexBefore.getPipelineIndexEntry(pie.pipelineIdentifier) != &pie) continue;
+
+        VkPipelineCacheSafetyCriticalIndexEntry const *other = indexAfter.getPipelineIndexEntry(pie.pipelineIdentifier);
+        if (other == nullptr) {
+            removed.push_back(&pie);
+            continue;
+        }
+
+        PipelineChange const result = comparePipeline(hashesBefore, pie, hashesAfter, *other);
+        if (isChanged(result)) {
+            changed.push_back(result);
+        } else {
+            ++unchangedCount;
+        }
+    }
+    for (VkPipelineCacheSafetyCriticalIndexEntry const &pie : pcrAfter.pipelines()) {
+        if (indexAfter.getPipelineIndexEntry(pie.pipelineIdentifier) == &pie &&
+            indexBefore.getPipelineIndexEntry(pie.pipelineIdentifier) == nullptr) {
+            added.push_back(&pie);
+        }
+    }
+
+    // largest contributors to pool growth first
+    auto const bySizeDescending = [](VkPipelineCacheSafetyCriticalIndexEntry const *a,
+                                     VkPipelineCacheSafetyCriticalIndexEntry const *b) {
+        return a->pipelineMemorySize > b->pipelineMemorySize;
+    };
+    std::stable_sort(added.begin(), added.end(), bySizeDescending);
+    std::stable_sort(removed.begin(), removed.end(), bySizeDescending);
+    std::stable_sort(changed.begin(), changed.end(), [](PipelineChange const &a, PipelineChange const &b) {
+        int64_t const growthA = static_cast<int64_t>(a.after->pipelineMemorySize - a.before->pipelineMemorySize);
+        int64_t const growthB = static_cast<int64_t>(b.after->pipelineMemorySize - b.before->pipelineMemorySize);
+        return growthA > growthB;
+    });
+
+    if (!added.empty()) {
+        std::cout << std::endl << "added pipelines:" << std::endl;
+        for (VkPipelineCacheSafetyCriticalIndexEntry const *pie : added) {
+            std::cout << "    " << pie->pipelineIdentifier << " pipelineMemorySize: " << pie->pipelineMemorySize
+                      << ", json: " << pcrAfter.getJsonSize(*pie) << ", stages: " << pie->stageIndexCount
+                      << ", code: " << getCodeSize(pcrAfter, *pie) << std::endl;
+        }
+    }
+    if (!removed.empty()) {
+        std::cout << std::endl << "removed pipelines:" << std::endl;
+        for (VkPipelineCacheSafetyCriticalIndexEntry const *pie : removed) {
+            std::cout << "    " << pie->pipelineIdentifier << " pipelineMemorySize: " << pie->pipelineMemorySize
+                      << ", json: " << pcrBefore.getJsonSize(*pie) << ", stages: " << pie->stageIndexCount
+                      << ", code: " << getCodeSize(pcrBefore, *pie) << std::endl;
+        }
+    }
+    if (!changed.empty()) {
+        std::cout << std::endl << "changed pipelines:" << std::endl;
+        for (PipelineChange const &result : changed) {
+            std::cout << "    " << result.before->pipelineIdentifier
+                      << " pipelineMemorySize: " << change(result.before->pipelineMemorySize, result.after->pipelineMemorySize)
+                      << ", json: " << change(result.jsonSizeBefore, result.jsonSizeAfter)
+                      << (result.jsonChanged ? " (changed)" : "")
+                      << ", stages: " << change(result.before->stageIndexCount, result.after->stageIndexCount)
+                      << ", code: " << change(result.codeSizeBefore, result.codeSizeAfter);
+            if (result.changedStageCount > 0) {
+                std::cout << " (" << result.changedStageCount << " stages changed)";
+            }
+            std::cout << std::endl;
+        }
+    }
+
+    CacheTotals const totalsBefore = getTotals(pcrBefore);
+    CacheTotals const totalsAfter = getTotals(pcrAfter);
+    std::cout << std::endl
+              << "summary: " << added.size() << " added, " << removed.size() << " removed, " << changed.size() << " changed, "
+              << unchangedCount << " unchanged" << std::endl;
+    std::cout << "pipelineMemorySize total: " << change(totalsBefore.memorySize, totalsAfter.memorySize)
+              << ", max: " << change(totalsBefore.maxMemorySize, totalsAfter.maxMemorySize) << std::endl;
+    std::cout << "json total: " << change(totalsBefore.jsonSize, totalsAfter.jsonSize)
+              << ", code total: " << change(totalsBefore.codeSize, totalsAfter.codeSize) << std::endl;
+
+    if (!poolSizes.empty()) {
+        std::vector<uint64_t> const countsBefore = bucketPipelines(pcrBefore, poolSizes);
+        std::vector<uint64_t> const countsAfter = bucketPipelines(pcrAfter, poolSizes);
+        for (size_t p = 0; p < poolSizes.size(); ++p) {
+            std::cout << "pool size: " << poolSizes[p] << ", pool entries: " << change(countsBefore[p], countsAfter[p])
+                      << ", pool allocated space: " << change(poolSizes[p] * countsBefore[p], poolSizes[p] * countsAfter[p])
+                      << std::endl;
+        }
+        std::cout << "pipelines not fitting in any pool: " << change(countsBefore.back(), countsAfter.back()) << std::endl;
+    }
+
+    bool const same = !deviceChanged && added.empty() && removed.empty() && changed.empty();
+    return same ? kExitSame : kExitDifferent;
+}
@@ -9,14 +9,21 @@
 #include <cstddef>
 #include <iostream>
 #include <iomanip>
-#include <fstream>
 #include <cstring>
 #include <vector>
 #include <algorithm>
+#include <atomic>
+#include <charconv>
+#include <filesystem>
+#include <system_error>
+#include <thread>
 #include <limits>
 #include <cctype>
 #include <string>
+#include <unordered_map>
+#include <utility>
 
+#include <vulkan/pcutil/pcfile.hpp>
 #include <vulkan/pcutil/pcreader.hpp>
 #include <vulkan/vulkan_sc.h>
 
@@ -30,6 +37,12 @@ typedef enum DetailMode {
     DETAIL_MODE_ALL,
 } DetailMode;
 
+typedef enum OutputFormat {
+    OUTPUT_FORMAT_TEXT = 0,
+    OUTPUT_FORMAT_JSON,
+    OUTPUT_FORMAT_CSV,
+} OutputFormat;
+
 std::ostream &operator<<(std::ostream &out, uint8_t i) {
     out << static_cast<unsigned int>(i);
     return out;
@@ -106,38 +119,429 @@ std::ostream &operator<<(std::ostream &out, PipelinePool const &pool) {
 }
 
 // <pools> must be sorted in increasing order by poolSize
-bool bucketPipelines(VKSCPipelineCacheHeaderReader &pcr, std::vector<PipelinePool> &pools) {
+// if <unfitCount> is not null the pipelines that do not fit in any pool are counted there instead of being reported
+bool bucketPipelines(VKSCPipelineCacheHeaderReader &pcr, std::vector<PipelinePool> &pools, uint32_t *unfitCount = nullptr) {
     bool allAdded = true;
 
+    VKSCPipelineIndexRange const pipelines = pcr.pipelines();
+    assert(pipelines.size() == pcr.getPipelineIndexCount());
+
     // iterate through the pipelines and add to the smallest pool that they fit
-    for (uint32_t i = 0; i < pcr.getPipelineIndexCount(); i++) {
-        VkPipelineCacheSafetyCriticalIndexEntry const *pie = pcr.getPipelineIndexEntry(i);
-        assert(pie != nullptr);
+    uint32_t i = 0;
+    for (VkPipelineCacheSafetyCriticalIndexEntry const &pie : pipelines) {
         bool addedToPool = false;
 
         for (PipelinePool &pool : pools) {
-            if (pie->pipelineMemorySize <= pool.poolSize) {
+            if (pie.pipelineMemorySize <= pool.poolSize) {
                 // cout << "adding index " << i << " to pool " << pool.poolSize << endl;
                 pool.poolEntries.push_back(i);
-                pool.poolMin = std::min(pool.poolMin, pie->pipelineMemorySize);
-                pool.poolMax = std::max(pool.poolMax, pie->pipelineMemorySize);
-                pool.poolTotal += pie->pipelineMemorySize;
+                pool.poolMin = std::min(pool.poolMin, pie.pipelineMemorySize);
+                pool.poolMax = std::max(pool.poolMax, pie.pipelineMemorySize);
+                pool.poolTotal += pie.pipelineMemorySize;
                 addedToPool = true;
                 break;
             }
         }
-        if (!addedToPool) {
+        if (!addedToPool && unfitCount != nullptr) {
+            ++*unfitCount;
+            allAdded = false;
+        } else if (!addedToPool) {
             // pipeline didn't fit in any pool
-            cerr << "WARNING: index " << i << " id: " << pie->pipelineIdentifier
-                 << " pipelineMemorySize: " << pie->pipelineMemorySize << " did not fit in any pool!" << std::endl;
+            cerr << "WARNING: index " << i << " id: " << pie.pipelineIdentifier << " pipelineMemorySize: " << pie.pipelineMemorySize
+                 << " did not fit in any pool!" << std::endl;
             allAdded = false;
         }
+        i++;
     }
 
     return allAdded;
 }
 
-bool printCacheInfo(VKSCPipelineCacheHeaderReader &pcr, DetailMode details) {
+// pipeline pool sizing problem, the pipelines sorted by pipelineMemorySize are partitioned into contiguous groups,
+// each group is served by a pool whose entry size is the largest pipelineMemorySize in the group
+class PipelinePoolSolver {
+  public:
+    // <maxPoolEntryCount> limits the number of entries of a single pool, 0 means no limit
+    PipelinePoolSolver(std::vector<uint64_t> sizes, uint64_t maxPoolEntryCount)
+        : m_Sizes(std::move(sizes)), m_MaxPoolEntryCount(maxPoolEntryCount) {
+        std::sort(m_Sizes.begin(), m_Sizes.end());
+        if (m_MaxPoolEntryCount >= m_Sizes.size()) {
+            m_MaxPoolEntryCount = 0;
+        }
+
+        // without a count limit groups never need to split pipelines of equal size, so only consider the ends of the runs
+        // of equal sizes as group boundaries
+        for (uint32_t i = 1; i <= m_Sizes.size(); ++i) {
+            if (m_MaxPoolEntryCount > 0 || i == m_Sizes.size() || m_Sizes[i] != m_Sizes[i - 1]) {
+                m_Ends.push_back(i);
+            }
+        }
+    }
+
+    // compute the pool sizes minimizing the total reserved memory using at most <maxPoolCount> pools
+    // return: false if the pipelines cannot be covered with the given limits
+    bool solve(uint32_t maxPoolCount, std::vector<VkPipelinePoolSize> &poolSizes) {
+        poolSizes.clear();
+        if (m_Ends.empty()) return true;
+
+        uint32_t const endCount = static_cast<uint32_t>(m_Ends.size());
+        uint32_t const rowCount = std::min(maxPoolCount, endCount);
+        m_Cost.assign(uint64_t{rowCount} * endCount, kInfinite);
+        m_Split.assign(uint64_t{rowCount} * endCount, 0U);
+
+        // dynamic programming over the number of pools, row <k> holds the cost of covering the first m_Ends[c] pipelines
+        // with exactly k + 1 pools
+        for (uint32_t c = 0; c < endCount; ++c) {
+            m_Cost[c] = groupCost(0, m_Ends[c]);
+        }
+        for (uint32_t k = 1; k < rowCount; ++k) {
+            if (m_MaxPoolEntryCount > 0) {
+                solveRowLimited(k);
+            } else {
+                solveRow(k, k, endCount - 1, k - 1, endCount - 2);
+            }
+        }
+
+        uint32_t bestRow = 0;
+        for (uint32_t k = 1; k < rowCount; ++k) {
+            if (cost(k, endCount - 1) < cost(bestRow, endCount - 1)) {
+                bestRow = k;
+            }
+        }
+        if (cost(bestRow, endCount - 1) == kInfinite) return false;
+
+        // walk back the split points, emitting the pools from the largest to the smallest
+        uint32_t c = endCount - 1;
+        for (uint32_t k = bestRow + 1; k-- > 0;) {
+            uint32_t const begin = (k > 0) ? m_Ends[split(k, c)] : 0U;
+            VkPipelinePoolSize poolSize{VK_STRUCTURE_TYPE_PIPELINE_POOL_SIZE};
+            poolSize.poolEntrySize = m_Sizes[m_Ends[c] - 1];
+            poolSize.poolEntryCount = m_Ends[c] - begin;
+            poolSizes.push_back(poolSize);
+            c = (k > 0) ? split(k, c) : 0U;
+        }
+        std::reverse(poolSizes.begin(), poolSizes.end());
+        return true;
+    }
+
+  private:
+    static constexpr uint64_t kInfinite = std::numeric_limits<uint64_t>::max();
+
+    uint64_t &cost(uint32_t k, uint32_t c) { return m_Cost[uint64_t{k} * m_Ends.size() + c]; }
+    uint32_t &split(uint32_t k, uint32_t c) { return m_Split[uint64_t{k} * m_Ends.size() + c]; }
+
+    // reserved memory of a single pool holding the pipelines [begin, end)
+    uint64_t groupCost(uint32_t begin, uint32_t end) const {
+        if (m_MaxPoolEntryCount > 0 && end - begin > m_MaxPoolEntryCount) return kInfinite;
+        return m_Sizes[end - 1] * (end - begin);
+    }
+
+    // fill cost(k, c) for c in [lo, hi] knowing that the optimal split points lie in [splitLo, splitHi]
+    // without a count limit the optimal split points are monotone in c, so the row is filled by divide and conquer
+    void solveRow(uint32_t k, uint32_t lo, uint32_t hi, uint32_t splitLo, uint32_t splitHi) {
+        if (lo > hi) return;
+
+        uint32_t const mid = lo + (hi - lo) / 2;
+        uint64_t best = kInfinite;
+        uint32_t bestSplit = std::max(splitLo, k - 1);
+        for (uint32_t s = bestSplit; s <= std::min(mid - 1, splitHi); ++s) {
+            uint64_t const previous = cost(k - 1, s);
+            uint64_t const group = groupCost(m_Ends[s], m_Ends[mid]);
+            if (previous == kInfinite || group == kInfinite) continue;
+            if (previous + group < best) {
+                best = previous + group;
+                bestSplit = s;
+            }
+        }
+        cost(k, mid) = best;
+        split(k, mid) = bestSplit;
+
+        if (mid > lo) solveRow(k, lo, mid - 1, splitLo, bestSplit);
+        solveRow(k, mid + 1, hi, bestSplit, splitHi);
+    }
+
+    // fill row <k> when the pool entry count is limited, only the last m_MaxPoolEntryCount split points are feasible
+    // for each group end, which breaks the monotonicity of the optimal split points, so they are scanned directly
+    // a group ending inside a run of equal sizes can take the next pipeline of the run without increasing the total
+    // unless it is full, so such groups only need to be considered with exactly m_MaxPoolEntryCount entries
+    void solveRowLimited(uint32_t k) {
+        uint32_t const endCount = static_cast<uint32_t>(m_Ends.size());
+        uint32_t first = k - 1;
+        for (uint32_t c = k; c < endCount; ++c) {
+            while (m_Ends[c] - m_Ends[first] > m_MaxPoolEntryCount) {
+                ++first;
+            }
+            if (m_Ends[c] < m_Sizes.size() && m_Sizes[m_Ends[c]] == m_Sizes[m_Ends[c] - 1]) {
+                // in limited mode m_Ends holds every index, so the full group starts right after entry c - count
+                uint32_t const s = c - static_cast<uint32_t>(m_MaxPoolEntryCount);
+                bool const feasible = c >= m_MaxPoolEntryCount && s >= k - 1 && cost(k - 1, s) != kInfinite;
+                cost(k, c) = feasible ? cost(k - 1, s) + groupCost(m_Ends[s], m_Ends[c]) : kInfinite;
+                split(k, c) = feasible ? s : first;
+                continue;
+            }
+
+            uint64_t best = kInfinite;
+            uint32_t bestSplit = first;
+            for (uint32_t s = first; s < c; ++s) {
+                uint64_t const previous = cost(k - 1, s);
+                if (previous == kInfinite) continue;
+                uint64_t const total = previous + groupCost(m_Ends[s], m_Ends[c]);
+                if (total < best) {
+                    best = total;
+                    bestSplit = s;
+                }
+            }
+            cost(k, c) = best;
+            split(k, c) = bestSplit;
+        }
+    }
+
+    std::vector<uint64_t> m_Sizes;  // pipeline memory sizes in increasing order
+    uint64_t m_MaxPoolEntryCount;   // maximum number of entries of a single pool, 0 if unlimited
+    std::vector<uint32_t> m_Ends;   // candidate group ends, as exclusive indices into m_Sizes
+    std::vector<uint64_t> m_Cost;   // minimal reserved memory per pool count and group end
+    std::vector<uint32_t> m_Split;  // index into m_Ends of the end of the previous group for each entry of m_Cost
+};
+
+std::vector<uint64_t> getPipelineMemorySizes(VKSCPipelineCacheHeaderReader &pcr) {
+    std::vector<uint64_t> sizes;
+    sizes.reserve(pcr.getPipelineIndexCount());
+    for (VkPipelineCacheSafetyCriticalIndexEntry const &pie : pcr.pipelines()) {
+        sizes.push_back(pie.pipelineMemorySize);
+    }
+    return sizes;
+}
+
+bool solvePipelinePools(VKSCPipelineCacheHeaderReader &pcr, uint32_t maxPoolCount, uint64_t maxPoolEntryCount) {
+    std::vector<uint64_t> sizes = getPipelineMemorySizes(pcr);
+    uint64_t usedTotal = 0;
+    uint64_t maxSize = 0;
+    for (uint64_t size : sizes) {
+        usedTotal += size;
+        maxSize = std::max(maxSize, size);
+    }
+
+    cout << "solving pipeline pool sizes for at most " << maxPoolCount << " pools";
+    if (maxPoolEntryCount > 0) {
+        cout << " of at most " << maxPoolEntryCount << " entries";
+    }
+    cout << endl;
+
+    PipelinePoolSolver solver(std::move(sizes), maxPoolEntryCount);
+    std::vector<VkPipelinePoolSize> poolSizes;
+    if (!solver.solve(maxPoolCount, poolSizes)) {
+        cerr << "WARNING: " << pcr.getPipelineIndexCount() << " pipelines do not fit in " << maxPoolCount << " pools of at most "
+             << maxPoolEntryCount << " entries!" << endl;
+        return false;
+    }
+
+    uint64_t reservedTotal = 0;
+    for (VkPipelinePoolSize const &poolSize : poolSizes) {
+        cout << "    pool size: " << poolSize.poolEntrySize << ", pool entries: " << poolSize.poolEntryCount << endl;
+        reservedTotal += poolSize.poolEntrySize * poolSize.poolEntryCount;
+    }
+    cout << "reserved space: " << reservedTotal << ", used space: " << usedTotal
+         << ", wasted space: " << (reservedTotal - usedTotal) << endl;
+    cout << "single pool reserved space: " << (maxSize * pcr.getPipelineIndexCount()) << endl;
+
+    cout << endl << "VkPipelinePoolSize pipelinePoolSizes[" << poolSizes.size() << "] = {" << endl;
+    for (VkPipelinePoolSize const &poolSize : poolSizes) {
+        cout << "    {VK_STRUCTURE_TYPE_PIPELINE_POOL_SIZE, nullptr, " << poolSize.poolEntrySize << ", " << poolSize.poolEntryCount
+             << "}," << endl;
+    }
+    cout << "};" << endl;
+
+    return true;
+}
+
+// text buffer for the structured output formats and the SPIR-V dump, the output is assembled in memory and written in
+// large chunks instead of formatting each field through the stream
+class OutputBuffer {
+  public:
+    OutputBuffer &operator<<(char const *text) {
+        m_Text.append(text);
+        return *this;
+    }
+
+    OutputBuffer &operator<<(std::string const &text) {
+        m_Text.append(text);
+        return *this;
+    }
+
+    OutputBuffer &operator<<(uint64_t value) {
+        char digits[24];
+        char *end = std::to_chars(digits, digits + sizeof(digits), value).ptr;
+        m_Text.append(digits, end);
+        return *this;
+    }
+
+    OutputBuffer &operator<<(uint32_t value) { return *this << uint64_t{value}; }
+
+    // append <uuid> as hexadecimal, in the same format as the text output
+    void appendUuid(uint8_t const uuid[VK_UUID_SIZE]) {
+        static char const kHexDigits[] = "0123456789ABCDEF";
+        char hex[2 + 2 * VK_UUID_SIZE] = {'0', 'x'};
+        for (uint32_t i = 0; i < VK_UUID_SIZE; ++i) {
+            hex[2 + 2 * i] = kHexDigits[uuid[i] >> 4U];
+            hex[3 + 2 * i] = kHexDigits[uuid[i] & 0xFU];
+        }
+        m_Text.append(hex, sizeof(hex));
+    }
+
+    // append <text> as a quoted JSON string
+    void appendJsonString(char const *text) {
+        m_Text.push_back('"');
+        for (char const *c = text; *c != '\0'; ++c) {
+            if (*c == '"' || *c == '\\') {
+                m_Text.push_back('\\');
+                m_Text.push_back(*c);
+            } else if (static_cast<unsigned char>(*c) < 0x20U) {
+                static char const kHexDigits[] = "0123456789abcdef";
+                char escape[] = {'\\', 'u', '0', '0', kHexDigits[(*c >> 4) & 0xF], kHexDigits[*c & 0xF]};
+                m_Text.append(escape, sizeof(escape));
+            } else {
+                m_Text.push_back(*c);
+            }
+        }
+        m_Text.push_back('"');
+    }
+
+    // append <text> as a CSV field, quoting it if necessary
+    void appendCsvField(char const *text) {
+        if (strpbrk(text, ",\"\r\n") == nullptr) {
+            m_Text.append(text);
+            return;
+        }
+        m_Text.push_back('"');
+        for (char const *c = text; *c != '\0'; ++c) {
+            if (*c == '"') m_Text.push_back('"');
+            m_Text.push_back(*c);
+        }
+        m_Text.push_back('"');
+    }
+
+    // append <size> bytes of SPIR-V code at <code> as comma separated hexadecimal words, 8 words per line
+    // the layout matches the text output of previous versions, any trailing partial word is ignored
+    void appendSpirvWords(uint8_t const *code, uint64_t size, char const *indent) {
+        uint64_t const wordCount = size / sizeof(uint32_t);
+        reserveAppend(wordCount * 11U + (wordCount / 8U + 1U) * (strlen(indent) + 1U));
+        for (uint64_t k = 0; k < wordCount; ++k) {
+            appendHexWord(readWord(code, k));
+            m_Text.push_back(',');
+            if ((k % 8) == 7) {
+                m_Text.push_back('\n');
+                m_Text.append(indent);
+            }
+        }
+        m_Text.push_back('\n');
+    }
+
+    // append <size> bytes of SPIR-V code at <code> as a listing of its header and instructions, one per line
+    // every instruction is written as Op<opcode> followed by its operand words
+    void appendSpirvInstructions(uint8_t const *code, uint64_t size, char const *indent) {
+        uint64_t const wordCount = size / sizeof(uint32_t);
+        if (wordCount < 5U) {
+            m_Text.append("truncated module\n");
+            return;
+        }
+
+        char const *const fields[] = {"magic ", ", version ", ", generator ", ", bound ", ", schema "};
+        for (uint64_t k = 0; k < 5U; ++k) {
+            m_Text.append(fields[k]);
+            if (k < 3U) {
+                appendHexWord(readWord(code, k));
+            } else {
+                *this << readWord(code, k);
+            }
+        }
+        m_Text.push_back('\n');
+
+        for (uint64_t k = 5U; k < wordCount;) {
+            uint32_t const instruction = readWord(code, k);
+            uint32_t const instructionWordCount = instruction >> 16U;
+            m_Text.append(indent);
+            if (instructionWordCount == 0U || instructionWordCount > wordCount - k) {
+                // not a valid instruction, dump the rest of the module as is
+                m_Text.append("malformed instruction:");
+                for (; k < wordCount; ++k) {
+                    m_Text.push_back(' ');
+                    appendHexWord(readWord(code, k));
+                }
+                m_Text.push_back('\n');
+                break;
+            }
+
+            m_Text.append("Op");
+            *this << (instruction & 0xFFFFU);
+            for (uint32_t w = 1U; w < instructionWordCount; ++w) {
+                m_Text.push_back(' ');
+                appendHexWord(readWord(code, k + w));
+            }
+            m_Text.push_back('\n');
+            k += instructionWordCount;
+        }
+    }
+
+    // return: the number of bytes currently buffered
+    uint64_t size() const { return m_Text.size(); }
+
+    // return: true if the contents were written to <out> successfully
+    // the buffer is emptied so it can be reused, <flush> also flushes <out>
+    bool write(std::ostream &out, bool flush = true) {
+        out.write(m_Text.data(), static_cast<std::streamsize>(m_Text.size()));
+        m_Text.clear();
+        if (flush) {
+            out.flush();
+        }
+        return out.good();
+    }
+
+  private:
+    // SPIR-V code in a pipeline cache is not necessarily 4-byte aligned
+    static uint32_t readWord(uint8_t const *code, uint64_t index) {
+        uint32_t word;
+        memcpy(&word, code + index * sizeof(uint32_t), sizeof(word));
+        return word;
+    }
+
+    // append <word> as 0x followed by 8 uppercase hexadecimal digits, two digits per table lookup
+    void appendHexWord(uint32_t word) {
+        static HexTable const kHexTable;
+        char hex[10] = {'0', 'x'};
+        for (uint32_t i = 0; i < 4; ++i) {
+            uint8_t const byte = static_cast<uint8_t>(word >> (24U - 8U * i));
+            hex[2 + 2 * i] = kHexTable.digits[byte][0];
+            hex[3 + 2 * i] = kHexTable.digits[byte][1];
+        }
+        m_Text.append(hex, sizeof(hex));
+    }
+
+    void reserveAppend(uint64_t size) { m_Text.reserve(m_Text.size() + static_cast<size_t>(size)); }
+
+    struct HexTable {
+        HexTable() {
+            static char const kHexDigits[] = "0123456789ABCDEF";
+            for (uint32_t i = 0; i < 256; ++i) {
+                digits[i][0] = kHexDigits[i >> 4U];
+                digits[i][1] = kHexDigits[i & 0xFU];
+            }
+        }
+        char digits[256][2];
+    };
+
+    std::string m_Text;
+};
+
+// write out what was listed so far, report the compressed <kind> payload of pipeline <index> as malformed, and exit
+[[noreturn]] void malformedPayload(OutputBuffer &dump, char const *kind, uint32_t index) {
+    dump.write(std::cout);
+    std::cout << "pie " << index << ": compressed " << kind << " cannot be decompressed" << std::endl;
+    std::cout << "malformed pipeline cache!" << std::endl;
+    exit(EXIT_FAILURE);
+}
+
+// <disassemble> lists the SPIR-V code of DETAIL_MODE_ALL as instructions instead of words
+bool printCacheInfo(VKSCPipelineCacheHeaderReader &pcr, DetailMode details, bool disassemble = false) {
     VkPipelineCacheHeaderVersionOne const *hv1 = pcr.getHeaderVersionOne();
 
     uint64_t minPoolSize = std::numeric_limits<uint64_t>::max();
@@ -158,56 +562,91 @@ bool printCacheInfo(VKSCPipelineCacheHeaderReader &pcr, DetailMode details) {
                   << std::endl;
     }
 
+    VKSCPipelineIndexRange const pipelines = pcr.pipelines();
+
+    // the detailed listing is formatted into a buffer that is written out in large chunks
+    OutputBuffer dump;
+    uint64_t const kDumpChunkSize = 1U << 20U;
+
     // iterate over each pipeline and print the UUID
-    for (uint32_t i = 0; i < pcr.getPipelineIndexCount(); i++) {
-        VkPipelineCacheSafetyCriticalIndexEntry const *pie = pcr.getPipelineIndexEntry(i);
-        if (nullptr != pie) {
-            if (details >= DETAIL_MODE_ALL_HEADERS) {
-                std::cout << "pipeline " << i << ":" << std::endl
-                          << "  pipelineIdentifier: " << pie->pipelineIdentifier << std::endl
-                          << "  pipelineMemorySize: " << pie->pipelineMemorySize << std::endl
-                          << "  jsonSize:           " << pie->jsonSize << std::endl
-                          << "  jsonOffset:         " << pie->jsonOffset << std::endl
-                          << "  stageIndexCount:    " << pie->stageIndexCount << std::endl
-                          << "  stageIndexStride:   " << pie->stageIndexStride << std::endl
-                          << "  stageIndexOffset:   " << pie->stageIndexOffset << std::endl;
-                for (uint32_t j = 0; j < pie->stageIndexCount; j++) {
-                    VkPipelineCacheStageValidationIndexEntry const *vie = pcr.getStageIndexEntry(*pie, j);
-                    if (nullptr != vie) {
-                        std::cout << "  stage " << j << ":" << std::endl
-                                  << "    codeSize:         " << vie->codeSize << std::endl
-                                  << "    codeOffset:       " << vie->codeOffset << std::endl;
-                        if (details >= DETAIL_MODE_ALL) {
-                            uint32_t const *spirv = reinterpret_cast<uint32_t const *>(pcr.getSPIRV(*vie));
-                            std::cout << "    spirv:            ";
-                            for (uint32_t k = 0; k < vie->codeSize / 4; k++) {
-                                std::cout << "0x" << std::setw(8) << std::setbase(16) << spirv[k] << ",";
-                                if ((k % 8) == 7) {
-                                    std::cout << std::endl << "                      ";
-                                }
-                            }
-                            std::cout << std::setbase(10) << std::endl;
+    uint32_t i = 0;
+    for (VkPipelineCacheSafetyCriticalIndexEntry const &pie : pipelines) {
+        if (details >= DETAIL_MODE_ALL_HEADERS) {
+            dump << "pipeline " << i << ":\n  pipelineIdentifier: ";
+            dump.appendUuid(pie.pipelineIdentifier);
+            dump << "\n  pipelineMemorySize: " << pie.pipelineMemorySize << "\n  jsonSize:           " << pie.jsonSize
+                 << "\n  jsonOffset:         " << pie.jsonOffset << "\n  stageIndexCount:    " << pie.stageIndexCount
+                 << "\n  stageIndexStride:   " << pie.stageIndexStride << "\n  stageIndexOffset:   " << pie.stageIndexOffset
+                 << "\n";
+            uint32_t j = 0;
+            for (VkPipelineCacheStageValidationIndexEntry const &vie : pcr.stages(pie)) {
+                dump << "  stage " << j << ":\n    codeSize:         " << vie.codeSize
+                     << "\n    codeOffset:       " << vie.codeOffset << "\n";
+                // compressed code is listed decompressed
+                bool const compressed = pcr.isSPIRVCompressed(vie);
+                uint64_t const codeSize = compressed ? pcr.getSPIRVSize(vie) : vie.codeSize;
+                if (compressed) {
+                    dump << "    compressed from:  " << codeSize << "\n";
+                }
+                if (details >= DETAIL_MODE_ALL) {
+                    uint8_t const *code = pcr.getSPIRV(vie);
+                    std::vector<uint8_t> decompressed;
+                    if (compressed) {
+                        // the size in the frame header is not trusted for allocating, the buffer grows with the
+                        // decompressed data, and decompression fails if it does not match the size in the header
+                        bool const read = pcr.readSPIRV(vie, [&decompressed](uint8_t const *data, uint64_t size) {
+                            decompressed.insert(decompressed.end(), data, data + size);
+                            return true;
+                        });
+                        if (!read) {
+                            malformedPayload(dump, "spirv", i);
                         }
+                        code = decompressed.data();
+                    }
+                    dump << "    spirv:            ";
+                    if (disassemble) {
+                        dump.appendSpirvInstructions(code, codeSize, "                      ");
+                    } else {
+                        dump.appendSpirvWords(code, codeSize, "                      ");
                     }
                 }
-                if (details >= DETAIL_MODE_ALL) {
-                    std::string const json =
-                        std::string(reinterpret_cast<char const *>(pcr.getJson(*pie)), static_cast<size_t>(pie->jsonSize));
-                    std::cout << "  json:" << std::endl << json << std::endl;
+                j++;
+            }
+            if (details >= DETAIL_MODE_ALL) {
+                std::string json;
+                if (pcr.isJsonCompressed(pie)) {
+                    bool const read = pcr.readJson(pie, [&json](uint8_t const *data, uint64_t size) {
+                        json.append(reinterpret_cast<char const *>(data), static_cast<size_t>(size));
+                        return true;
+                    });
+                    if (!read) {
+                        malformedPayload(dump, "json", i);
+                    }
+                } else {
+                    json = std::string(reinterpret_cast<char const *>(pcr.getJson(pie)), static_cast<size_t>(pie.jsonSize));
                 }
-                std::cout << std::endl;
-            } else if (details == DETAIL_MODE_BASIC) {
-                std::cout << "index: " << std::setw(3) << i << " id: " << pie->pipelineIdentifier
-                          << " pipelineMemorySize: " << pie->pipelineMemorySize << std::endl;
-            }
-            minPoolSize = std::min(minPoolSize, pie->pipelineMemorySize);
-            maxPoolSize = std::max(maxPoolSize, pie->pipelineMemorySize);
-            // std::cout << "pie " << i << ": " << *pie << std::endl;
-        } else {
-            std::cout << "pie " << i << ": not found" << std::endl;
-            std::cout << "malformed pipeline cache!" << std::endl;
-            exit(EXIT_FAILURE);
+                dump << "  json:\n" << json << "\n";
+            }
+            dump << "\n";
+            if (dump.size() >= kDumpChunkSize) {
+                dump.write(std::cout, false);
+            }
+        } else if (details == DETAIL_MODE_BASIC) {
+            std::cout << "index: " << std::setw(3) << i << " id: " << pie.pipelineIdentifier
+                      << " pipelineMemorySize: " << pie.pipelineMemorySize << std::endl;
         }
+        minPoolSize = std::min(minPoolSize, pie.pipelineMemorySize);
+        maxPoolSize = std::max(maxPoolSize, pie.pipelineMemorySize);
+        // std::cout << "pie " << i << ": " << pie << std::endl;
+        i++;
+    }
+
+    dump.write(std::cout);
+
+    if (pipelines.size() != pcr.getPipelineIndexCount()) {
+        std::cout << "pie " << pipelines.size() << ": not found" << std::endl;
+        std::cout << "malformed pipeline cache!" << std::endl;
+        exit(EXIT_FAILURE);
     }
 
     cout << "found " << pcr.getPipelineIndexCount() << " pipelines, sizes [" << minPoolSize << ", " << maxPoolSize << "]" << endl;
@@ -215,26 +654,627 @@ bool printCacheInfo(VKSCPipelineCacheHeaderReader &pcr, DetailMode details) {
     return true;
 }
 
+// per-pipeline payload sizes used by the structured output
+struct PipelineSummary {
+    uint64_t codeSize{};
+    uint64_t poolSize{};
+};
+
+// write the cache header, per-pipeline sizes and pool statistics of <pcr> in the given structured <format>
+// <pools> are the buckets requested with -pool after bucketPipelines, <unfitCount> the pipelines that did not fit in any of them,
+// <solvedPools> the result of -solve (may be null)
+bool writeStructuredCacheInfo(VKSCPipelineCacheHeaderReader &pcr, char const *filename, uint64_t fileSize, OutputFormat format,
+                              std::vector<PipelinePool> const &pools, uint32_t unfitCount,
+                              std::vector<VkPipelinePoolSize> const *solvedPools) {
+    VKSCPipelineIndexRange const pipelines = pcr.pipelines();
+    if (pipelines.size() != pcr.getPipelineIndexCount()) {
+        std::cerr << "malformed pipeline cache!" << std::endl;
+        return false;
+    }
+
+    std::vector<PipelineSummary> summaries(pipelines.size());
+    for (PipelinePool const &pool : pools) {
+        for (uint32_t index : pool.poolEntries) {
+            summaries[index].poolSize = pool.poolSize;
+        }
+    }
+
+    uint64_t minMemorySize = std::numeric_limits<uint64_t>::max();
+    uint64_t maxMemorySize = 0;
+    uint64_t totalMemorySize = 0;
+    uint64_t totalJsonSize = 0;
+    uint64_t totalCodeSize = 0;
+    uint64_t totalStageCount = 0;
+    uint32_t i = 0;
+    for (VkPipelineCacheSafetyCriticalIndexEntry const &pie : pipelines) {
+        for (VkPipelineCacheStageValidationIndexEntry const &vie : pcr.stages(pie)) {
+            summaries[i].codeSize += vie.codeSize;
+        }
+        minMemorySize = std::min(minMemorySize, pie.pipelineMemorySize);
+        maxMemorySize = std::max(maxMemorySize, pie.pipelineMemorySize);
+        totalMemorySize += pie.pipelineMemorySize;
+        totalJsonSize += pie.jsonSize;
+        totalCodeSize += summaries[i].codeSize;
+        totalStageCount += pie.stageIndexCount;
+        i++;
+    }
+    if (pipelines.empty()) {
+        minMemorySize = 0;
+    }
+
+    VkPipelineCacheHeaderVersionOne const *hv1 = pcr.getHeaderVersionOne();
+    OutputBuffer out;
+
+    if (format == OUTPUT_FORMAT_CSV) {
+        out << "file,pipelineCacheUUID,index,pipelineIdentifier,pipelineMemorySize,jsonSize,stageIndexCount,codeSize,poolSize\n";
+        i = 0;
+        for (VkPipelineCacheSafetyCriticalIndexEntry const &pie : pipelines) {
+            out.appendCsvField(filename);
+            out << ",";
+            out.appendUuid(hv1->pipelineCacheUUID);
+            out << "," << i << ",";
+            out.appendUuid(pie.pipelineIdentifier);
+            out << "," << pie.pipelineMemorySize << "," << pie.jsonSize << "," << pie.stageIndexCount << ","
+                << summaries[i].codeSize << "," << summaries[i].poolSize << "\n";
+            i++;
+        }
+        return out.write(std::cout);
+    }
+
+    out << "{\n  \"file\": ";
+    out.appendJsonString(filename);
+    out << ",\n  \"fileSize\": " << fileSize;
+    out << ",\n  \"header\": {\n    \"headerSize\": " << hv1->headerSize;
+    out << ",\n    \"headerVersion\": " << static_cast<uint32_t>(hv1->headerVersion);
+    out << ",\n    \"vendorID\": " << hv1->vendorID;
+    out << ",\n    \"deviceID\": " << hv1->deviceID;
+    out << ",\n    \"pipelineCacheUUID\": \"";
+    out.appendUuid(hv1->pipelineCacheUUID);
+    out << "\",\n    \"validationVersion\": " << static_cast<uint32_t>(pcr.getValidationVersion());
+    out << ",\n    \"implementationData\": " << pcr.getImplementationData();
+    out << ",\n    \"pipelineIndexCount\": " << pcr.getPipelineIndexCount();
+    out << ",\n    \"pipelineIndexStride\": " << pcr.getPipelineIndexStride();
+    out << ",\n    \"pipelineIndexOffset\": " << pcr.getPipelineIndexOffset();
+    out << "\n  },\n  \"summary\": {\n    \"pipelineCount\": " << pcr.getPipelineIndexCount();
+    out << ",\n    \"stageCount\": " << totalStageCount;
+    out << ",\n    \"minPipelineMemorySize\": " << minMemorySize;
+    out << ",\n    \"maxPipelineMemorySize\": " << maxMemorySize;
+    out << ",\n    \"totalPipelineMemorySize\": " << totalMemorySize;
+    out << ",\n    \"totalJsonSize\": " << totalJsonSize;
+    out << ",\n    \"totalCodeSize\": " << totalCodeSize;
+    out << "\n  },\n  \"pipelines\": [";
+    i = 0;
+    for (VkPipelineCacheSafetyCriticalIndexEntry const &pie : pipelines) {
+        out << (i > 0 ? ",\n    " : "\n    ") << "{\"index\": " << i << ", \"pipelineIdentifier\": \"";
+        out.appendUuid(pie.pipelineIdentifier);
+        out << "\", \"pipelineMemorySize\": " << pie.pipelineMemorySize << ", \"jsonSize\": " << pie.jsonSize
+            << ", \"stageIndexCount\": " << pie.stageIndexCount << ", \"codeSize\": " << summaries[i].codeSize;
+        if (!pools.empty()) {
+            out << ", \"poolSize\": " << summaries[i].poolSize;
+        }
+        out << "}";
+        i++;
+    }
+    out << (pipelines.empty() ? "]" : "\n  ]");
+
+    if (!pools.empty()) {
+        out << ",\n  \"pools\": [";
+        for (size_t p = 0; p < pools.size(); ++p) {
+            PipelinePool const &pool = pools[p];
+            uint64_t const entryCount = pool.poolEntries.size();
+            out << (p > 0 ? ",\n    " : "\n    ") << "{\"poolSize\": " << pool.poolSize << ", \"poolEntryCount\": " << entryCount
+                << ", \"minSize\": " << (entryCount > 0 ? pool.poolMin : 0) << ", \"maxSize\": " << pool.poolMax
+                << ", \"allocatedSpace\": " << (pool.poolSize * entryCount)
+                << ", \"wastedSpace\": " << (pool.poolSize * entryCount - pool.poolTotal) << "}";
+        }
+        out << "\n  ]";
+        out << ",\n  \"unfitCount\": " << unfitCount;
+    }
+
+    if (solvedPools != nullptr) {
+        uint64_t reservedTotal = 0;
+        out << ",\n  \"solvedPools\": [";
+        for (size_t p = 0; p < solvedPools->size(); ++p) {
+            VkPipelinePoolSize const &poolSize = (*solvedPools)[p];
+            out << (p > 0 ? ",\n    " : "\n    ") << "{\"poolEntrySize\": " << poolSize.poolEntrySize
+                << ", \"poolEntryCount\": " << poolSize.poolEntryCount << "}";
+            reservedTotal += poolSize.poolEntrySize * poolSize.poolEntryCount;
+        }
+        out << (solvedPools->empty() ? "]" : "\n  ]");
+        out << ",\n  \"solvedReservedSpace\": " << reservedTotal;
+        out << ",\n  \"solvedWastedSpace\": " << (reservedTotal - totalMemorySize);
+    }
+
+    out << "\n}\n";
+    return out.write(std::cout);
+}
+
+// summary of a single pipeline cache file analyzed in batch mode
+struct CacheFileSummary {
+    std::string path;
+    std::string error;  // empty if the file was analyzed successfully
+    uint64_t fileSize{};
+    uint32_t pipelineCount{};
+    uint64_t stageCount{};
+    uint64_t minMemorySize{std::numeric_limits<uint64_t>::max()};
+    uint64_t maxMemorySize{};
+    uint64_t totalMemorySize{};
+    uint64_t totalJsonSize{};
+    uint64_t totalCodeSize{};
+    uint32_t unfitCount{};                    // pipelines not fitting in any of the requested pools
+    std::vector<PipelinePool> pools{};        // copy of the requested pools with the statistics of this file
+    std::vector<uint64_t> poolEntryCounts{};  // number of pipelines bucketed into each of the pools
+};
+
+// analyze the pipeline cache file <summary.path>, bucketing its pipelines into a copy of <pools>
+void analyzeCacheFile(CacheFileSummary &summary, std::vector<PipelinePool> const &pools) {
+    VKSCPipelineCacheFile file;
+    if (!file.open(summary.path.c_str())) {
+        summary.error = "failed to open file";
+        return;
+    }
+    summary.fileSize = file.getSize();
+
+    VKSCPipelineCacheHeaderReader pcr(file.getSize(), file.getData());
+    if (!pcr.isValid()) {
+        summary.error = "not a valid VK_PIPELINE_CACHE_HEADER_VERSION_SAFETY_CRITICAL_ONE cache";
+        return;
+    }
+
+    VKSCPipelineIndexRange const pipelines = pcr.pipelines();
+    if (pipelines.size() != pcr.getPipelineIndexCount()) {
+        summary.error = "malformed pipeline cache";
+        return;
+    }
+
+    summary.pipelineCount = pipelines.size();
+    for (VkPipelineCacheSafetyCriticalIndexEntry const &pie : pipelines) {
+        summary.stageCount += pie.stageIndexCount;
+        summary.minMemorySize = std::min(summary.minMemorySize, pie.pipelineMemorySize);
+        summary.maxMemorySize = std::max(summary.maxMemorySize, pie.pipelineMemorySize);
+        summary.totalMemorySize += pie.pipelineMemorySize;
+        summary.totalJsonSize += pie.jsonSize;
+        for (VkPipelineCacheStageValidationIndexEntry const &vie : pcr.stages(pie)) {
+            summary.totalCodeSize += vie.codeSize;
+        }
+    }
+
+    if (pools.empty()) return;
+
+    summary.pools = pools;
+    bucketPipelines(pcr, summary.pools, &summary.unfitCount);
+    // only the pool statistics are reported, release the entry lists
+    for (PipelinePool &pool : summary.pools) {
+        summary.poolEntryCounts.push_back(pool.poolEntries.size());
+        pool.poolEntries = std::vector<uint32_t>();
+    }
+}
+
+// combine the statistics of <file> into <total>
+void accumulateSummary(CacheFileSummary &total, CacheFileSummary const &file) {
+    total.fileSize += file.fileSize;
+    total.pipelineCount += file.pipelineCount;
+    total.stageCount += file.stageCount;
+    total.minMemorySize = std::min(total.minMemorySize, file.minMemorySize);
+    total.maxMemorySize = std::max(total.maxMemorySize, file.maxMemorySize);
+    total.totalMemorySize += file.totalMemorySize;
+    total.totalJsonSize += file.totalJsonSize;
+    total.totalCodeSize += file.totalCodeSize;
+    total.unfitCount += file.unfitCount;
+    for (size_t p = 0; p < total.pools.size(); ++p) {
+        PipelinePool &pool = total.pools[p];
+        PipelinePool const &filePool = file.pools[p];
+        pool.poolMin = std::min(pool.poolMin, filePool.poolMin);
+        pool.poolMax = std::max(pool.poolMax, filePool.poolMax);
+        pool.poolTotal += filePool.poolTotal;
+        total.poolEntryCounts[p] += file.poolEntryCounts[p];
+    }
+}
+
+// expand directories in <inputs> to the regular files they contain, in a stable order
+bool collectCacheFiles(std::vector<std::string> const &inputs, std::vector<std::string> &files) {
+    for (std::string const &input : inputs) {
+        std::error_code error;
+        if (!std::filesystem::is_directory(input, error)) {
+            files.push_back(input);
+            continue;
+        }
+
+        std::vector<std::string> directoryFiles;
+        for (auto it = std::filesystem::recursive_directory_iterator(input, error);
+             !error && it != std::filesystem::recursive_directory_iterator(); it.increment(error)) {
+            if (it->is_regular_file(error)) {
+                directoryFiles.push_back(it->path().string());
+            }
+        }
+        if (error) {
+            cerr << "error: failed to list " << input << ": " << error.message() << endl;
+            return false;
+        }
+        std::sort(directoryFiles.begin(), directoryFiles.end());
+        files.insert(files.end(), directoryFiles.begin(), directoryFiles.end());
+    }
+    return true;
+}
+
+void writeBatchPools(OutputBuffer &out, CacheFileSummary const &summary, OutputFormat format, char const *indent) {
+    if (format == OUTPUT_FORMAT_JSON) {
+        out << ", \"pools\": [";
+        for (size_t p = 0; p < summary.pools.size(); ++p) {
+            PipelinePool const &pool = summary.pools[p];
+            uint64_t const entryCount = summary.poolEntryCounts[p];
+            out << (p > 0 ? ", " : "") << "{\"poolSize\": " << pool.poolSize << ", \"poolEntryCount\": " << entryCount
+                << ", \"allocatedSpace\": " << (pool.poolSize * entryCount)
+                << ", \"wastedSpace\": " << (pool.poolSize * entryCount - pool.poolTotal) << "}";
+        }
+        out << "]";
+    } else {
+        for (size_t p = 0; p < summary.pools.size(); ++p) {
+            PipelinePool const &pool = summary.pools[p];
+            uint64_t const entryCount = summary.poolEntryCounts[p];
+            out << indent << "pool size: " << pool.poolSize << ", pool entries: " << entryCount
+                << ", pool allocated space: " << (pool.poolSize * entryCount)
+                << ", pool wasted space: " << (pool.poolSize * entryCount - pool.poolTotal) << "\n";
+        }
+    }
+}
+
+void writeBatchSummary(OutputBuffer &out, CacheFileSummary const &summary, OutputFormat format, char const *indent) {
+    uint64_t const minMemorySize = summary.pipelineCount > 0 ? summary.minMemorySize : 0;
+    if (format == OUTPUT_FORMAT_JSON) {
+        out << "\"fileSize\": " << summary.fileSize << ", \"pipelineCount\": " << summary.pipelineCount
+            << ", \"stageCount\": " << summary.stageCount << ", \"minPipelineMemorySize\": " << minMemorySize
+            << ", \"maxPipelineMemorySize\": " << summary.maxMemorySize
+            << ", \"totalPipelineMemorySize\": " << summary.totalMemorySize << ", \"totalJsonSize\": " << summary.totalJsonSize
+            << ", \"totalCodeSize\": " << summary.totalCodeSize;
+        if (!summary.pools.empty()) {
+            out << ", \"unfitCount\": " << summary.unfitCount;
+            writeBatchPools(out, summary, format, indent);
+        }
+    } else if (format == OUTPUT_FORMAT_CSV) {
+        uint64_t allocated = 0;
+        uint64_t wasted = 0;
+        for (size_t p = 0; p < summary.pools.size(); ++p) {
+            allocated += summary.pools[p].poolSize * summary.poolEntryCounts[p];
+            wasted += summary.pools[p].poolSize * summary.poolEntryCounts[p] - summary.pools[p].poolTotal;
+        }
+        out << summary.fileSize << "," << summary.pipelineCount << "," << summary.stageCount << "," << minMemorySize << ","
+            << summary.maxMemorySize << "," << summary.totalMemorySize << "," << summary.totalJsonSize << ","
+            << summary.totalCodeSize << "," << summary.unfitCount << "," << allocated << "," << wasted;
+    } else {
+        out << summary.pipelineCount << " pipelines, sizes [" << minMemorySize << ", " << summary.maxMemorySize
+            << "], pipeline memory: " << summary.totalMemorySize << ", json: " << summary.totalJsonSize
+            << ", code: " << summary.totalCodeSize << "\n";
+        if (summary.unfitCount > 0) {
+            out << indent << "WARNING: " << summary.unfitCount << " pipelines did not fit in any pool!\n";
+        }
+        writeBatchPools(out, summary, format, indent);
+    }
+}
+
+// analyze all <files> using <threadCount> worker threads and report the per-file and combined statistics
+// return: true if all files were analyzed successfully
+bool analyzeCacheFiles(std::vector<std::string> const &files, std::vector<PipelinePool> const &pools, uint32_t threadCount,
+                       OutputFormat format) {
+    std::vector<CacheFileSummary> summaries(files.size());
+    for (size_t i = 0; i < files.size(); ++i) {
+        summaries[i].path = files[i];
+    }
+
+    // the files are handed out one at a time so that workers stay busy regardless of the size distribution
+    std::atomic<size_t> nextFile{0};
+    auto worker = [&]() {
+        for (size_t i = nextFile++; i < summaries.size(); i = nextFile++) {
+            analyzeCacheFile(summaries[i], pools);
+        }
+    };
+    threadCount = static_cast<uint32_t>(std::min<size_t>(std::max(threadCount, 1U), summaries.size()));
+    std::vector<std::thread> threads;
+    threads.reserve(threadCount > 0 ? threadCount - 1 : 0);
+    for (uint32_t t = 1; t < threadCount; ++t) {
+        try {
+            threads.emplace_back(worker);
+        } catch (std::system_error const &) {
+            // the threads started so far and the calling thread take over the rest of the files
+            break;
+        }
+    }
+    worker();
+    for (std::thread &thread : threads) {
+        thread.join();
+    }
+
+    CacheFileSummary total;
+    total.pools = pools;
+    total.poolEntryCounts.resize(pools.size());
+    uint32_t failedCount = 0;
+    for (CacheFileSummary const &summary : summaries) {
+        if (summary.error.empty()) {
+            accumulateSummary(total, summary);
+        } else {
+            ++failedCount;
+        }
+    }
+
+    OutputBuffer out;
+    if (format == OUTPUT_FORMAT_JSON) {
+        out << "{\n  \"files\": [";
+        for (size_t i = 0; i < summaries.size(); ++i) {
+            out << (i > 0 ? ",\n    " : "\n    ") << "{\"file\": ";
+            out.appendJsonString(summaries[i].path.c_str());
+            if (summaries[i].error.empty()) {
+                out << ", ";
+                writeBatchSummary(out, summaries[i], format, "");
+            } else {
+                out << ", \"error\": ";
+                out.appendJsonString(summaries[i].error.c_str());
+            }
+            out << "}";
+        }
+        out << (summaries.empty() ? "]" : "\n  ]") << ",\n  \"summary\": {\"fileCount\": " << uint64_t{summaries.size()}
+            << ", \"failedCount\": " << failedCount << ", ";
+        writeBatchSummary(out, total, format, "");
+        out << "}\n}\n";
+    } else if (format == OUTPUT_FORMAT_CSV) {
+        out << "file,error,fileSize,pipelineCount,stageCount,minPipelineMemorySize,maxPipelineMemorySize,"
+               "totalPipelineMemorySize,totalJsonSize,totalCodeSize,unfitCount,allocatedSpace,wastedSpace\n";
+        for (CacheFileSummary const &summary : summaries) {
+            out.appendCsvField(summary.path.c_str());
+            out << ",";
+            out.appendCsvField(summary.error.c_str());
+            out << ",";
+            writeBatchSummary(out, summary, format, "");
+            out << "\n";
+        }
+    } else {
+        out << "analyzing " << uint64_t{files.size()} << " files with " << threadCount << " threads\n";
+        for (CacheFileSummary const &summary : summaries) {
+            out << summary.path << ": ";
+            if (summary.error.empty()) {
+                writeBatchSummary(out, summary, format, "    ");
+            } else {
+                out << "error: " << summary.error << "\n";
+            }
+        }
+        out << "======================================\n";
+        out << "analyzed " << uint64_t{summaries.size()} << " files, " << failedCount << " failed\n";
+        out << "total: ";
+        writeBatchSummary(out, total, format, "    ");
+    }
+
+    return out.write(std::cout) && failedCount == 0;
+}
+
+// compress payloads like the payload compression mode of VKSCPipelineCacheHeaderWriter does, without keeping the frames
+class PayloadCompressor {
+  public:
+    // return: the size in bytes the <size> bytes at <data> would be stored in with payload compression enabled
+    uint64_t getStoredSize(uint8_t const *data, uint64_t size) {
+        if (size > VKSCPayloadCompressor::getMaxPayloadSize() || VKSCPayloadFrame::isFrame(size, data)) {
+            return size;
+        }
+
+        m_Frame.resize(static_cast<size_t>(VKSCPayloadCompressor::getMaxFrameSize(size)));
+        uint64_t const frameSize = m_Compressor.compress(size, data, m_Frame.size(), m_Frame.data());
+        return (frameSize > 0 && frameSize < size) ? frameSize : size;
+    }
+
+  private:
+    VKSCPayloadCompressor m_Compressor;
+    std::vector<uint8_t> m_Frame;
+};
+
+// byte totals of one kind of payload (json or SPIR-V) of a pipeline cache
+struct PayloadStatistics {
+    uint64_t referencedCount{};  // payloads referenced by index entries
+    uint64_t referencedSize{};   // bytes referenced by index entries, shared payloads counted for each reference
+    uint64_t storedCount{};      // payloads stored in the cache, shared payloads counted once
+    uint64_t storedSize{};       // bytes stored in the cache
+    uint64_t compressedSize{};   // size of the stored payloads with payload compression
+    std::unordered_map<uint64_t, uint64_t> offsets{};  // offset and size of each stored payload
+    VKSCPipelineCachePayloadTable contents{};          // distinct payload contents
+
+    void add(uint64_t offset, uint64_t size, uint8_t const *data, PayloadCompressor &compressor) {
+        if (size == 0) return;
+        ++referencedCount;
+        referencedSize += size;
+        if (!offsets.emplace(offset, size).second) return;
+        ++storedCount;
+        storedSize += size;
+        compressedSize += compressor.getStoredSize(data, size);
+        contents.place(size, data, offset);
+    }
+};
+
+// log2 histogram of a set of sizes
+class SizeHistogram {
+  public:
+    void add(uint64_t size) {
+        uint32_t bucket = 0;
+        while (bucket < 64 && (size >> bucket) != 0) {
+            ++bucket;
+        }
+        ++m_Counts[bucket];
+    }
+
+    // print the non-empty range of buckets, bucket <b> holds the sizes in [2^(b-1), 2^b)
+    void print(char const *name) const {
+        std::cout << name << " histogram:" << std::endl;
+        uint32_t first = 0;
+        while (first < 65 && m_Counts[first] == 0) {
+            ++first;
+        }
+        uint32_t last = 64;
+        while (last > first && m_Counts[last] == 0) {
+            --last;
+        }
+        for (uint32_t b = first; b <= last && b < 65; ++b) {
+            if (b == 0) {
+                std::cout << "    0: " << m_Counts[b] << std::endl;
+            } else {
+                uint64_t const lo = uint64_t{1} << (b - 1);
+                std::string const hi = (b < 64) ? std::to_string(lo << 1) : std::string("2^64");
+                std::cout << "    [" << lo << ", " << hi << "): " << m_Counts[b] << std::endl;
+            }
+        }
+    }
+
+  private:
+    uint64_t m_Counts[65]{};
+};
+
+std::string percentage(uint64_t part, uint64_t total) {
+    if (total == 0) return "0.0%";
+    char text[32];
+    snprintf(text, sizeof(text), "%.1f%%", 100.0 * static_cast<double>(part) / static_cast<double>(total));
+    return text;
+}
+
+void printPayloadStatistics(char const *name, PayloadStatistics const &stats) {
+    uint64_t const uniqueSize = stats.contents.getPayloadSize();
+    std::cout << name << " payloads: " << stats.referencedCount << " referenced (" << stats.referencedSize << " bytes), "
+              << stats.storedCount << " stored (" << stats.storedSize << " bytes), " << stats.contents.getPayloadCount()
+              << " distinct (" << uniqueSize << " bytes)" << std::endl;
+    std::cout << "    duplicate stored bytes: " << (stats.storedSize - uniqueSize) << " ("
+              << percentage(stats.storedSize - uniqueSize, stats.storedSize) << " of stored)" << std::endl;
+    std::cout << "    compressed size: " << stats.compressedSize << " (" << percentage(stats.compressedSize, stats.storedSize)
+              << " of stored)" << std::endl;
+}
+
+// print where the bytes of the pipeline cache go, how much of the payload data is duplicated and how well it compresses
+bool printCacheStatistics(VKSCPipelineCacheHeaderReader &pcr, uint64_t fileSize) {
+    // the payloads are read without further checks, so all offsets and sizes must be in range
+    VKSCPipelineIndexRange const pipelines = pcr.pipelines();
+    if (!pcr.verify() || pipelines.size() != pcr.getPipelineIndexCount()) {
+        std::cerr << "malformed pipeline cache!" << std::endl;
+        return false;
+    }
+
+    PayloadCompressor compressor;
+    PayloadStatistics json;
+    PayloadStatistics spirv;
+    SizeHistogram memorySizes;
+    SizeHistogram jsonSizes;
+    SizeHistogram codeSizes;
+    std::unordered_map<uint64_t, uint64_t> stageIndices;
+    uint64_t stageIndexSize = 0;
+
+    for (VkPipelineCacheSafetyCriticalIndexEntry const &pie : pipelines) {
+        memorySizes.add(pie.pipelineMemorySize);
+        jsonSizes.add(pie.jsonSize);
+        json.add(pie.jsonOffset, pie.jsonSize, pcr.getJson(pie), compressor);
+
+        if (pie.stageIndexCount > 0 && stageIndices.emplace(pie.stageIndexOffset, pie.stageIndexCount).second) {
+            stageIndexSize += uint64_t{pie.stageIndexCount} * pie.stageIndexStride;
+        }
+        for (VkPipelineCacheStageValidationIndexEntry const &vie : pcr.stages(pie)) {
+            codeSizes.add(vie.codeSize);
+            spirv.add(vie.codeOffset, vie.codeSize, pcr.getSPIRV(vie), compressor);
+        }
+    }
+
+    uint64_t const headerSize = sizeof(VkPipelineCacheHeaderVersionSafetyCriticalOne);
+    uint64_t const preIndexSize = pcr.getPipelineIndexOffset() - headerSize;
+    uint64_t const pipelineIndexSize = uint64_t{pcr.getPipelineIndexCount()} * pcr.getPipelineIndexStride();
+    uint64_t const vendorIndexSize =
+        uint64_t{pcr.getPipelineIndexCount()} * (pcr.getPipelineIndexStride() - sizeof(VkPipelineCacheSafetyCriticalIndexEntry));
+    uint64_t const accountedSize =
+        headerSize + preIndexSize + pipelineIndexSize + stageIndexSize + json.storedSize + spirv.storedSize;
+    uint64_t const otherSize = fileSize > accountedSize ? fileSize - accountedSize : 0;
+
+    std::cout << "section sizes:" << std::endl
+              << "    header:                  " << headerSize << " (" << percentage(headerSize, fileSize) << ")" << std::endl
+              << "    implementation data:     " << preIndexSize << " (" << percentage(preIndexSize, fileSize) << ")" << std::endl
+              << "    pipeline index:          " << pipelineIndexSize << " (" << percentage(pipelineIndexSize, fileSize)
+              << "), of which implementation-specific: " << vendorIndexSize << std::endl
+              << "    stage indices:           " << stageIndexSize << " (" << percentage(stageIndexSize, fileSize) << ")"
+              << std::endl
+              << "    json:                    " << json.storedSize << " (" << percentage(json.storedSize, fileSize) << ")"
+              << std::endl
+              << "    spirv:                   " << spirv.storedSize << " (" << percentage(spirv.storedSize, fileSize) << ")"
+              << std::endl
+              << "    padding and other data:  " << otherSize << " (" << percentage(otherSize, fileSize) << ")" << std::endl
+              << "    total:                   " << fileSize << std::endl
+              << std::endl;
+
+    printPayloadStatistics("json", json);
+    printPayloadStatistics("spirv", spirv);
+
+    uint64_t const distinctSize = json.contents.getPayloadSize() + spirv.contents.getPayloadSize();
+    uint64_t const payloadSize = json.storedSize + spirv.storedSize;
+    std::cout << "payload deduplication would save " << (payloadSize - distinctSize) << " bytes ("
+              << percentage(payloadSize - distinctSize, fileSize) << " of the cache)" << std::endl;
+    uint64_t const compressedSize = json.compressedSize + spirv.compressedSize;
+    if (compressedSize < payloadSize) {
+        std::cout << "payload compression would save " << (payloadSize - compressedSize) << " bytes ("
+                  << percentage(payloadSize - compressedSize, fileSize) << " of the cache)" << std::endl;
+    } else {
+        std::cout << "payload compression would not reduce the size of the cache" << std::endl;
+    }
+    std::cout << std::endl;
+
+    memorySizes.print("pipelineMemorySize");
+    jsonSizes.print("jsonSize");
+    codeSizes.print("codeSize");
+
+    return true;
+}
+
+// return: true if <string> is a non-empty decimal number
+bool isNumeric(std::string const &string) {
+    if (string.empty()) return false;
+    for (auto c : string) {
+        if (!std::isdigit(static_cast<unsigned char>(c))) return false;
+    }
+    return true;
+}
+
 void printUsageAndExit(char *executable, int exitCode) {
-    std::cerr << "usage: " << executable << " [-h|--help] [-l|-f|-d|-a] [-pool <poolsize>] <pipeline_cache_file>" << std::endl
+    std::cerr << "usage: " << executable << " [-h|--help] [-l|-f|-d|-a|-disasm] [-stats] [-format <json|csv>] [-pool <poolsize>]"
+              << " [-solve <poolcount> [-maxentries <count>]] [-j <threads>] <pipeline_cache_file>..." << std::endl
               << std::endl;
     std::cerr << "  -h | --help: print this usage message" << std::endl << std::endl;
     std::cerr << "  -l: list basic pipeline info (index, identifier, poolSize)" << std::endl << std::endl;
     std::cerr << "  -f: list first header (device info, pipeline index)" << std::endl << std::endl;
     std::cerr << "  -d: list detailed pipeline info (-l, plus all header fields)" << std::endl << std::endl;
     std::cerr << "  -a: list all pipeline info (-d, plus JSON and SPIR-V)" << std::endl << std::endl;
+    std::cerr << "  -disasm: list all pipeline info like -a, with SPIR-V decoded to one instruction per line" << std::endl
+              << std::endl;
+    std::cerr << "  -stats: print section sizes, payload duplication and compression, and size histograms" << endl << endl;
+    std::cerr << "  -format <json|csv>: write header fields, per-pipeline sizes and pool statistics in a machine-readable format"
+              << endl
+              << "      instead of the text output, csv lists one pipeline per row and does not support -solve" << endl
+              << endl;
     std::cerr << "  -pool <poolsize>: add a bucket of size <poolsize>" << endl << endl;
+    std::cerr << "  -solve <poolcount>: compute the pool sizes using at most <poolcount> pools that minimize the reserved memory"
+              << endl
+              << endl;
+    std::cerr << "  -maxentries <count>: limit the number of entries of each pool computed by -solve to <count>" << endl << endl;
+    std::cerr << "  -j <threads>: number of files to analyze concurrently in batch mode (default: number of CPU cores)" << endl
+              << endl;
     std::cerr << "  <pipeline_cache_file>: the pipeline cache file to parse (generated by PCC tool)" << std::endl << std::endl;
+    std::cerr << "When multiple files or a directory are given, each file is summarized (including -pool statistics) followed"
+              << std::endl
+              << "by the combined statistics of all files, -l, -f, -d, -a, -disasm, -stats and -solve are not" << std::endl
+              << "supported in this mode." << std::endl
+              << std::endl;
 
     exit(exitCode);
 }
 
 int main(int argc, char **argv) {
-    ifstream file_cache;
+    VKSCPipelineCacheFile file_cache;
     char *cache_filename{nullptr};
+    std::vector<std::string> inputs{};
+    uint32_t threadCount{std::thread::hardware_concurrency()};
     int const lastArg{argc};
     DetailMode listMode{DETAIL_MODE_NONE};
     std::vector<PipelinePool> pools{};
+    uint32_t solvePoolCount{0};
+    uint64_t solveMaxEntries{0};
+    OutputFormat outputFormat{OUTPUT_FORMAT_TEXT};
+    bool disassemble{false};
+    bool statistics{false};
 
     if (argc < 2) {
         printUsageAndExit(argv[0], EXIT_FAILURE);
@@ -250,6 +1290,11 @@ int main(int argc, char **argv) {
             listMode = DETAIL_MODE_ALL_HEADERS;
         } else if (strcmp(argv[i], "-a") == 0) {
             listMode = DETAIL_MODE_ALL;
+        } else if (strcmp(argv[i], "-disasm") == 0) {
+            listMode = DETAIL_MODE_ALL;
+            disassemble = true;
+        } else if (strcmp(argv[i], "-stats") == 0) {
+            statistics = true;
         } else if (strcmp(argv[i], "-pool") == 0) {
             if (++i >= lastArg) {
                 cout << "missing parameter <poolsize>" << endl << endl;
@@ -257,23 +1302,64 @@ int main(int argc, char **argv) {
             }
 
             std::string sizeString(argv[i]);
-            bool isNumber = true;
-            for (auto c : sizeString) {
-                if (!std::isdigit(c)) isNumber = false;
-            }
-            if (!isNumber) {
+            if (!isNumeric(sizeString)) {
                 cout << "parameter <poolsize> must be numeric, found " << sizeString << endl << endl;
                 printUsageAndExit(argv[0], EXIT_FAILURE);
             }
 
             uint64_t size = stoul(sizeString);
-            cout << "adding pool of size " << size << endl;
             PipelinePool poolToAdd(size);
             pools.push_back(poolToAdd);
+        } else if (strcmp(argv[i], "-solve") == 0 || strcmp(argv[i], "-maxentries") == 0) {
+            bool const solve = strcmp(argv[i], "-solve") == 0;
+            char const *parameter = solve ? "<poolcount>" : "<count>";
+            if (++i >= lastArg) {
+                cout << "missing parameter " << parameter << endl << endl;
+                printUsageAndExit(argv[0], EXIT_FAILURE);
+            }
+
+            std::string countString(argv[i]);
+            if (!isNumeric(countString) || (solve && stoul(countString) == 0)) {
+                cout << "parameter " << parameter << " must be a positive number, found " << countString << endl << endl;
+                printUsageAndExit(argv[0], EXIT_FAILURE);
+            }
+
+            if (solve) {
+                solvePoolCount = static_cast<uint32_t>(std::min<uint64_t>(stoull(countString), UINT32_MAX));
+            } else {
+                solveMaxEntries = stoull(countString);
+            }
+        } else if (strcmp(argv[i], "-format") == 0) {
+            if (++i >= lastArg) {
+                cout << "missing parameter <json|csv>" << endl << endl;
+                printUsageAndExit(argv[0], EXIT_FAILURE);
+            }
+
+            if (strcmp(argv[i], "json") == 0) {
+                outputFormat = OUTPUT_FORMAT_JSON;
+            } else if (strcmp(argv[i], "csv") == 0) {
+                outputFormat = OUTPUT_FORMAT_CSV;
+            } else {
+                cout << "parameter <json|csv> must be json or csv, found " << argv[i] << endl << endl;
+                printUsageAndExit(argv[0], EXIT_FAILURE);
+            }
         } else if (strcmp(argv[i], "-h") == 0 || strcmp(argv[i], "--help") == 0) {
             printUsageAndExit(argv[0], EXIT_SUCCESS);
+        } else if (strcmp(argv[i], "-j") == 0) {
+            if (++i >= lastArg) {
+                cout << "missing parameter <threads>" << endl << endl;
+                printUsageAndExit(argv[0], EXIT_FAILURE);
+            }
+
+            std::string countString(argv[i]);
+            if (!isNumeric(countString) || stoul(countString) == 0) {
+                cout << "parameter <threads> must be a positive number, found " << countString << endl << endl;
+                printUsageAndExit(argv[0], EXIT_FAILURE);
+            }
+            threadCount = static_cast<uint32_t>(std::min<uint64_t>(stoull(countString), UINT32_MAX));
         } else if (argv[i][0] != '-') {
             cache_filename = argv[i];
+            inputs.push_back(argv[i]);
         } else {
             cerr << "unrecognized argument: " << argv[i] << endl << endl;
             printUsageAndExit(argv[0], EXIT_FAILURE);
@@ -285,23 +1371,52 @@ int main(int argc, char **argv) {
         printUsageAndExit(argv[0], EXIT_FAILURE);
     }
 
-    std::cout << "parsing file: " << cache_filename << std::endl;
-    file_cache.open(cache_filename, ios::in | ios::binary | ios::ate);
-    if (!file_cache.is_open()) {
+    if (outputFormat == OUTPUT_FORMAT_CSV && solvePoolCount > 0) {
+        cerr << "-solve is not supported with -format csv" << endl << endl;
+        printUsageAndExit(argv[0], EXIT_FAILURE);
+    }
+
+    std::error_code error;
+    if (inputs.size() > 1 || std::filesystem::is_directory(cache_filename, error)) {
+        if (listMode != DETAIL_MODE_NONE || solvePoolCount > 0 || statistics) {
+            cerr << "-l, -f, -d, -a, -disasm, -stats and -solve require a single <pipeline_cache_file>" << endl << endl;
+            printUsageAndExit(argv[0], EXIT_FAILURE);
+        }
+
+        std::vector<std::string> files;
+        if (!collectCacheFiles(inputs, files)) {
+            return EXIT_FAILURE;
+        }
+
+        std::sort(pools.begin(), pools.end(), [](PipelinePool &a, PipelinePool &b) { return (a.poolSize < b.poolSize); });
+        return analyzeCacheFiles(files, pools, threadCount, outputFormat) ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+
+    // the structured formats only write their own output to stdout
+    bool const textOutput = outputFormat == OUTPUT_FORMAT_TEXT;
+
+    if (textOutput) {
+        for (auto const &pool : pools) {
+            cout << "adding pool of size " << pool.poolSize << endl;
+        }
+        std::cout << "parsing file: " << cache_filename << std::endl;
+    }
+    if (!file_cache.open(cache_filename)) {
         std::cerr << "error: failed to open " << cache_filename << std::endl;
         return EXIT_FAILURE;
     }
 
-    streampos size = file_cache.tellg();
-
-    std::vector<uint8_t> mem_cache(static_cast<size_t>(size));
-    file_cache.seekg(0, ios::beg);
-    file_cache.read(reinterpret_cast<char *>(mem_cache.data()), static_cast<streamsize>(mem_cache.size()));
-    file_cache.close();
+    // the reader operates directly on the mapped file, so only the inspected parts of the cache are loaded
+    if (textOutput) {
+        std::cout << (file_cache.isMapped() ? "mapped " : "read ") << file_cache.getSize() << " bytes from file" << std::endl;
+    }
 
-    std::cout << "read " << size << " bytes from file" << std::endl;
+    if (file_cache.getSize() < sizeof(VkPipelineCacheHeaderVersionSafetyCriticalOne)) {
+        std::cerr << "Requested file is too small to be a pipeline cache. Aborting!" << std::endl;
+        return EXIT_FAILURE;
+    }
 
-    VKSCPipelineCacheHeaderReader pcr(mem_cache.size(), mem_cache.data());
+    VKSCPipelineCacheHeaderReader pcr(file_cache.getSize(), file_cache.getData());
     if (!pcr.isValid()) {
         std::cerr << "Requested file is not a valid VK_PIPELINE_CACHE_HEADER_VERSION_SAFETY_CRITICAL_ONE "
                      "cache. Aborting!"
@@ -309,8 +1424,34 @@ int main(int argc, char **argv) {
         return EXIT_FAILURE;
     }
 
+    if (!textOutput) {
+        std::sort(pools.begin(), pools.end(), [](PipelinePool &a, PipelinePool &b) { return (a.poolSize < b.poolSize); });
+        uint32_t unfitCount = 0;
+        if (!pools.empty()) {
+            bucketPipelines(pcr, pools, &unfitCount);
+        }
+
+        std::vector<VkPipelinePoolSize> solvedPools;
+        if (solvePoolCount > 0) {
+            PipelinePoolSolver solver(getPipelineMemorySizes(pcr), solveMaxEntries);
+            if (!solver.solve(solvePoolCount, solvedPools)) {
+                cerr << "WARNING: " << pcr.getPipelineIndexCount() << " pipelines do not fit in " << solvePoolCount
+                     << " pools of at most " << solveMaxEntries << " entries!" << endl;
+                return EXIT_FAILURE;
+            }
+        }
+
+        bool const written = writeStructuredCacheInfo(pcr, cache_filename, file_cache.getSize(), outputFormat, pools, unfitCount,
+                                                      solvePoolCount > 0 ? &solvedPools : nullptr);
+        return written ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+
     if (listMode >= DETAIL_MODE_BASIC) {
-        printCacheInfo(pcr, listMode);
+        printCacheInfo(pcr, listMode, disassemble);
+    }
+
+    if (statistics && !printCacheStatistics(pcr, file_cache.getSize())) {
+        return EXIT_FAILURE;
     }
 
     if (pools.size() > 0) {
@@ -341,5 +1482,11 @@ int main(int argc, char **argv) {
         }
     }
 
+    if (solvePoolCount > 0) {
+        if (!solvePipelinePools(pcr, solvePoolCount, solveMaxEntries)) {
+            return EXIT_FAILURE;
+        }
+    }
+
     return EXIT_SUCCESS;
 }
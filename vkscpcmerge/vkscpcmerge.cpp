@@ -0,0 +1,330 @@
+/*
+ * Copyright (c) 2025 The Khronos Group Inc.
+ * Copyright (c) 2025 RasterGrid Kft.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <cctype>
+#include <cstddef>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include <vulkan/pcutil/pcfile.hpp>
+#include <vulkan/pcutil/pcreader.hpp>
+#include <vulkan/pcutil/pcwriter.hpp>
+#include <vulkan/vulkan_sc.h>
+
+// Merges pipeline cache files into one, or selects a subset of the pipelines of pipeline cache files.
+//
+// The input files are memory-mapped and the output is written sequentially through a file sink, the JSON
+// and SPIR-V payloads are copied from the mappings to the output without being parsed or held in memory.
+// Only a small per-pipeline record is kept for the pipeline index, so caches larger than the available
+// memory can be processed.
+
+namespace {
+
+std::ostream &operator<<(std::ostream &out, uint8_t const uuid[VK_UUID_SIZE]) {
+    out << "0x" << std::uppercase << std::hex;
+    for (uint32_t i = 0; i < VK_UUID_SIZE; ++i) {
+        out << std::setfill('0') << std::setw(2) << static_cast<unsigned int>(uuid[i]);
+    }
+    out << std::dec << std::setfill(' ');
+    return out;
+}
+
+std::string identifierKey(uint8_t const identifier[VK_UUID_SIZE]) {
+    return std::string(reinterpret_cast<char const *>(identifier), VK_UUID_SIZE);
+}
+
+// parse a pipeline identifier written as 32 hexadecimal digits, optionally prefixed with 0x (as printed by vkscpcinfo)
+bool parseIdentifier(std::string text, uint8_t identifier[VK_UUID_SIZE]) {
+    if (text.size() > 2 && text[0] == '0' && (text[1] == 'x' || text[1] == 'X')) {
+        text = text.substr(2);
+    }
+    if (text.size() != 2 * VK_UUID_SIZE) {
+        return false;
+    }
+    for (uint32_t i = 0; i < VK_UUID_SIZE; ++i) {
+        std::string const byte = text.substr(2 * i, 2);
+        if (!std::isxdigit(static_cast<unsigned char>(byte[0])) || !std::isxdigit(static_cast<unsigned char>(byte[1]))) {
+            return false;
+        }
+        identifier[i] = static_cast<uint8_t>(std::stoul(byte, nullptr, 16));
+    }
+    return true;
+}
+
+// read pipeline identifiers from <path>, one per line, empty lines and lines starting with # are ignored
+bool readIdentifierList(char const *path, std::unordered_set<std::string> &identifiers) {
+    std::ifstream file(path);
+    if (!file) {
+        std::cerr << "error: failed to open " << path << std::endl;
+        return false;
+    }
+
+    std::string line;
+    uint32_t lineNumber = 0;
+    while (std::getline(file, line)) {
+        ++lineNumber;
+        size_t const begin = line.find_first_not_of(" \t\r");
+        if (begin == std::string::npos || line[begin] == '#') {
+            continue;
+        }
+        size_t const end = line.find_last_not_of(" \t\r");
+
+        uint8_t identifier[VK_UUID_SIZE];
+        if (!parseIdentifier(line.substr(begin, end - begin + 1), identifier)) {
+            std::cerr << "error: " << path << ":" << lineNumber << ": invalid pipeline identifier" << std::endl;
+            return false;
+        }
+        identifiers.insert(identifierKey(identifier));
+    }
+    return true;
+}
+
+// return: true if the two pipelines have identical contents
+bool isSamePipeline(VKSCPipelineCacheHeaderReader const &pcrA, VkPipelineCacheSafetyCriticalIndexEntry const &pieA,
+                    VKSCPipelineCacheHeaderReader const &pcrB, VkPipelineCacheSafetyCriticalIndexEntry const &pieB) {
+    if (pieA.pipelineMemorySize != pieB.pipelineMemorySize || pieA.jsonSize != pieB.jsonSize ||
+        pieA.stageIndexCount != pieB.stageIndexCount) {
+        return false;
+    }
+    if (pieA.jsonSize > 0 && memcmp(pcrA.getJson(pieA), pcrB.getJson(pieB), static_cast<size_t>(pieA.jsonSize)) != 0) {
+        return false;
+    }
+
+    VKSCStageIndexRange const stagesA = pcrA.stages(pieA);
+    VKSCStageIndexRange const stagesB = pcrB.stages(pieB);
+    for (uint32_t i = 0; i < stagesA.size(); ++i) {
+        if (stagesA[i].codeSize != stagesB[i].codeSize ||
+            (stagesA[i].codeSize > 0 &&
+             memcmp(pcrA.getSPIRV(stagesA[i]), pcrB.getSPIRV(stagesB[i]), static_cast<size_t>(stagesA[i].codeSize)) != 0)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+struct InputCache {
+    char const *path{nullptr};
+    VKSCPipelineCacheFile file;
+    std::unique_ptr<VKSCPipelineCacheHeaderReader> reader;
+};
+
+void printUsageAndExit(char *executable, int exitCode) {
+    std::cerr << "usage: " << executable
+              << " [-h|--help] [-include <id_list_file>] [-exclude <id_list_file>] [-dedup] -o <output_file>"
+                 " <pipeline_cache_file>..."
+              << std::endl
+              << std::endl;
+    std::cerr << "  -h | --help: print this usage message" << std::endl << std::endl;
+    std::cerr << "  -o <output_file>: the pipeline cache file to write" << std::endl << std::endl;
+    std::cerr << "  -include <id_list_file>: only keep the pipelines whose identifier is listed in <id_list_file>" << std::endl
+              << std::endl;
+    std::cerr << "  -exclude <id_list_file>: drop the pipelines whose identifier is listed in <id_list_file>" << std::endl
+              << std::endl;
+    std::cerr << "  -dedup: store identical JSON and SPIR-V payloads only once" << std::endl << std::endl;
+    std::cerr << "  <pipeline_cache_file>...: the pipeline cache files to merge, in order of precedence" << std::endl << std::endl;
+    std::cerr << "Pipelines are identified by their pipelineIdentifier, only the first occurrence of each identifier is kept."
+              << std::endl
+              << "All input files must have the same vendorID, deviceID and pipelineCacheUUID." << std::endl
+              << "Identifier list files contain one identifier per line, in the format printed by vkscpcinfo -l." << std::endl
+              << "Splitting a pipeline cache file is done by running with -include and -exclude on the same list." << std::endl
+              << "The output file must not be one of the input files." << std::endl;
+
+    exit(exitCode);
+}
+
+}  // namespace
+
+int main(int argc, char **argv) {
+    char const *outputFilename{nullptr};
+    std::vector<std::unique_ptr<InputCache>> inputs;
+    std::unordered_set<std::string> includeList;
+    std::unordered_set<std::string> excludeList;
+    bool filterIncluded{false};
+    bool deduplicate{false};
+
+    if (argc < 2) {
+        printUsageAndExit(argv[0], EXIT_FAILURE);
+    }
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-o") == 0) {
+            if (++i >= argc) {
+                std::cerr << "missing parameter <output_file>" << std::endl << std::endl;
+                printUsageAndExit(argv[0], EXIT_FAILURE);
+            }
+            outputFilename = argv[i];
+        } else if (strcmp(argv[i], "-include") == 0 || strcmp(argv[i], "-exclude") == 0) {
+            bool const include = strcmp(argv[i], "-include") == 0;
+            if (++i >= argc) {
+                std::cerr << "missing parameter <id_list_file>" << std::endl << std::endl;
+                printUsageAndExit(argv[0], EXIT_FAILURE);
+            }
+            if (!readIdentifierList(argv[i], include ? includeList : excludeList)) {
+                return EXIT_FAILURE;
+            }
+            filterIncluded |= include;
+        } else if (strcmp(argv[i], "-dedup") == 0) {
+            deduplicate = true;
+        } else if (strcmp(argv[i], "-h") == 0 || strcmp(argv[i], "--help") == 0) {
+            printUsageAndExit(argv[0], EXIT_SUCCESS);
+        } else if (argv[i][0] != '-') {
+            inputs.push_back(std::make_unique<InputCache>());
+            inputs.back()->path = argv[i];
+        } else {
+            std::cerr << "unrecognized argument: " << argv[i] << std::endl << std::endl;
+            printUsageAndExit(argv[0], EXIT_FAILURE);
+        }
+    }
+
+    if (outputFilename == nullptr) {
+        std::cerr << "missing parameter <output_file>" << std::endl << std::endl;
+        printUsageAndExit(argv[0], EXIT_FAILURE);
+    }
+    if (inputs.empty()) {
+        std::cerr << "missing parameter <pipeline_cache_file>" << std::endl << std::endl;
+        printUsageAndExit(argv[0], EXIT_FAILURE);
+    }
+
+    // the inputs are read through their mappings while the output is written, writing over one of them would
+    // truncate it under the mapping and destroy it
+    for (auto const &input : inputs) {
+        std::error_code error;
+        if (std::filesystem::equivalent(outputFilename, input->path, error)) {
+            std::cerr << "error: output file " << outputFilename << " is the same file as input " << input->path << std::endl;
+            return EXIT_FAILURE;
+        }
+    }
+
+    // open and check all inputs before writing anything
+    for (auto &input : inputs) {
+        if (!input->file.open(input->path)) {
+            std::cerr << "error: failed to open " << input->path << std::endl;
+            return EXIT_FAILURE;
+        }
+
+        input->reader = std::make_unique<VKSCPipelineCacheHeaderReader>(input->file.getSize(), input->file.getData());
+        if (!input->reader->isValid() || !input->reader->verify()) {
+            std::cerr << "error: " << input->path << " is not a valid VK_PIPELINE_CACHE_HEADER_VERSION_SAFETY_CRITICAL_ONE cache"
+                      << std::endl;
+            return EXIT_FAILURE;
+        }
+
+        VkPipelineCacheHeaderVersionOne const *first = inputs.front()->reader->getHeaderVersionOne();
+        VkPipelineCacheHeaderVersionOne const *hv1 = input->reader->getHeaderVersionOne();
+        if (hv1->vendorID != first->vendorID || hv1->deviceID != first->deviceID ||
+            memcmp(hv1->pipelineCacheUUID, first->pipelineCacheUUID, VK_UUID_SIZE) != 0) {
+            std::cerr << "error: " << input->path << " was created for a different device than " << inputs.front()->path
+                      << " (vendorID 0x" << std::hex << hv1->vendorID << "/0x" << first->vendorID << ", deviceID 0x"
+                      << hv1->deviceID << "/0x" << first->deviceID << std::dec << ", pipelineCacheUUID " << hv1->pipelineCacheUUID
+                      << "/" << first->pipelineCacheUUID << ")" << std::endl;
+            return EXIT_FAILURE;
+        }
+        if (input->reader->getImplementationData() != inputs.front()->reader->getImplementationData()) {
+            std::cerr << "warning: " << input->path << " has different implementationData than " << inputs.front()->path
+                      << ", keeping " << inputs.front()->reader->getImplementationData() << std::endl;
+        }
+    }
+
+    VkPipelineCacheHeaderVersionOne const *hv1 = inputs.front()->reader->getHeaderVersionOne();
+    VKSCPipelineCacheHeaderWriter pcw(hv1->vendorID, hv1->deviceID, hv1->pipelineCacheUUID);
+    pcw.setImplementationData(inputs.front()->reader->getImplementationData());
+    pcw.setDeduplicatePayloads(deduplicate);
+
+    uint64_t totalPipelineCount = 0;
+    uint64_t totalStageCount = 0;
+    for (auto const &input : inputs) {
+        totalPipelineCount += input->reader->getPipelineIndexCount();
+        for (VkPipelineCacheSafetyCriticalIndexEntry const &pie : input->reader->pipelines()) {
+            totalStageCount += pie.stageIndexCount;
+        }
+    }
+    if (totalPipelineCount > std::numeric_limits<uint32_t>::max()) {
+        std::cerr << "error: too many pipelines" << std::endl;
+        return EXIT_FAILURE;
+    }
+    pcw.reservePipelineEntries(static_cast<uint32_t>(totalPipelineCount), totalStageCount);
+
+    // first occurrence of each pipeline identifier, to detect duplicates and compare their contents
+    struct Occurrence {
+        InputCache const *input;
+        VkPipelineCacheSafetyCriticalIndexEntry const *pie;
+    };
+    std::unordered_map<std::string, Occurrence> occurrences;
+    occurrences.reserve(static_cast<size_t>(totalPipelineCount));
+    uint32_t duplicateCount = 0;
+    uint32_t filteredCount = 0;
+    bool metadataDropped = false;
+
+    for (auto const &input : inputs) {
+        VKSCPipelineCacheHeaderReader const &pcr = *input->reader;
+        metadataDropped |= pcr.getPipelineIndexStride() > sizeof(VkPipelineCacheSafetyCriticalIndexEntry) ||
+                           pcr.getPipelineIndexOffset() > sizeof(VkPipelineCacheHeaderVersionSafetyCriticalOne);
+
+        for (VkPipelineCacheSafetyCriticalIndexEntry const &pie : pcr.pipelines()) {
+            std::string const key = identifierKey(pie.pipelineIdentifier);
+            if ((filterIncluded && includeList.count(key) == 0) || excludeList.count(key) != 0) {
+                ++filteredCount;
+                continue;
+            }
+
+            auto const inserted = occurrences.emplace(key, Occurrence{input.get(), &pie});
+            if (!inserted.second) {
+                ++duplicateCount;
+                Occurrence const &occurrence = inserted.first->second;
+                if (!isSamePipeline(*occurrence.input->reader, *occurrence.pie, pcr, pie)) {
+                    std::cerr << "warning: pipeline " << pie.pipelineIdentifier << " in " << input->path
+                              << " differs from the one in " << occurrence.input->path << ", keeping the latter" << std::endl;
+                }
+                continue;
+            }
+
+            metadataDropped |= pie.stageIndexCount > 0 && pie.stageIndexStride > sizeof(VkPipelineCacheStageValidationIndexEntry);
+
+            VKSCPipelineEntry *entry =
+                pcw.emplacePipelineEntry(pie.pipelineIdentifier, pie.pipelineMemorySize, pie.stageIndexCount);
+            entry->setJsonCode(pie.jsonSize, pcr.getJson(pie));
+            uint32_t j = 0;
+            for (VkPipelineCacheStageValidationIndexEntry const &sie : pcr.stages(pie)) {
+                entry->setShaderStageCode(j++, sie.codeSize, pcr.getSPIRV(sie));
+            }
+        }
+    }
+
+    if (metadataDropped) {
+        std::cerr << "warning: implementation-specific data in the input pipeline caches is not carried over" << std::endl;
+    }
+
+    VKSCPipelineCacheFileSink sink;
+    if (!sink.open(outputFilename)) {
+        std::cerr << "error: failed to create " << outputFilename << std::endl;
+        return EXIT_FAILURE;
+    }
+    bool const written = pcw.writePipelineCache(sink);
+    if (!sink.close() || !written) {
+        std::cerr << "error: failed to write " << outputFilename << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    std::cout << "wrote " << pcw.getPipelineEntryCount() << " pipelines (" << pcw.getPipelineCacheSize() << " bytes) to "
+              << outputFilename << ", skipped " << duplicateCount << " duplicate and " << filteredCount << " filtered pipelines"
+              << std::endl;
+    if (deduplicate) {
+        std::cout << "payload deduplication saved " << pcw.getDeduplicationSavings() << " bytes" << std::endl;
+    }
+
+    return EXIT_SUCCESS;
+}